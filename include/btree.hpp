@@ -0,0 +1,1108 @@
+#ifndef BTREE_HPP
+# define BTREE_HPP
+
+# include "ft_common.hpp"
+# include "ft_meta_functions.hpp"
+# include "ft_iterator.hpp"
+# include "ft_algorithm.hpp"
+# include "pair.hpp"
+# include "tree.hpp"
+# include <memory>
+# include <new>
+# include <cstddef>
+# include <limits>
+# include <iterator>
+
+namespace ft {
+
+    // [btree_node_slots]
+    // ノード1個がおよそ TargetNodeSize バイトになるように, ノードに載せる値の数を決める。
+    // (ノードのヘッダは親へのポインタと位置・個数で, ポインタ2個分とみなす)
+    // 少なくとも3個は載せる。
+    template <class Value, std::size_t TargetNodeSize>
+    struct btree_node_slots {
+        static const std::size_t    header_size = 2 * sizeof(void*);
+        static const std::size_t    fit = TargetNodeSize > header_size
+            ? (TargetNodeSize - header_size) / sizeof(Value) : 0;
+        static const std::size_t    value = fit < 3 ? 3 : (fit > 4096 ? 4096 : fit);
+    };
+
+    // btree (B-Tree)
+    // 各ノードが複数の値をソート済みの配列として持つ探索木。
+    // 赤黒木(tree)と比べて
+    // - 1ノードに多くの値が載るので木が低く, 探索で触るキャッシュラインが少ない。
+    // - 値ごとのポインタがないので, 要素あたりのメモリが小さい。
+    // - 挿入・削除で値がノード内・ノード間を移動するので,
+    //   挿入・削除はすべてのイテレータ・参照・ポインタを無効にする。
+    // - 値の移動はコピーコンストラクタ+デストラクタで行う。
+    //   値のコピーコンストラクタが例外を投げないことを前提とする。
+    //   (新しく挿入する値の構築が例外を投げた場合は, 木は変化しない)
+    // キーの重複は許さない(map, set 用)。
+    template <
+        // ノードに載る値の型
+        // - btree_map<MK, MV, MKC, MA>   -> pair<const MK, MV>
+        // - btree_set<SK, SKC, SA>       -> SK
+        class Value,
+        // Valueのコンパレータ(tree と同じ)
+        class ValueComparator = std::less<Value>,
+        // Valueのアロケータ
+        class ValueAllocator = std::allocator<Value>,
+        // ノード1個の目標バイト数
+        std::size_t TargetNodeSize = 256
+    >
+    class btree {
+        public:
+            typedef Value                                               value_type;
+            typedef ValueComparator                                     value_comparator_type;
+            typedef ValueAllocator                                      value_allocator_type;
+            typedef btree<Value, ValueComparator, ValueAllocator, TargetNodeSize>
+                                                                        self_type;
+            typedef value_type&                                         reference;
+            typedef const value_type&                                   const_reference;
+            typedef typename value_allocator_type::size_type            size_type;
+            typedef typename value_allocator_type::difference_type      difference_type;
+
+            // ノードに載る値の最大数
+            static const size_type  node_slots = btree_node_slots<Value, TargetNodeSize>::value;
+            // 根以外のノードが削除後に保つべき値の数
+            // (これを下回ったら兄弟から借りるか, 兄弟と併合する)
+            static const size_type  min_slots = node_slots / 2;
+
+            class internal_node;
+
+            // [btreeのノード]
+            // 値の配列と親へのリンクを持つ。葉ノードはこのクラスで確保する。
+            // 葉でないノードは internal_node として確保され, 子へのポインタの配列も持つ。
+            // 値の配列は生のメモリで, [0, count) だけが構築済み。
+            class node {
+                public:
+                    // 親ノード(根ならNULL)
+                    internal_node*  parent_;
+                    // 親の子配列の中での自分の位置
+                    unsigned short  position_;
+                    // 構築済みの値の数
+                    unsigned short  count_;
+                    // 葉ノードか
+                    bool            leaf_;
+                    // 値の配列
+                    // (C++98 には alignas がないので, union でアラインメントを確保する)
+                    union {
+                        char        bytes_[sizeof(value_type) * node_slots];
+                        long double align_ld_;
+                        double      align_d_;
+                        long        align_l_;
+                        void*       align_p_;
+                    }               storage_;
+
+                    explicit node(bool leaf)
+                        : parent_(NULL), position_(0), count_(0), leaf_(leaf) {}
+
+                    bool                is_leaf() const { return leaf_; }
+                    size_type           count() const { return count_; }
+                    size_type           position() const { return position_; }
+                    internal_node*      parent() const { return parent_; }
+
+                    value_type*         values() {
+                        return reinterpret_cast<value_type*>(storage_.bytes_);
+                    }
+                    const value_type*   values() const {
+                        return reinterpret_cast<const value_type*>(storage_.bytes_);
+                    }
+                    value_type&         value(size_type i) { return values()[i]; }
+                    const value_type&   value(size_type i) const { return values()[i]; }
+
+                    // 葉でないノードに対してだけ呼べる。
+                    node*               child(size_type i) const {
+                        return static_cast<const internal_node*>(this)->children_[i];
+                    }
+            };
+
+            class internal_node: public node {
+                public:
+                    // 子ノード([0, count] が有効)
+                    node*   children_[node_slots + 1];
+
+                    internal_node(): node(false) {
+                        for (size_type i = 0; i <= node_slots; ++i) {
+                            children_[i] = NULL;
+                        }
+                    }
+
+                    // i 番目の子に c を置き, c の親と位置を設定する。
+                    void    set_child(size_type i, node* c) {
+                        children_[i] = c;
+                        c->parent_ = this;
+                        c->position_ = static_cast<unsigned short>(i);
+                    }
+            };
+
+            class const_iterator;
+
+            // [イテレータ]
+            // ノードとノード内の位置の組。
+            // end は「最も右の葉の count 番目」(空の木なら (NULL, 0))。
+            class iterator {
+                public:
+                    typedef typename btree::value_type                  value_type;
+                    typedef typename btree::difference_type             difference_type;
+                    typedef value_type*                                 pointer;
+                    typedef value_type&                                 reference;
+                    typedef std::bidirectional_iterator_tag             iterator_category;
+
+                    node*       node_;
+                    size_type   position_;
+
+                    iterator(): node_(NULL), position_(0) {}
+                    iterator(node* n, size_type i): node_(n), position_(i) {}
+
+                    reference   operator*() const { return node_->value(position_); }
+                    pointer     operator->() const { return &node_->value(position_); }
+
+                    iterator&   operator++() {
+                        btree::increment_(node_, position_);
+                        return *this;
+                    }
+                    iterator    operator++(int) {
+                        iterator    it = *this;
+                        ++*this;
+                        return it;
+                    }
+                    iterator&   operator--() {
+                        btree::decrement_(node_, position_);
+                        return *this;
+                    }
+                    iterator    operator--(int) {
+                        iterator    it = *this;
+                        --*this;
+                        return it;
+                    }
+
+                    bool        operator==(const iterator& rhs) const {
+                        return node_ == rhs.node_ && position_ == rhs.position_;
+                    }
+                    bool        operator!=(const iterator& rhs) const {
+                        return !(*this == rhs);
+                    }
+                    bool        operator==(const const_iterator& rhs) const {
+                        return node_ == rhs.node_ && position_ == rhs.position_;
+                    }
+                    bool        operator!=(const const_iterator& rhs) const {
+                        return !(*this == rhs);
+                    }
+            };
+
+            // [constイテレータ]
+            class const_iterator {
+                public:
+                    typedef typename btree::value_type                  value_type;
+                    typedef typename btree::difference_type             difference_type;
+                    typedef const value_type*                           pointer;
+                    typedef const value_type&                           reference;
+                    typedef std::bidirectional_iterator_tag             iterator_category;
+
+                    // (非constイテレータへ戻せるように, ノードは非constで持つ)
+                    node*       node_;
+                    size_type   position_;
+
+                    const_iterator(): node_(NULL), position_(0) {}
+                    const_iterator(node* n, size_type i): node_(n), position_(i) {}
+                    // これは explicit つけない
+                    const_iterator(const iterator& variable)
+                        : node_(variable.node_), position_(variable.position_) {}
+
+                    reference       operator*() const { return node_->value(position_); }
+                    pointer         operator->() const { return &node_->value(position_); }
+
+                    const_iterator& operator++() {
+                        btree::increment_(node_, position_);
+                        return *this;
+                    }
+                    const_iterator  operator++(int) {
+                        const_iterator  it = *this;
+                        ++*this;
+                        return it;
+                    }
+                    const_iterator& operator--() {
+                        btree::decrement_(node_, position_);
+                        return *this;
+                    }
+                    const_iterator  operator--(int) {
+                        const_iterator  it = *this;
+                        --*this;
+                        return it;
+                    }
+
+                    bool            operator==(const const_iterator& rhs) const {
+                        return node_ == rhs.node_ && position_ == rhs.position_;
+                    }
+                    bool            operator!=(const const_iterator& rhs) const {
+                        return !(*this == rhs);
+                    }
+            };
+
+            typedef typename ft::reverse_iterator<iterator>         reverse_iterator;
+            typedef typename ft::reverse_iterator<const_iterator>   const_reverse_iterator;
+
+        FT_PRIVATE:
+            typedef typename value_allocator_type::template rebind<node>::other
+                                                                        leaf_allocator_type;
+            typedef typename value_allocator_type::template rebind<internal_node>::other
+                                                                        internal_allocator_type;
+
+            // [[メンバ変数]]
+
+            // 根(空ならNULL)
+            node*                   root_;
+            // 最も左の葉(キャッシュ)
+            node*                   leftmost_;
+            // 最も右の葉(キャッシュ)
+            node*                   rightmost_;
+            // 要素数
+            size_type               size_;
+            // 葉ノードのアロケータ
+            leaf_allocator_type     leaf_allocator_;
+            // 葉でないノードのアロケータ
+            internal_allocator_type internal_allocator_;
+            // Valueのアロケータ
+            value_allocator_type    value_allocator_;
+            // Valueの比較関数
+            value_comparator_type   value_compare_;
+
+        public:
+            // [[コンストラクタ群]]
+
+            explicit btree(
+                const value_comparator_type& comp = value_comparator_type(),
+                const value_allocator_type& allocator = value_allocator_type()
+            ):
+                root_(NULL), leftmost_(NULL), rightmost_(NULL), size_(0),
+                leaf_allocator_(allocator),
+                internal_allocator_(allocator),
+                value_allocator_(allocator),
+                value_compare_(comp) {}
+
+            // コピーコンストラクタ
+            // other の形をそのまま複製する。比較を行わないので O(N).
+            btree(const self_type& other):
+                root_(NULL), leftmost_(NULL), rightmost_(NULL), size_(0),
+                leaf_allocator_(other.leaf_allocator_),
+                internal_allocator_(other.internal_allocator_),
+                value_allocator_(other.value_allocator_),
+                value_compare_(other.value_compare_)
+            {
+                if (other.root_ != NULL) {
+                    // 例外が出た場合は clone_subtree_ が作りかけの部分を破壊する。
+                    root_ = clone_subtree_(other.root_);
+                    size_ = other.size_;
+                    reset_ends_();
+                }
+            }
+
+            ~btree() {
+                clear();
+            }
+
+            self_type&  operator=(const self_type& rhs) {
+                if (this == &rhs) { return *this; }
+                // copy and swap (STRONG)
+                self_type   temp(rhs);
+                swap(temp);
+                return *this;
+            }
+
+            value_allocator_type&           get_allocator() { return value_allocator_; }
+            const value_allocator_type&     get_allocator() const { return value_allocator_; }
+            value_comparator_type&          value_compare() { return value_compare_; }
+            const value_comparator_type&    value_compare() const { return value_compare_; }
+
+            iterator                begin() { return iterator(leftmost_, 0); }
+            const_iterator          begin() const { return const_iterator(leftmost_, 0); }
+            iterator                end() {
+                return iterator(rightmost_, rightmost_ ? rightmost_->count() : 0);
+            }
+            const_iterator          end() const {
+                return const_iterator(rightmost_, rightmost_ ? rightmost_->count() : 0);
+            }
+            reverse_iterator        rbegin() { return reverse_iterator(end()); }
+            const_reverse_iterator  rbegin() const { return const_reverse_iterator(end()); }
+            reverse_iterator        rend() { return reverse_iterator(begin()); }
+            const_reverse_iterator  rend() const { return const_reverse_iterator(begin()); }
+
+            size_type   size() const { return size_; }
+            bool        empty() const { return size_ == 0; }
+            size_type   max_size() const {
+                return std::min<size_type>(
+                    value_allocator_.max_size(),
+                    std::numeric_limits<difference_type>::max()
+                );
+            }
+
+            // [[変更系]]
+
+            void    clear() {
+                destroy_subtree_(root_);
+                root_ = NULL;
+                leftmost_ = NULL;
+                rightmost_ = NULL;
+                size_ = 0;
+            }
+
+            void    swap(self_type& other) {
+                ft::swap(root_, other.root_);
+                ft::swap(leftmost_, other.leftmost_);
+                ft::swap(rightmost_, other.rightmost_);
+                ft::swap(size_, other.size_);
+                ft::swap(leaf_allocator_, other.leaf_allocator_);
+                ft::swap(internal_allocator_, other.internal_allocator_);
+                ft::swap(value_allocator_, other.value_allocator_);
+                ft::swap(value_compare_, other.value_compare_);
+            }
+
+            // [insert]
+
+            // 単一・ヒントなし挿入
+            pair<iterator, bool>    insert(const value_type& x) {
+                if (root_ == NULL) {
+                    return ft::make_pair(insert_at_(new_root_(), 0, x), true);
+                }
+                node*   n = root_;
+                for (;;) {
+                    size_type   i = lower_index_(n, x);
+                    if (i < n->count() && !value_compare_(x, n->value(i))) {
+                        // 挿入不可
+                        return ft::make_pair(iterator(n, i), false);
+                    }
+                    if (n->is_leaf()) {
+                        return ft::make_pair(insert_at_(n, i, x), true);
+                    }
+                    n = n->child(i);
+                }
+            }
+
+            // 単一・ヒントあり挿入
+            // x が hint の直前に入るなら, 探索せずにそこへ挿入する(償却定数時間)。
+            // そうでなければヒントなし挿入と同じ。
+            iterator    insert(const_iterator hint, const value_type& x) {
+                if (root_ == NULL) {
+                    return insert(x).first;
+                }
+                const_iterator  e = end();
+                if (hint == e || value_compare_(x, *hint)) {
+                    const_iterator  prev = hint;
+                    if (hint == begin() || value_compare_(*--prev, x)) {
+                        // prev < x < hint
+                        // hint が葉を指していればその位置に, そうでなければ prev の直後(葉)に入れる。
+                        if (hint.node_->is_leaf()) {
+                            return insert_at_(hint.node_, hint.position_, x);
+                        }
+                        return insert_at_(prev.node_, prev.position_ + 1, x);
+                    }
+                } else if (!value_compare_(*hint, x)) {
+                    // *hint == x
+                    return iterator(hint.node_, hint.position_);
+                }
+                return insert(x).first;
+            }
+
+            // 範囲挿入
+            template <class InputIterator>
+            void    insert(InputIterator first, InputIterator last) {
+                for (; first != last; ++first) {
+                    insert(end(), *first);
+                }
+            }
+
+            // ソート済み・重複なし範囲挿入
+            // 常に end の直前に入るので, 空の木なら比較1回ずつで末尾に追記していく(線形時間)。
+            // 末尾への挿入では右端のノードを詰めたまま分割するので, ノードはほぼ満杯になる。
+            template <class InputIterator>
+            void    insert(sorted_unique_t, InputIterator first, InputIterator last) {
+                insert(first, last);
+            }
+
+            // [erase]
+
+            // position の要素を削除し, 次の要素を指すイテレータを返す。
+            iterator    erase(const_iterator position) {
+                node*       n = position.node_;
+                size_type   i = position.position_;
+                bool        from_internal = !n->is_leaf();
+                if (from_internal) {
+                    // 左の部分木の最大値(直前の要素)を葉から持ってきて, 消す値と入れ替える。
+                    // -> 葉から値を1個消すのと同じになる。
+                    node*   l = n->child(i);
+                    while (!l->is_leaf()) {
+                        l = l->child(l->count());
+                    }
+                    destroy_value_(&n->value(i));
+                    relocate_(&n->value(i), &l->value(l->count() - 1));
+                    --l->count_;
+                    n = l;
+                    i = l->count();
+                } else {
+                    destroy_value_(&n->value(i));
+                    for (size_type j = i; j + 1 < n->count(); ++j) {
+                        relocate_(&n->value(j), &n->value(j + 1));
+                    }
+                    --n->count_;
+                }
+                --size_;
+                // (n, i) は「消した値の次の要素」を指している。
+                // ただし葉でないノードから消した場合は, 持ってきた直前の要素を指しているので,
+                // そのさらに次が結果になる。
+                iterator    result = rebalance_after_erase_(n, i);
+                if (from_internal) {
+                    ++result;
+                }
+                return result;
+            }
+
+            void        erase(const_iterator first, const_iterator last) {
+                if (first == begin() && last == end()) {
+                    clear();
+                    return;
+                }
+                // 削除ごとにイテレータが無効になるので, 個数を数えてから消す。
+                difference_type n = std::distance(first, last);
+                iterator        it(first.node_, first.position_);
+                for (; n > 0; --n) {
+                    it = erase(it);
+                }
+            }
+
+            template <class Key>
+            size_type   erase_by_key(const Key& key) {
+                iterator    it = find(key);
+                if (it == end()) {
+                    return 0;
+                }
+                erase(it);
+                return 1;
+            }
+
+            // [[検索系]]
+
+            template <class Key>
+            iterator        find(const Key& key) {
+                iterator    it = lower_bound(key);
+                if (it == end() || value_compare_(key, *it)) {
+                    return end();
+                }
+                return it;
+            }
+            template <class Key>
+            const_iterator  find(const Key& key) const {
+                return const_cast<self_type*>(this)->find(key);
+            }
+
+            // key 以上の最初の要素
+            // 等しい値が途中のノードで見つかれば, そこで止める(キーに重複はないので)。
+            template <class Key>
+            iterator        lower_bound(const Key& key) {
+                return lower_bound_from_(root_, key);
+            }
+            template <class Key>
+            const_iterator  lower_bound(const Key& key) const {
+                return const_cast<self_type*>(this)->lower_bound(key);
+            }
+
+            // key より大きい最初の要素
+            template <class Key>
+            iterator        upper_bound(const Key& key) {
+                node*   n = root_;
+                if (n == NULL) { return end(); }
+                for (;;) {
+                    size_type   i = upper_index_(n, key);
+                    if (n->is_leaf()) {
+                        return normalize_(iterator(n, i));
+                    }
+                    n = n->child(i);
+                }
+            }
+            template <class Key>
+            const_iterator  upper_bound(const Key& key) const {
+                return const_cast<self_type*>(this)->upper_bound(key);
+            }
+
+            template <class Key>
+            size_type       count(const Key& key) const {
+                return find(key) == end() ? 0 : 1;
+            }
+
+            template <class Key>
+            pair<iterator, iterator>    equal_range(const Key& key) {
+                iterator    first = lower_bound(key);
+                iterator    last = first;
+                if (last != end() && !value_compare_(key, *last)) {
+                    ++last;
+                }
+                return ft::make_pair(first, last);
+            }
+            template <class Key>
+            pair<const_iterator, const_iterator>    equal_range(const Key& key) const {
+                pair<iterator, iterator>    r = const_cast<self_type*>(this)->equal_range(key);
+                return ft::make_pair(const_iterator(r.first), const_iterator(r.second));
+            }
+
+            // [[ヒントつき検索]]
+            // hint のノードから, key が値の範囲 (先頭, 末尾] に収まるノードまで登ってから降りる。
+            // hint と結果が近ければ, 根から探すより触るノードが少ない。
+            template <class Key>
+            iterator        lower_bound(const_iterator hint, const Key& key) {
+                node*   n = hint.node_;
+                if (n == NULL) { return end(); }
+                while (n->parent() != NULL && !(
+                    n->count() > 0
+                    && value_compare_(n->value(0), key)
+                    && !value_compare_(n->value(n->count() - 1), key)
+                )) {
+                    n = n->parent();
+                }
+                return lower_bound_from_(n, key);
+            }
+            template <class Key>
+            const_iterator  lower_bound(const_iterator hint, const Key& key) const {
+                return const_cast<self_type*>(this)->lower_bound(hint, key);
+            }
+
+            template <class Key>
+            iterator        find(const_iterator hint, const Key& key) {
+                iterator    it = lower_bound(hint, key);
+                if (it == end() || value_compare_(key, *it)) {
+                    return end();
+                }
+                return it;
+            }
+            template <class Key>
+            const_iterator  find(const_iterator hint, const Key& key) const {
+                return const_cast<self_type*>(this)->find(hint, key);
+            }
+
+            // ソート済みのキー列 [first, last) のそれぞれについて find した結果を out に書き出す。
+            // 前の結果をヒントにして探す。
+            template <class InputIterator, class OutputIterator>
+            OutputIterator  find_sorted(InputIterator first, InputIterator last, OutputIterator out) {
+                const_iterator  hint = begin();
+                for (; first != last; ++first, ++out) {
+                    iterator    it = lower_bound(hint, *first);
+                    hint = it;
+                    if (it == end() || value_compare_(*first, *it)) {
+                        *out = end();
+                    } else {
+                        *out = it;
+                    }
+                }
+                return out;
+            }
+
+        FT_PRIVATE:
+
+            // [[イテレータの移動]]
+
+            static void increment_(node*& n, size_type& i) {
+                if (!n->is_leaf()) {
+                    // 右の部分木の最小値
+                    n = n->child(i + 1);
+                    while (!n->is_leaf()) {
+                        n = n->child(0);
+                    }
+                    i = 0;
+                    return;
+                }
+                if (++i < n->count()) { return; }
+                // 葉の末尾を超えたら, 自分が左側にある区切り値まで登る。
+                // 根まで登っても見つからなければ end(最も右の葉の末尾)のまま。
+                node*       save_node = n;
+                size_type   save_i = i;
+                while (i == n->count() && n->parent() != NULL) {
+                    i = n->position();
+                    n = n->parent();
+                }
+                if (i == n->count()) {
+                    n = save_node;
+                    i = save_i;
+                }
+            }
+
+            static void decrement_(node*& n, size_type& i) {
+                if (!n->is_leaf()) {
+                    // 左の部分木の最大値
+                    n = n->child(i);
+                    while (!n->is_leaf()) {
+                        n = n->child(n->count());
+                    }
+                    i = n->count() - 1;
+                    return;
+                }
+                if (i > 0) {
+                    --i;
+                    return;
+                }
+                // 葉の先頭より前なら, 自分が右側にある区切り値まで登る。
+                while (i == 0 && n->parent() != NULL) {
+                    i = n->position();
+                    n = n->parent();
+                }
+                --i;
+            }
+
+            // (n, i) が「葉の末尾の次」を指しているなら, 実際の次の要素(または end)に直す。
+            iterator    normalize_(iterator it) {
+                node*       n = it.node_;
+                size_type   i = it.position_;
+                if (n == NULL || i < n->count()) { return it; }
+                while (i == n->count() && n->parent() != NULL) {
+                    i = n->position();
+                    n = n->parent();
+                }
+                if (i == n->count()) {
+                    return end();
+                }
+                return iterator(n, i);
+            }
+
+            // [[ノード内の探索]]
+            // 二分探索で, ノード内の値の位置を返す。
+
+            // key 以上の最初の位置
+            template <class Key>
+            size_type   lower_index_(const node* n, const Key& key) const {
+                size_type   lo = 0;
+                size_type   hi = n->count();
+                while (lo < hi) {
+                    size_type   mid = (lo + hi) / 2;
+                    if (value_compare_(n->value(mid), key)) {
+                        lo = mid + 1;
+                    } else {
+                        hi = mid;
+                    }
+                }
+                return lo;
+            }
+
+            // key より大きい最初の位置
+            template <class Key>
+            size_type   upper_index_(const node* n, const Key& key) const {
+                size_type   lo = 0;
+                size_type   hi = n->count();
+                while (lo < hi) {
+                    size_type   mid = (lo + hi) / 2;
+                    if (value_compare_(key, n->value(mid))) {
+                        hi = mid;
+                    } else {
+                        lo = mid + 1;
+                    }
+                }
+                return lo;
+            }
+
+            // n を根とする部分木で lower_bound を探す。
+            // 部分木の値がすべて key より小さければ, 部分木の次の要素(normalize_)になる。
+            template <class Key>
+            iterator    lower_bound_from_(node* n, const Key& key) {
+                if (n == NULL) { return end(); }
+                for (;;) {
+                    size_type   i = lower_index_(n, key);
+                    if (n->is_leaf()
+                        || (i < n->count() && !value_compare_(key, n->value(i)))) {
+                        return normalize_(iterator(n, i));
+                    }
+                    n = n->child(i);
+                }
+            }
+
+            // [[値の構築・移動]]
+
+            void    construct_value_(value_type* p, const value_type& x) {
+                value_allocator_.construct(p, x);
+            }
+
+            void    destroy_value_(value_type* p) {
+                value_allocator_.destroy(p);
+            }
+
+            // src の値を dst に移す(dst は未構築, 移した後 src は未構築)。
+            void    relocate_(value_type* dst, value_type* src) {
+                construct_value_(dst, *src);
+                destroy_value_(src);
+            }
+
+            // [[ノードの確保・解放]]
+
+            node*   new_leaf_() {
+                node*   p = leaf_allocator_.allocate(1);
+                ::new (static_cast<void*>(p)) node(true);
+                return p;
+            }
+
+            internal_node*  new_internal_() {
+                internal_node*  p = internal_allocator_.allocate(1);
+                ::new (static_cast<void*>(p)) internal_node();
+                return p;
+            }
+
+            // ノードを解放する(値はすでに破壊されていること)
+            void    delete_node_(node* n) {
+                if (n->is_leaf()) {
+                    n->~node();
+                    leaf_allocator_.deallocate(n, 1);
+                } else {
+                    internal_node*  p = static_cast<internal_node*>(n);
+                    p->~internal_node();
+                    internal_allocator_.deallocate(p, 1);
+                }
+            }
+
+            // n を根とする部分木を破壊する。
+            // (コピー途中の部分木では, まだない子が NULL になっている)
+            void    destroy_subtree_(node* n) {
+                if (n == NULL) { return; }
+                if (!n->is_leaf()) {
+                    for (size_type i = 0; i <= n->count(); ++i) {
+                        destroy_subtree_(n->child(i));
+                    }
+                }
+                for (size_type i = 0; i < n->count(); ++i) {
+                    destroy_value_(&n->value(i));
+                }
+                delete_node_(n);
+            }
+
+            // src を根とする部分木を複製し, 複製の根を返す。
+            // 途中で例外が出た場合は, 作りかけの部分木を破壊してから投げ直す。
+            node*   clone_subtree_(const node* src) {
+                node*   top = src->is_leaf()
+                    ? new_leaf_() : static_cast<node*>(new_internal_());
+                try {
+                    for (size_type i = 0; i < src->count(); ++i) {
+                        construct_value_(&top->value(i), src->value(i));
+                        ++top->count_;
+                    }
+                    if (!src->is_leaf()) {
+                        internal_node*  t = static_cast<internal_node*>(top);
+                        for (size_type i = 0; i <= src->count(); ++i) {
+                            t->set_child(i, clone_subtree_(src->child(i)));
+                        }
+                    }
+                } catch (...) {
+                    destroy_subtree_(top);
+                    throw;
+                }
+                return top;
+            }
+
+            // 最も左・右の葉のキャッシュを作り直す
+            void    reset_ends_() {
+                if (root_ == NULL) {
+                    leftmost_ = rightmost_ = NULL;
+                    return;
+                }
+                leftmost_ = root_;
+                while (!leftmost_->is_leaf()) {
+                    leftmost_ = leftmost_->child(0);
+                }
+                rightmost_ = root_;
+                while (!rightmost_->is_leaf()) {
+                    rightmost_ = rightmost_->child(rightmost_->count());
+                }
+            }
+
+            // [[挿入の下請け]]
+
+            // 空の木に, 空の葉を根として置く。
+            node*   new_root_() {
+                root_ = new_leaf_();
+                leftmost_ = rightmost_ = root_;
+                return root_;
+            }
+
+            // 葉 n の位置 i に x を挿入する。
+            // n が満杯なら先に分割する(必要なら祖先も)。
+            iterator    insert_at_(node* n, size_type i, const value_type& x) {
+                if (n->count() == node_slots) {
+                    size_type   k = split_full_(n, i);
+                    if (i > k) {
+                        n = n->parent()->child(n->position() + 1);
+                        i -= k + 1;
+                    }
+                }
+                // i 以降を1つずつ右にずらして, 空いた位置に構築する。
+                for (size_type j = n->count(); j > i; --j) {
+                    relocate_(&n->value(j), &n->value(j - 1));
+                }
+                try {
+                    construct_value_(&n->value(i), x);
+                } catch (...) {
+                    for (size_type j = i; j < n->count(); ++j) {
+                        relocate_(&n->value(j), &n->value(j + 1));
+                    }
+                    throw;
+                }
+                ++n->count_;
+                ++size_;
+                return iterator(n, i);
+            }
+
+            // 満杯のノード n を2つに分け, 分けた位置 k を返す。
+            // n には [0, k) が残り, k 番目の値は親へ, (k, count) は新しい右隣のノードへ移る。
+            // i はこのあと n に挿入する位置で, 分け方を決めるのに使う:
+            // - 末尾への挿入なら右をほぼ空にする(昇順の挿入で左のノードが満杯のまま残る)
+            // - 先頭への挿入なら左をほぼ空にする(降順の挿入で右のノードが満杯のまま残る)
+            // - それ以外は半分に分ける
+            // 親が満杯なら, 先に親を分割する。根なら新しい根を作る。
+            size_type   split_full_(node* n, size_type i) {
+                if (n->parent() == NULL) {
+                    internal_node*  top = new_internal_();
+                    top->set_child(0, n);
+                    root_ = top;
+                } else if (n->parent()->count() == node_slots) {
+                    split_full_(n->parent(), n->position());
+                }
+                size_type   k = node_slots / 2;
+                if (i == node_slots) {
+                    k = node_slots - 2;
+                } else if (i == 0) {
+                    k = 1;
+                }
+                node*   r;
+                try {
+                    r = n->is_leaf() ? new_leaf_() : static_cast<node*>(new_internal_());
+                } catch (...) {
+                    // 根を作ったばかりなら元に戻す
+                    if (root_ != n && root_->count() == 0) {
+                        delete_node_(root_);
+                        root_ = n;
+                        n->parent_ = NULL;
+                    }
+                    throw;
+                }
+                internal_node*  p = n->parent();
+                size_type       pos = n->position();
+                // 親の pos に区切り値, pos + 1 に r を入れる場所を空ける。
+                for (size_type j = p->count(); j > pos; --j) {
+                    relocate_(&p->value(j), &p->value(j - 1));
+                }
+                for (size_type j = p->count() + 1; j > pos + 1; --j) {
+                    p->set_child(j, p->child(j - 1));
+                }
+                relocate_(&p->value(pos), &n->value(k));
+                p->set_child(pos + 1, r);
+                ++p->count_;
+                // 右半分を r に移す。
+                size_type   m = n->count() - k - 1;
+                for (size_type j = 0; j < m; ++j) {
+                    relocate_(&r->value(j), &n->value(k + 1 + j));
+                }
+                if (!n->is_leaf()) {
+                    internal_node*  rr = static_cast<internal_node*>(r);
+                    for (size_type j = 0; j <= m; ++j) {
+                        rr->set_child(j, n->child(k + 1 + j));
+                    }
+                }
+                r->count_ = static_cast<unsigned short>(m);
+                n->count_ = static_cast<unsigned short>(k);
+                if (n == rightmost_) {
+                    rightmost_ = r;
+                }
+                return k;
+            }
+
+            // [[削除の下請け]]
+
+            // 葉 n から値を消した後, 値が少なくなりすぎたノードを兄弟から借りるか併合して直す。
+            // (n, i) は消した値の次の要素を指していて, 値の移動に合わせて追いかける。
+            // 最後に (n, i) が指す要素を返す。
+            iterator    rebalance_after_erase_(node* n, size_type i) {
+                iterator    tracked(n, i);
+                while (n != root_ && n->count() < min_slots) {
+                    internal_node*  p = n->parent();
+                    size_type       pos = n->position();
+                    node*           left = pos > 0 ? p->child(pos - 1) : NULL;
+                    node*           right = pos < p->count() ? p->child(pos + 1) : NULL;
+                    if (left != NULL && left->count() > min_slots) {
+                        // 左隣から1個借りる(先頭に1個入る)
+                        rotate_right_(left, n);
+                        if (tracked.node_ == n) {
+                            ++tracked.position_;
+                        }
+                        break;
+                    }
+                    if (right != NULL && right->count() > min_slots) {
+                        // 右隣から1個借りる(末尾に1個入る)
+                        rotate_left_(n, right);
+                        break;
+                    }
+                    if (left != NULL) {
+                        // 左隣に併合する
+                        if (tracked.node_ == n) {
+                            tracked.node_ = left;
+                            tracked.position_ += left->count() + 1;
+                        }
+                        merge_(left, n);
+                    } else {
+                        // 右隣を併合する
+                        merge_(n, right);
+                    }
+                    n = p;
+                }
+                if (root_->count() == 0) {
+                    if (root_->is_leaf()) {
+                        // 空になった
+                        delete_node_(root_);
+                        root_ = leftmost_ = rightmost_ = NULL;
+                        return end();
+                    }
+                    // 根が空になったら, 唯一の子を新しい根にする。
+                    node*   c = root_->child(0);
+                    delete_node_(root_);
+                    root_ = c;
+                    c->parent_ = NULL;
+                    c->position_ = 0;
+                }
+                return normalize_(tracked);
+            }
+
+            // 左隣 left の最後の値を親の区切り値を通して n の先頭に移す。
+            void    rotate_right_(node* left, node* n) {
+                internal_node*  p = n->parent();
+                size_type       sep = n->position() - 1;
+                for (size_type j = n->count(); j > 0; --j) {
+                    relocate_(&n->value(j), &n->value(j - 1));
+                }
+                relocate_(&n->value(0), &p->value(sep));
+                relocate_(&p->value(sep), &left->value(left->count() - 1));
+                if (!n->is_leaf()) {
+                    internal_node*  nn = static_cast<internal_node*>(n);
+                    for (size_type j = n->count() + 1; j > 0; --j) {
+                        nn->set_child(j, n->child(j - 1));
+                    }
+                    nn->set_child(0, left->child(left->count()));
+                }
+                --left->count_;
+                ++n->count_;
+            }
+
+            // 右隣 right の最初の値を親の区切り値を通して n の末尾に移す。
+            void    rotate_left_(node* n, node* right) {
+                internal_node*  p = n->parent();
+                size_type       sep = n->position();
+                relocate_(&n->value(n->count()), &p->value(sep));
+                relocate_(&p->value(sep), &right->value(0));
+                for (size_type j = 0; j + 1 < right->count(); ++j) {
+                    relocate_(&right->value(j), &right->value(j + 1));
+                }
+                if (!n->is_leaf()) {
+                    internal_node*  nn = static_cast<internal_node*>(n);
+                    internal_node*  rr = static_cast<internal_node*>(right);
+                    nn->set_child(n->count() + 1, right->child(0));
+                    for (size_type j = 0; j < right->count(); ++j) {
+                        rr->set_child(j, right->child(j + 1));
+                    }
+                }
+                ++n->count_;
+                --right->count_;
+            }
+
+            // left + 区切り値 + right を left にまとめ, right を解放する。
+            void    merge_(node* left, node* right) {
+                internal_node*  p = left->parent();
+                size_type       sep = left->position();
+                size_type       base = left->count();
+                relocate_(&left->value(base), &p->value(sep));
+                for (size_type j = 0; j < right->count(); ++j) {
+                    relocate_(&left->value(base + 1 + j), &right->value(j));
+                }
+                if (!left->is_leaf()) {
+                    internal_node*  ll = static_cast<internal_node*>(left);
+                    for (size_type j = 0; j <= right->count(); ++j) {
+                        ll->set_child(base + 1 + j, right->child(j));
+                    }
+                }
+                left->count_ = static_cast<unsigned short>(base + 1 + right->count());
+                // 親から区切り値と right を取り除く
+                for (size_type j = sep; j + 1 < p->count(); ++j) {
+                    relocate_(&p->value(j), &p->value(j + 1));
+                }
+                for (size_type j = sep + 1; j < p->count(); ++j) {
+                    p->set_child(j, p->child(j + 1));
+                }
+                --p->count_;
+                if (right == rightmost_) {
+                    rightmost_ = left;
+                }
+                right->count_ = 0;
+                delete_node_(right);
+            }
+
+        // [[デバッグメソッド]]
+        public:
+
+            // 木の高さ(空なら0)
+            size_type   debug_height() const {
+                size_type   h = 0;
+                for (const node* n = root_; n != NULL; n = n->is_leaf() ? NULL : n->child(0)) {
+                    ++h;
+                }
+                return h;
+            }
+
+            // 構造が正しいか調べる:
+            // - 親子のリンクと位置が合っている
+            // - すべての葉が同じ深さ
+            // - 根以外のノードは空でない
+            // - 値がソート済みで, 区切り値が子の範囲を分けている
+            // - 要素数と端のキャッシュが合っている
+            bool        debug_valid() const {
+                if (root_ == NULL) {
+                    return size_ == 0 && leftmost_ == NULL && rightmost_ == NULL;
+                }
+                if (root_->parent() != NULL) { return false; }
+                size_type   leaf_depth = 0;
+                size_type   total = 0;
+                if (!debug_valid_subtree_(root_, 1, leaf_depth, total, NULL, NULL)) {
+                    return false;
+                }
+                const node* l = root_;
+                while (!l->is_leaf()) { l = l->child(0); }
+                const node* r = root_;
+                while (!r->is_leaf()) { r = r->child(r->count()); }
+                return total == size_ && l == leftmost_ && r == rightmost_;
+            }
+
+        FT_PRIVATE:
+            bool        debug_valid_subtree_(
+                const node* n, size_type depth, size_type& leaf_depth, size_type& total,
+                const value_type* lo, const value_type* hi
+            ) const {
+                if (n->count() > node_slots) { return false; }
+                if (n != root_ && n->count() == 0) { return false; }
+                for (size_type i = 0; i < n->count(); ++i) {
+                    const value_type&   v = n->value(i);
+                    if (i > 0 && !value_compare_(n->value(i - 1), v)) { return false; }
+                    if (lo != NULL && !value_compare_(*lo, v)) { return false; }
+                    if (hi != NULL && !value_compare_(v, *hi)) { return false; }
+                }
+                total += n->count();
+                if (n->is_leaf()) {
+                    if (leaf_depth == 0) {
+                        leaf_depth = depth;
+                    }
+                    return leaf_depth == depth;
+                }
+                for (size_type i = 0; i <= n->count(); ++i) {
+                    const node* c = n->child(i);
+                    if (c == NULL || c->parent() != n || c->position() != i) { return false; }
+                    if (!debug_valid_subtree_(
+                        c, depth + 1, leaf_depth, total,
+                        i == 0 ? lo : &n->value(i - 1),
+                        i == n->count() ? hi : &n->value(i)
+                    )) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,417 @@
+#ifndef BTREE_MAP_HPP
+# define BTREE_MAP_HPP
+# include "btree.hpp"
+# include "pair.hpp"
+# include "ft_algorithm.hpp"
+
+namespace ft {
+
+    // [btree_map]
+    // ft::map と同じインターフェースを持つ, B-Tree を使ったmap。
+    // 値(pair)はノード内の配列にまとめて載るので, 小さいキーの読み込み中心の用途で速い。
+    // ft::map との違い:
+    // - 挿入・削除はすべてのイテレータ・参照を無効にする(end も含む)。
+    // - erase(position) は次の要素を指すイテレータを返す。
+    // - 分割・連結, 順序統計, find_batch はない。
+    // - 値のコピーコンストラクタは例外を投げないこと(btree を参照)。
+    // TargetNodeSize はノード1個の目標バイト数。
+    template <
+        class Key,
+        class Value,
+        class KeyComparator = std::less<Key>,
+        class PairAllocator = std::allocator<ft::pair<const Key, Value> >,
+        std::size_t TargetNodeSize = 256
+    >
+    class btree_map {
+        public:
+            typedef Key                                         key_type;
+            typedef Value                                       mapped_type;
+            typedef ft::pair<const key_type, mapped_type>       value_type;
+            typedef KeyComparator                               key_compare;
+            typedef PairAllocator                               allocator_type;
+            typedef btree_map<key_type, mapped_type, key_compare, allocator_type, TargetNodeSize>
+                                                                self_type;
+            typedef value_type&                                 reference;
+            typedef const value_type&                           const_reference;
+            typedef typename allocator_type::pointer            pointer;
+            typedef typename allocator_type::const_pointer      const_pointer;
+            typedef typename allocator_type::size_type          size_type;
+            typedef typename allocator_type::difference_type    difference_type;
+
+            // btree と btree_map を接続するコンパレータ
+            // (map の map_value_compare と同じもの)
+            class btree_value_compare {
+                FT_PRIVATE:
+                    key_compare key_compare_;
+
+                public:
+                    btree_value_compare()
+                        : key_compare_() {}
+
+                    explicit btree_value_compare(key_compare c)
+                        : key_compare_(c) {}
+
+                    const key_compare&  key_comp() const { return key_compare_; }
+
+                    bool operator()(const value_type& x, const value_type& y) const {
+                        return key_compare_(x.first, y.first);
+                    }
+
+                    bool operator()(const value_type& x, const key_type& y) const {
+                        return key_compare_(x.first, y);
+                    }
+
+                    bool operator()(const key_type& x, const value_type& y) const {
+                        return key_compare_(x, y.first);
+                    }
+
+                    // Key以外の型との比較(transparent な場合)
+                    template <class K>
+                    bool operator()(const value_type& x, const K& y) const {
+                        return key_compare_(x.first, y);
+                    }
+
+                    template <class K>
+                    bool operator()(const K& x, const value_type& y) const {
+                        return key_compare_(x, y.first);
+                    }
+            };
+
+            // 内部btree
+            typedef ft::btree<value_type, btree_value_compare, allocator_type, TargetNodeSize>
+                                                                base;
+            // btree のイテレータはそのまま値を指すので, そのまま使う。
+            typedef typename base::iterator                     iterator;
+            typedef typename base::const_iterator               const_iterator;
+            typedef ft::reverse_iterator<iterator>              reverse_iterator;
+            typedef ft::reverse_iterator<const_iterator>        const_reverse_iterator;
+
+            // pair<MK, MV> のコンパレータ
+            class value_compare {
+                friend class btree_map;
+
+                protected:
+                    key_compare comp;
+
+                    value_compare(key_compare c): comp(c) {}
+
+                public:
+                    typedef bool        result_type;
+                    typedef value_type  first_argument_type;
+                    typedef value_type  second_argument_type;
+
+                    bool operator()(const value_type& x, const value_type& y) const {
+                        return comp(x.first, y.first);
+                    }
+            };
+
+        FT_PRIVATE:
+
+            // 内部btree
+            base    tree_;
+
+        public:
+
+            // [[コンストラクタ群]]
+
+            btree_map(): tree_(btree_value_compare(KeyComparator()), PairAllocator()) {}
+
+            explicit btree_map(
+                const KeyComparator& comp
+            ): tree_(btree_value_compare(comp), PairAllocator()) {}
+
+            explicit btree_map(
+                const KeyComparator& comp,
+                const PairAllocator& alloc
+            ): tree_(btree_value_compare(comp), alloc) {}
+
+            template <class InputIterator>
+            btree_map(InputIterator first,
+                InputIterator last,
+                const KeyComparator& comp = KeyComparator(),
+                const PairAllocator& alloc = PairAllocator()
+            ): tree_(btree_value_compare(comp), alloc) {
+                insert(first, last);
+            }
+
+            // [first, last) がソート済みかつ重複なしであれば, 線形時間で構築する。
+            template <class InputIterator>
+            btree_map(ft::sorted_unique_t,
+                InputIterator first,
+                InputIterator last,
+                const KeyComparator& comp = KeyComparator(),
+                const PairAllocator& alloc = PairAllocator()
+            ): tree_(btree_value_compare(comp), alloc) {
+                insert(ft::sorted_unique, first, last);
+            }
+
+            btree_map(const self_type& other)
+                : tree_(other.tree_) {}
+
+            ~btree_map() {}
+
+            self_type&      operator=(const self_type& rhs) {
+                if (this == &rhs) { return *this; }
+                tree_ = rhs.tree_;
+                return *this;
+            }
+
+            // [[getter群]]
+
+            allocator_type  get_allocator() const {
+                return allocator_type(tree_.get_allocator());
+            }
+
+            iterator                begin() { return tree_.begin(); }
+            const_iterator          begin() const { return tree_.begin(); }
+            iterator                end() { return tree_.end(); }
+            const_iterator          end() const { return tree_.end(); }
+            reverse_iterator        rbegin() { return reverse_iterator(end()); }
+            const_reverse_iterator  rbegin() const { return const_reverse_iterator(end()); }
+            reverse_iterator        rend() { return reverse_iterator(begin()); }
+            const_reverse_iterator  rend() const { return const_reverse_iterator(begin()); }
+
+            bool            empty() const { return tree_.empty(); }
+            size_type       size() const { return tree_.size(); }
+            size_type       max_size() const { return tree_.max_size(); }
+
+            // [[ライフサイクル]]
+
+            void            clear() { tree_.clear(); }
+
+            // [[挿入系関数群]]
+
+            pair<iterator, bool>    insert(const value_type& v) {
+                return tree_.insert(v);
+            }
+            iterator                insert(const_iterator hint, const value_type& v) {
+                return tree_.insert(hint, v);
+            }
+            template <class InputIterator>
+            void                    insert(InputIterator first, InputIterator last) {
+                tree_.insert(first, last);
+            }
+            // [first, last) がソート済みかつ重複なしであることを呼び出し側が保証する範囲挿入。
+            template <class InputIterator>
+            void                    insert(ft::sorted_unique_t, InputIterator first, InputIterator last) {
+                tree_.insert(ft::sorted_unique, first, last);
+            }
+
+            // [[削除]]
+
+            // 次の要素を指すイテレータを返す(削除で他のイテレータは無効になるので)。
+            iterator     erase(const_iterator position) {
+                return tree_.erase(position);
+            }
+            size_type    erase(const key_type& x) {
+                return tree_.erase_by_key(x);
+            }
+            // key_compare が transparent なら, key_type を作らずに削除できる。
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, size_type, const_iterator>::type
+                         erase(const K& x) {
+                return tree_.erase_by_key(x);
+            }
+            void         erase(const_iterator first, const_iterator last) {
+                tree_.erase(first, last);
+            }
+
+            void         swap(self_type& other) {
+                tree_.swap(other.tree_);
+            }
+
+            // [[検索系関数]]
+
+            Value&          operator[](const key_type& x) {
+                ft::pair<iterator, bool> result = insert(ft::make_pair(x, mapped_type()));
+                return (result.first)->second;
+            }
+
+            size_type       count(const key_type& x) const {
+                return tree_.count(x);
+            }
+
+            iterator        find(const key_type& x) {
+                return tree_.find(x);
+            }
+            const_iterator  find(const key_type& x) const {
+                return tree_.find(x);
+            }
+
+            pair<iterator, iterator>                equal_range(const key_type& x) {
+                return tree_.equal_range(x);
+            }
+            pair<const_iterator, const_iterator>    equal_range(const key_type& x) const {
+                return tree_.equal_range(x);
+            }
+
+            iterator                                lower_bound(const key_type& x) {
+                return tree_.lower_bound(x);
+            }
+            const_iterator                          lower_bound(const key_type& x) const {
+                return tree_.lower_bound(x);
+            }
+
+            iterator                                upper_bound(const key_type& x) {
+                return tree_.upper_bound(x);
+            }
+            const_iterator                          upper_bound(const key_type& x) const {
+                return tree_.upper_bound(x);
+            }
+
+            // [[ヒントつき検索]]
+            // hint の位置から探す。hint と結果が近ければ, 根から探すより速い。
+
+            iterator                                lower_bound(iterator hint, const key_type& x) {
+                return tree_.lower_bound(hint, x);
+            }
+            const_iterator                          lower_bound(const_iterator hint, const key_type& x) const {
+                return tree_.lower_bound(hint, x);
+            }
+
+            iterator                                find(iterator hint, const key_type& x) {
+                return tree_.find(hint, x);
+            }
+            const_iterator                          find(const_iterator hint, const key_type& x) const {
+                return tree_.find(hint, x);
+            }
+
+            // [[一括検索]]
+
+            // ソート済み(key_comp の順, 重複可)のキー列 [first, last) のそれぞれについて,
+            // find した結果(なければ end())を順に out に書き出す。
+            template <class InputIterator, class OutputIterator>
+            OutputIterator          find_sorted(InputIterator first, InputIterator last, OutputIterator out) {
+                return tree_.find_sorted(first, last, out);
+            }
+
+            // [[異種キーでの検索]]
+            // key_compare が is_transparent 型を持つなら, key_type と比較できる任意の型で検索できる。
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, size_type>::type
+                                                    count(const K& x) const {
+                return tree_.count(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, iterator>::type
+                                                    find(const K& x) {
+                return tree_.find(x);
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    find(const K& x) const {
+                return tree_.find(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, pair<iterator, iterator> >::type
+                                                    equal_range(const K& x) {
+                return tree_.equal_range(x);
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, pair<const_iterator, const_iterator> >::type
+                                                    equal_range(const K& x) const {
+                return tree_.equal_range(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, iterator>::type
+                                                    lower_bound(const K& x) {
+                return tree_.lower_bound(x);
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    lower_bound(const K& x) const {
+                return tree_.lower_bound(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, iterator>::type
+                                                    upper_bound(const K& x) {
+                return tree_.upper_bound(x);
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    upper_bound(const K& x) const {
+                return tree_.upper_bound(x);
+            }
+
+            key_compare     key_comp() const {
+                return tree_.value_compare().key_comp();
+            }
+
+            value_compare   value_comp() const {
+                return value_compare(tree_.value_compare().key_comp());
+            }
+
+            // 内部構造が正しいか(テスト用)
+            bool            debug_valid() const {
+                return tree_.debug_valid();
+            }
+    };
+
+    // [比較演算子]
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator, std::size_t N>
+    inline bool operator==(
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& lhs,
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& rhs
+    ) {
+        return lhs.size() == rhs.size()
+            && ft::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator, std::size_t N>
+    inline bool operator!=(
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& lhs,
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& rhs
+    ) {
+        return !(lhs == rhs);
+    }
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator, std::size_t N>
+    inline bool operator<(
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& lhs,
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& rhs
+    ) {
+        return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator, std::size_t N>
+    inline bool operator<=(
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& lhs,
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& rhs
+    ) {
+        return !(lhs > rhs);
+    }
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator, std::size_t N>
+    inline bool operator>(
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& lhs,
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& rhs
+    ) {
+        return rhs < lhs;
+    }
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator, std::size_t N>
+    inline bool operator>=(
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& lhs,
+        const ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& rhs
+    ) {
+        return !(lhs < rhs);
+    }
+}
+
+namespace std {
+    template <class Key, class Value, class KeyComparator, class PairAllocator, std::size_t N>
+    inline void swap(
+        ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& lhs,
+        ft::btree_map<Key, Value, KeyComparator, PairAllocator, N>& rhs
+    ) {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
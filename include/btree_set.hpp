@@ -0,0 +1,294 @@
+#ifndef BTREE_SET_HPP
+# define BTREE_SET_HPP
+# include "btree.hpp"
+# include "pair.hpp"
+# include "ft_algorithm.hpp"
+
+namespace ft {
+
+    // [btree_set]
+    // ft::set と同じインターフェースを持つ, B-Tree を使ったset。
+    // ft::set との違いは btree_map と同じ。
+    template <
+        class Key,
+        class KeyComparator = std::less<Key>,
+        class KeyAllocator = std::allocator<Key>,
+        std::size_t TargetNodeSize = 256
+    >
+    class btree_set {
+        public:
+            typedef Key                                         key_type;
+            typedef Key                                         value_type;
+            typedef KeyComparator                               key_compare;
+            typedef KeyComparator                               value_compare;
+            typedef KeyAllocator                                allocator_type;
+            typedef btree_set<key_type, key_compare, allocator_type, TargetNodeSize>
+                                                                self_type;
+            typedef value_type&                                 reference;
+            typedef const value_type&                           const_reference;
+            typedef typename allocator_type::pointer            pointer;
+            typedef typename allocator_type::const_pointer      const_pointer;
+            typedef typename allocator_type::size_type          size_type;
+            typedef typename allocator_type::difference_type    difference_type;
+
+            // 内部btree
+            typedef ft::btree<value_type, key_compare, allocator_type, TargetNodeSize>
+                                                                base;
+            typedef typename base::const_iterator               const_iterator;
+            typedef const_iterator                              iterator;
+            typedef ft::reverse_iterator<iterator>              reverse_iterator;
+            typedef ft::reverse_iterator<const_iterator>        const_reverse_iterator;
+
+        FT_PRIVATE:
+
+            // 内部btree
+            base    tree_;
+
+        public:
+
+            // [[コンストラクタ群]]
+
+            btree_set(): tree_(KeyComparator(), KeyAllocator()) {}
+
+            explicit btree_set(
+                const KeyComparator& comp
+            ): tree_(comp, KeyAllocator()) {}
+
+            explicit btree_set(
+                const KeyComparator& comp,
+                const KeyAllocator& alloc
+            ): tree_(comp, alloc) {}
+
+            template <class InputIterator>
+            btree_set(InputIterator first,
+                InputIterator last,
+                const KeyComparator& comp = KeyComparator(),
+                const KeyAllocator& alloc = KeyAllocator()
+            ): tree_(comp, alloc) {
+                insert(first, last);
+            }
+
+            // [first, last) がソート済みかつ重複なしであれば, 線形時間で構築する。
+            template <class InputIterator>
+            btree_set(ft::sorted_unique_t,
+                InputIterator first,
+                InputIterator last,
+                const KeyComparator& comp = KeyComparator(),
+                const KeyAllocator& alloc = KeyAllocator()
+            ): tree_(comp, alloc) {
+                insert(ft::sorted_unique, first, last);
+            }
+
+            btree_set(const self_type& other)
+                : tree_(other.tree_) {}
+
+            ~btree_set() {}
+
+            self_type&      operator=(const self_type& rhs) {
+                if (this == &rhs) { return *this; }
+                tree_ = rhs.tree_;
+                return *this;
+            }
+
+            allocator_type  get_allocator() const {
+                return allocator_type(tree_.get_allocator());
+            }
+
+            iterator                begin() const { return tree_.begin(); }
+            iterator                end() const { return tree_.end(); }
+            reverse_iterator        rbegin() const { return reverse_iterator(end()); }
+            reverse_iterator        rend() const { return reverse_iterator(begin()); }
+
+            bool            empty() const { return tree_.empty(); }
+            size_type       size() const { return tree_.size(); }
+            size_type       max_size() const { return tree_.max_size(); }
+
+            void            clear() { tree_.clear(); }
+
+            // [[挿入系関数群]]
+            pair<iterator, bool>    insert(const value_type& v) {
+                pair<typename base::iterator, bool> result = tree_.insert(v);
+                return ft::make_pair(iterator(result.first), result.second);
+            }
+            iterator                insert(const_iterator hint, const value_type& v) {
+                return tree_.insert(hint, v);
+            }
+            template <class InputIterator>
+            void                    insert(InputIterator first, InputIterator last) {
+                tree_.insert(first, last);
+            }
+            // [first, last) がソート済みかつ重複なしであることを呼び出し側が保証する範囲挿入。
+            template <class InputIterator>
+            void                    insert(ft::sorted_unique_t, InputIterator first, InputIterator last) {
+                tree_.insert(ft::sorted_unique, first, last);
+            }
+
+            // [[削除]]
+            // 次の要素を指すイテレータを返す(削除で他のイテレータは無効になるので)。
+            iterator     erase(const_iterator position) {
+                return tree_.erase(position);
+            }
+            size_type    erase(const key_type& x) {
+                return tree_.erase_by_key(x);
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, size_type, const_iterator>::type
+                         erase(const K& x) {
+                return tree_.erase_by_key(x);
+            }
+            void         erase(const_iterator first, const_iterator last) {
+                tree_.erase(first, last);
+            }
+
+            void         swap(self_type& other) {
+                tree_.swap(other.tree_);
+            }
+
+            // [[検索系関数]]
+
+            size_type       count(const key_type& x) const {
+                return tree_.count(x);
+            }
+
+            const_iterator  find(const key_type& x) const {
+                return tree_.find(x);
+            }
+
+            pair<const_iterator, const_iterator>    equal_range(const key_type& x) const {
+                return tree_.equal_range(x);
+            }
+
+            const_iterator                          lower_bound(const key_type& x) const {
+                return tree_.lower_bound(x);
+            }
+
+            const_iterator                          upper_bound(const key_type& x) const {
+                return tree_.upper_bound(x);
+            }
+
+            // [[ヒントつき検索]]
+
+            const_iterator                          lower_bound(const_iterator hint, const key_type& x) const {
+                return tree_.lower_bound(hint, x);
+            }
+
+            const_iterator                          find(const_iterator hint, const key_type& x) const {
+                return tree_.find(hint, x);
+            }
+
+            // [[一括検索]]
+
+            template <class InputIterator, class OutputIterator>
+            OutputIterator          find_sorted(InputIterator first, InputIterator last, OutputIterator out) {
+                return tree_.find_sorted(first, last, out);
+            }
+
+            // [[異種キーでの検索]]
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, size_type>::type
+                                                    count(const K& x) const {
+                return tree_.count(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    find(const K& x) const {
+                return tree_.find(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, pair<const_iterator, const_iterator> >::type
+                                                    equal_range(const K& x) const {
+                return tree_.equal_range(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    lower_bound(const K& x) const {
+                return tree_.lower_bound(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    upper_bound(const K& x) const {
+                return tree_.upper_bound(x);
+            }
+
+            key_compare     key_comp() const {
+                return tree_.value_compare();
+            }
+
+            value_compare   value_comp() const {
+                return key_comp();
+            }
+
+            // 内部構造が正しいか(テスト用)
+            bool            debug_valid() const {
+                return tree_.debug_valid();
+            }
+    };
+
+    // [比較演算子]
+
+    template <class Key, class KeyComparator, class KeyAllocator, std::size_t N>
+    inline bool operator==(
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& lhs,
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& rhs
+    ) {
+        return lhs.size() == rhs.size()
+            && ft::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class Key, class KeyComparator, class KeyAllocator, std::size_t N>
+    inline bool operator!=(
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& lhs,
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& rhs
+    ) {
+        return !(lhs == rhs);
+    }
+
+    template <class Key, class KeyComparator, class KeyAllocator, std::size_t N>
+    inline bool operator<(
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& lhs,
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& rhs
+    ) {
+        return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class Key, class KeyComparator, class KeyAllocator, std::size_t N>
+    inline bool operator<=(
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& lhs,
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& rhs
+    ) {
+        return !(lhs > rhs);
+    }
+
+    template <class Key, class KeyComparator, class KeyAllocator, std::size_t N>
+    inline bool operator>(
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& lhs,
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& rhs
+    ) {
+        return rhs < lhs;
+    }
+
+    template <class Key, class KeyComparator, class KeyAllocator, std::size_t N>
+    inline bool operator>=(
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& lhs,
+        const ft::btree_set<Key, KeyComparator, KeyAllocator, N>& rhs
+    ) {
+        return !(lhs < rhs);
+    }
+}
+
+namespace std {
+    template <class Key, class KeyComparator, class KeyAllocator, std::size_t N>
+    inline void swap(
+        ft::btree_set<Key, KeyComparator, KeyAllocator, N>& lhs,
+        ft::btree_set<Key, KeyComparator, KeyAllocator, N>& rhs
+    ) {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
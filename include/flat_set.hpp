@@ -0,0 +1,347 @@
+#ifndef FLAT_SET_HPP
+# define FLAT_SET_HPP
+# include "flat_tree.hpp"
+# include "pair.hpp"
+# include "ft_algorithm.hpp"
+
+namespace ft {
+
+    // [flat_set]
+    // ft::set と同じインターフェースを持つ, ソート済みの ft::vector を使ったset。
+    // ft::set との違いは flat_map と同じ。
+    template <
+        class Key,
+        class KeyComparator = std::less<Key>,
+        class KeyAllocator = std::allocator<Key>
+    >
+    class flat_set {
+        public:
+            typedef Key                                         key_type;
+            typedef Key                                         value_type;
+            typedef KeyComparator                               key_compare;
+            typedef KeyComparator                               value_compare;
+            typedef KeyAllocator                                allocator_type;
+            typedef flat_set<key_type, key_compare, allocator_type>
+                                                                self_type;
+            typedef value_type&                                 reference;
+            typedef const value_type&                           const_reference;
+            typedef typename allocator_type::pointer            pointer;
+            typedef typename allocator_type::const_pointer      const_pointer;
+            typedef typename allocator_type::size_type          size_type;
+            typedef typename allocator_type::difference_type    difference_type;
+
+            // 内部flat_tree
+            typedef ft::flat_tree<
+                value_type, typename ft::remove_const<value_type>::type, key_compare, allocator_type
+            >                                                   base;
+            typedef typename base::const_iterator               const_iterator;
+            typedef const_iterator                              iterator;
+            typedef ft::reverse_iterator<iterator>              reverse_iterator;
+            typedef ft::reverse_iterator<const_iterator>        const_reverse_iterator;
+
+        FT_PRIVATE:
+
+            // 内部flat_tree
+            base    tree_;
+
+        public:
+
+            // [[コンストラクタ群]]
+
+            flat_set(): tree_(KeyComparator(), KeyAllocator()) {}
+
+            explicit flat_set(
+                const KeyComparator& comp
+            ): tree_(comp, KeyAllocator()) {}
+
+            explicit flat_set(
+                const KeyComparator& comp,
+                const KeyAllocator& alloc
+            ): tree_(comp, alloc) {}
+
+            template <class InputIterator>
+            flat_set(InputIterator first,
+                InputIterator last,
+                const KeyComparator& comp = KeyComparator(),
+                const KeyAllocator& alloc = KeyAllocator()
+            ): tree_(comp, alloc) {
+                insert(first, last);
+            }
+
+            // [first, last) がソート済みかつ重複なしであれば, 線形時間で構築する。
+            template <class InputIterator>
+            flat_set(ft::sorted_unique_t,
+                InputIterator first,
+                InputIterator last,
+                const KeyComparator& comp = KeyComparator(),
+                const KeyAllocator& alloc = KeyAllocator()
+            ): tree_(comp, alloc) {
+                insert(ft::sorted_unique, first, last);
+            }
+
+            flat_set(const self_type& other)
+                : tree_(other.tree_) {}
+
+            ~flat_set() {}
+
+            self_type&      operator=(const self_type& rhs) {
+                if (this == &rhs) { return *this; }
+                tree_ = rhs.tree_;
+                return *this;
+            }
+
+            allocator_type  get_allocator() const {
+                return allocator_type(tree_.get_allocator());
+            }
+
+            iterator                begin() const { return tree_.begin(); }
+            iterator                end() const { return tree_.end(); }
+            reverse_iterator        rbegin() const { return reverse_iterator(end()); }
+            reverse_iterator        rend() const { return reverse_iterator(begin()); }
+
+            bool            empty() const { return tree_.empty(); }
+            size_type       size() const { return tree_.size(); }
+            size_type       max_size() const { return tree_.max_size(); }
+            size_type       capacity() const { return tree_.capacity(); }
+
+            void            clear() { tree_.clear(); }
+
+            // n 要素分の領域を確保しておく(範囲挿入の前など)。
+            void            reserve(size_type n) { tree_.reserve(n); }
+
+            // [[挿入系関数群]]
+            pair<iterator, bool>    insert(const value_type& v) {
+                pair<typename base::iterator, bool> result = tree_.insert(v);
+                return ft::make_pair(iterator(result.first), result.second);
+            }
+            iterator                insert(const_iterator hint, const value_type& v) {
+                return tree_.insert(hint, v);
+            }
+            // 末尾にまとめて追加してから, ソートして既存の要素とマージする。
+            template <class InputIterator>
+            void                    insert(InputIterator first, InputIterator last) {
+                tree_.insert(first, last);
+            }
+            // [first, last) がソート済みかつ重複なしであることを呼び出し側が保証する範囲挿入。
+            // 既存の要素より大きいキーばかりなら, 末尾に追加するだけ。
+            template <class InputIterator>
+            void                    insert(ft::sorted_unique_t, InputIterator first, InputIterator last) {
+                tree_.insert(ft::sorted_unique, first, last);
+            }
+
+            // [[削除]]
+            // 次の要素を指すイテレータを返す(削除で他のイテレータは無効になるので)。
+            iterator     erase(const_iterator position) {
+                return tree_.erase(position);
+            }
+            size_type    erase(const key_type& x) {
+                return tree_.erase_by_key(x);
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, size_type, const_iterator>::type
+                         erase(const K& x) {
+                return tree_.erase_by_key(x);
+            }
+            iterator     erase(const_iterator first, const_iterator last) {
+                return tree_.erase(first, last);
+            }
+
+            void         swap(self_type& other) {
+                tree_.swap(other.tree_);
+            }
+
+            // [[分割・連結]]
+
+            // key 以上の要素をすべて out に移す。out の元の要素は破棄される。
+            void         split(const key_type& key, self_type& out) {
+                tree_.split(key, out.tree_);
+            }
+
+            // other の要素をすべて this に移し, other を空にする。
+            // キーの範囲が重ならなければ, 末尾に追加するだけ。
+            void         join(self_type& other) {
+                tree_.join(other.tree_);
+            }
+
+            // [[検索系関数]]
+
+            size_type       count(const key_type& x) const {
+                return tree_.count(x);
+            }
+
+            const_iterator  find(const key_type& x) const {
+                return tree_.find(x);
+            }
+
+            pair<const_iterator, const_iterator>    equal_range(const key_type& x) const {
+                return tree_.equal_range(x);
+            }
+
+            const_iterator                          lower_bound(const key_type& x) const {
+                return tree_.lower_bound(x);
+            }
+
+            const_iterator                          upper_bound(const key_type& x) const {
+                return tree_.upper_bound(x);
+            }
+
+            // [[ヒントつき検索]]
+
+            const_iterator                          lower_bound(const_iterator hint, const key_type& x) const {
+                return tree_.lower_bound(hint, x);
+            }
+
+            const_iterator                          find(const_iterator hint, const key_type& x) const {
+                return tree_.find(hint, x);
+            }
+
+            // [[一括検索]]
+
+            template <class InputIterator, class OutputIterator>
+            OutputIterator          find_sorted(InputIterator first, InputIterator last, OutputIterator out) {
+                return tree_.find_sorted(first, last, out);
+            }
+            template <class InputIterator, class OutputIterator>
+            OutputIterator          find_sorted(InputIterator first, InputIterator last, OutputIterator out) const {
+                return tree_.find_sorted(first, last, out);
+            }
+
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+                return tree_.template find_batch<Width>(first, last, out);
+            }
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+                return tree_.template find_batch<Width>(first, last, out);
+            }
+            // 幅を指定しない場合は8
+            template <class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+                return find_batch<8>(first, last, out);
+            }
+            template <class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+                return find_batch<8>(first, last, out);
+            }
+
+            // [[異種キーでの検索]]
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, size_type>::type
+                                                    count(const K& x) const {
+                return tree_.count(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    find(const K& x) const {
+                return tree_.find(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, pair<const_iterator, const_iterator> >::type
+                                                    equal_range(const K& x) const {
+                return tree_.equal_range(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    lower_bound(const K& x) const {
+                return tree_.lower_bound(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    upper_bound(const K& x) const {
+                return tree_.upper_bound(x);
+            }
+
+            // [[順序統計]]
+
+            // x より小さいキーを持つ要素の数
+            size_type                               rank(const key_type& x) const {
+                return tree_.rank(x);
+            }
+
+            // 先頭から i 番目(0始まり)の要素を返す。i >= size() なら end()。
+            const_iterator                          nth(size_type i) const {
+                return tree_.select(i);
+            }
+
+            // first から last までの要素数 (std::distance と同じ結果)
+            difference_type                         distance(const_iterator first, const_iterator last) const {
+                return tree_.distance(first, last);
+            }
+
+            key_compare     key_comp() const {
+                return tree_.value_compare();
+            }
+
+            value_compare   value_comp() const {
+                return key_comp();
+            }
+    };
+
+    // [比較演算子]
+
+    template <class Key, class KeyComparator, class KeyAllocator>
+    inline bool operator==(
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& lhs,
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& rhs
+    ) {
+        return lhs.size() == rhs.size()
+            && ft::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class Key, class KeyComparator, class KeyAllocator>
+    inline bool operator!=(
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& lhs,
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& rhs
+    ) {
+        return !(lhs == rhs);
+    }
+
+    template <class Key, class KeyComparator, class KeyAllocator>
+    inline bool operator<(
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& lhs,
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& rhs
+    ) {
+        return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class Key, class KeyComparator, class KeyAllocator>
+    inline bool operator<=(
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& lhs,
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& rhs
+    ) {
+        return !(lhs > rhs);
+    }
+
+    template <class Key, class KeyComparator, class KeyAllocator>
+    inline bool operator>(
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& lhs,
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& rhs
+    ) {
+        return rhs < lhs;
+    }
+
+    template <class Key, class KeyComparator, class KeyAllocator>
+    inline bool operator>=(
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& lhs,
+        const ft::flat_set<Key, KeyComparator, KeyAllocator>& rhs
+    ) {
+        return !(lhs < rhs);
+    }
+}
+
+namespace std {
+    template <class Key, class KeyComparator, class KeyAllocator>
+    inline void swap(
+        ft::flat_set<Key, KeyComparator, KeyAllocator>& lhs,
+        ft::flat_set<Key, KeyComparator, KeyAllocator>& rhs
+    ) {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
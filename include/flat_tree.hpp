@@ -0,0 +1,560 @@
+#ifndef FLAT_TREE_HPP
+# define FLAT_TREE_HPP
+
+# include "ft_common.hpp"
+# include "ft_meta_functions.hpp"
+# include "ft_iterator.hpp"
+# include "iterator_wrapper.hpp"
+# include "pair.hpp"
+# include "vector.hpp"
+# include "tree.hpp"
+# include <memory>
+# include <cstddef>
+
+namespace ft {
+
+    // flat_tree
+    // 値をソート済みの ft::vector に並べて持つ, 探索木の代わりの連続配列。
+    // 赤黒木(tree)と比べて
+    // - 値ごとのポインタがなく, 値が隙間なく並ぶので, 要素あたりのメモリが小さく走査が速い。
+    // - 探索は配列上の二分探索で, 比較の結果で分岐しない(条件付き代入になる)。
+    // - 途中への挿入・削除は後ろの値をずらすので O(n)。
+    //   範囲挿入は末尾に追加してからソート・マージするので, まとめて入れれば速い。
+    // - 挿入・削除はすべてのイテレータ・参照・ポインタを無効にする。
+    // 読み込み中心の用途向け。キーの重複は許さない(flat_map, flat_set 用)。
+    template <
+        // 公開する値の型
+        // - flat_map<MK, MV, MKC, MA>  -> pair<const MK, MV>
+        // - flat_set<SK, SKC, SA>      -> SK
+        class Value,
+        // 配列に実際に載る値の型
+        // ずらす・並べ替えるのに代入するので, const を外したもの。
+        // (Value と同じ配置であること)
+        // - flat_map<MK, MV, MKC, MA>  -> pair<MK, MV>
+        // - flat_set<SK, SKC, SA>      -> SK
+        class StoredValue,
+        // Valueのコンパレータ(tree と同じ)
+        class ValueComparator = std::less<Value>,
+        // Valueのアロケータ(StoredValue 用に rebind して使う)
+        class ValueAllocator = std::allocator<Value>
+    >
+    class flat_tree {
+        public:
+            typedef Value                                               value_type;
+            typedef StoredValue                                         stored_type;
+            typedef ValueComparator                                     value_comparator_type;
+            typedef typename ValueAllocator::template rebind<StoredValue>::other
+                                                                        stored_allocator_type;
+            typedef ft::vector<stored_type, stored_allocator_type>      container_type;
+            typedef flat_tree<Value, StoredValue, ValueComparator, ValueAllocator>
+                                                                        self_type;
+            typedef value_type&                                         reference;
+            typedef const value_type&                                   const_reference;
+            typedef value_type*                                         pointer;
+            typedef const value_type*                                   const_pointer;
+            typedef typename container_type::size_type                  size_type;
+            typedef typename container_type::difference_type            difference_type;
+            typedef ft::iterator_wrapper<pointer>                       iterator;
+            typedef ft::iterator_wrapper<const_pointer>                 const_iterator;
+
+        FT_PRIVATE:
+
+            // ソート済みの値の配列
+            container_type          values_;
+            value_comparator_type   value_compare_;
+
+            // 配列上の値を公開する型として見る
+            static pointer          as_value_(stored_type* p) {
+                return reinterpret_cast<pointer>(p);
+            }
+            static const_pointer    as_value_(const stored_type* p) {
+                return reinterpret_cast<const_pointer>(p);
+            }
+
+            stored_type*            stored_() {
+                return values_.begin().base();
+            }
+            const stored_type*      stored_() const {
+                return values_.begin().base();
+            }
+
+            bool    less_(const stored_type& x, const stored_type& y) const {
+                return value_compare_(*as_value_(&x), *as_value_(&y));
+            }
+
+        public:
+
+            // [[コンストラクタ群]]
+
+            flat_tree(
+                const value_comparator_type& comp,
+                const ValueAllocator& allocator
+            ): values_(stored_allocator_type(allocator)), value_compare_(comp) {}
+
+            flat_tree(const self_type& other)
+                : values_(other.values_), value_compare_(other.value_compare_) {}
+
+            ~flat_tree() {}
+
+            self_type&  operator=(const self_type& rhs) {
+                if (this == &rhs) { return *this; }
+                values_ = rhs.values_;
+                value_compare_ = rhs.value_compare_;
+                return *this;
+            }
+
+            // [[getter群]]
+
+            stored_allocator_type   get_allocator() const {
+                return values_.get_allocator();
+            }
+
+            const value_comparator_type&    value_compare() const {
+                return value_compare_;
+            }
+
+            iterator        begin() { return iterator(as_value_(stored_())); }
+            const_iterator  begin() const { return const_iterator(as_value_(stored_())); }
+            iterator        end() { return begin() + size(); }
+            const_iterator  end() const { return begin() + size(); }
+
+            bool            empty() const { return values_.empty(); }
+            size_type       size() const { return values_.size(); }
+            size_type       max_size() const { return values_.max_size(); }
+            size_type       capacity() const { return values_.capacity(); }
+
+            void            reserve(size_type n) { values_.reserve(n); }
+
+            void            clear() { values_.clear(); }
+
+            void            swap(self_type& other) {
+                values_.swap(other.values_);
+                ft::swap(value_compare_, other.value_compare_);
+            }
+
+            // [[挿入]]
+
+            pair<iterator, bool>    insert(const value_type& v) {
+                size_type   i = lower_index_in_(stored_(), size(), v);
+                if (i < size() && !value_compare_(v, *as_value_(stored_() + i))) {
+                    return ft::make_pair(begin() + i, false);
+                }
+                values_.insert(values_.begin() + i, stored_type(v));
+                return ft::make_pair(begin() + i, true);
+            }
+
+            // hint の位置から前後に幅を倍々にして挿入位置を探す。
+            // hint が正しければ O(1) で位置が決まる(ずらすのは O(n))。
+            iterator                insert(const_iterator hint, const value_type& v) {
+                size_type   i = gallop_(stored_(), size(), hint - begin(), v);
+                if (i < size() && !value_compare_(v, *as_value_(stored_() + i))) {
+                    return begin() + i;
+                }
+                values_.insert(values_.begin() + i, stored_type(v));
+                return begin() + i;
+            }
+
+            // 末尾にまとめて追加してから, 追加分をソートして既存の値とマージする。
+            // 同じキーが複数あれば, 既存の値・範囲の前の方の値が残る。
+            // (値の代入が例外を投げた場合は, 基本保証のみ)
+            template <class InputIterator>
+            void                    insert(InputIterator first, InputIterator last) {
+                size_type   n = size();
+                values_.insert(values_.end(), first, last);
+                merge_tail_(n, false);
+            }
+
+            // [first, last) がソート済みかつ重複なしであることを呼び出し側が保証する範囲挿入。
+            // ソートを省く。既存の値のすべてより大きければ, 追加するだけ。
+            template <class InputIterator>
+            void                    insert(sorted_unique_t, InputIterator first, InputIterator last) {
+                size_type   n = size();
+                values_.insert(values_.end(), first, last);
+                merge_tail_(n, true);
+            }
+
+            // [[削除]]
+
+            // 次の要素を指すイテレータを返す。
+            iterator    erase(const_iterator position) {
+                size_type   i = position - begin();
+                values_.erase(values_.begin() + i);
+                return begin() + i;
+            }
+
+            iterator    erase(const_iterator first, const_iterator last) {
+                size_type   i = first - begin();
+                size_type   j = last - begin();
+                values_.erase(values_.begin() + i, values_.begin() + j);
+                return begin() + i;
+            }
+
+            template <class Key>
+            size_type   erase_by_key(const Key& key) {
+                iterator    it = find(key);
+                if (it == end()) {
+                    return 0;
+                }
+                erase(it);
+                return 1;
+            }
+
+            // [[分割・連結]]
+
+            // key 以上の値をすべて out に移す。out の元の値は破棄される。
+            template <class Key>
+            void        split(const Key& key, self_type& out) {
+                if (&out == this) { return; }
+                size_type   i = lower_index_in_(stored_(), size(), key);
+                out.values_.assign(values_.begin() + i, values_.end());
+                values_.erase(values_.begin() + i, values_.end());
+            }
+
+            // other の値をすべて this に移し, other を空にする。
+            // 同じキーがあれば this の値が残る。
+            // キーの範囲が重ならなければ, 追加するだけ。
+            void        join(self_type& other) {
+                if (&other == this || other.empty()) { return; }
+                if (empty()) {
+                    values_.swap(other.values_);
+                    return;
+                }
+                size_type   n = size();
+                values_.insert(values_.end(), other.values_.begin(), other.values_.end());
+                other.clear();
+                merge_tail_(n, true);
+            }
+
+            // [[検索系]]
+
+            template <class Key>
+            iterator        lower_bound(const Key& key) {
+                return begin() + lower_index_in_(stored_(), size(), key);
+            }
+            template <class Key>
+            const_iterator  lower_bound(const Key& key) const {
+                return begin() + lower_index_in_(stored_(), size(), key);
+            }
+
+            template <class Key>
+            iterator        upper_bound(const Key& key) {
+                return begin() + upper_index_in_(stored_(), size(), key);
+            }
+            template <class Key>
+            const_iterator  upper_bound(const Key& key) const {
+                return begin() + upper_index_in_(stored_(), size(), key);
+            }
+
+            template <class Key>
+            iterator        find(const Key& key) {
+                return found_(lower_index_in_(stored_(), size(), key), key);
+            }
+            template <class Key>
+            const_iterator  find(const Key& key) const {
+                return const_cast<self_type*>(this)->find(key);
+            }
+
+            template <class Key>
+            size_type       count(const Key& key) const {
+                return find(key) == end() ? 0 : 1;
+            }
+
+            template <class Key>
+            pair<iterator, iterator>    equal_range(const Key& key) {
+                iterator    first = lower_bound(key);
+                iterator    last = first;
+                if (last != end() && !value_compare_(key, *last)) {
+                    ++last;
+                }
+                return ft::make_pair(first, last);
+            }
+            template <class Key>
+            pair<const_iterator, const_iterator>    equal_range(const Key& key) const {
+                pair<iterator, iterator>    r = const_cast<self_type*>(this)->equal_range(key);
+                return ft::make_pair(const_iterator(r.first), const_iterator(r.second));
+            }
+
+            // [[ヒントつき検索]]
+            // hint から前後に幅を倍々にして範囲を絞ってから二分探索する。
+            // hint と結果の距離を d として O(log d)。
+
+            template <class Key>
+            iterator        lower_bound(const_iterator hint, const Key& key) {
+                return begin() + gallop_(stored_(), size(), hint - begin(), key);
+            }
+            template <class Key>
+            const_iterator  lower_bound(const_iterator hint, const Key& key) const {
+                return const_cast<self_type*>(this)->lower_bound(hint, key);
+            }
+
+            template <class Key>
+            iterator        find(const_iterator hint, const Key& key) {
+                return found_(gallop_(stored_(), size(), hint - begin(), key), key);
+            }
+            template <class Key>
+            const_iterator  find(const_iterator hint, const Key& key) const {
+                return const_cast<self_type*>(this)->find(hint, key);
+            }
+
+            // ソート済みのキー列 [first, last) のそれぞれについて find した結果を out に書き出す。
+            // 前の結果から探す。
+            template <class InputIterator, class OutputIterator>
+            OutputIterator  find_sorted(InputIterator first, InputIterator last, OutputIterator out) {
+                size_type   hint = 0;
+                for (; first != last; ++first, ++out) {
+                    hint = gallop_(stored_(), size(), hint, *first);
+                    *out = found_(hint, *first);
+                }
+                return out;
+            }
+            template <class InputIterator, class OutputIterator>
+            OutputIterator  find_sorted(InputIterator first, InputIterator last, OutputIterator out) const {
+                return const_cast<self_type*>(this)->find_sorted(first, last, out);
+            }
+
+            // 順不同のキー列 [first, last) のそれぞれについて find した結果を out に書き出す。
+            // 配列の長さが同じなら二分探索の歩幅の列も同じなので,
+            // Width 個の探索を1段ずつそろえて進め, 次に読む位置をプリフェッチする。
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator  find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+                const stored_type*  values = stored_();
+                const size_type     total = size();
+                ForwardIterator     keys[Width];
+                const stored_type*  bases[Width];
+                while (first != last) {
+                    std::size_t w = 0;
+                    for (; w < Width && first != last; ++w, ++first) {
+                        keys[w] = first;
+                        bases[w] = values;
+                    }
+                    for (size_type n = total; n > 1;) {
+                        size_type   half = n / 2;
+                        n -= half;
+                        for (std::size_t i = 0; i < w; ++i) {
+                            const stored_type*  base = bases[i];
+                            base = value_compare_(*as_value_(base + half), *keys[i]) ? base + half : base;
+                            FT_PREFETCH(base + n / 2);
+                            bases[i] = base;
+                        }
+                    }
+                    for (std::size_t i = 0; i < w; ++i, ++out) {
+                        size_type   j = bases[i] - values;
+                        if (total > 0 && value_compare_(*as_value_(bases[i]), *keys[i])) {
+                            ++j;
+                        }
+                        *out = found_(j, *keys[i]);
+                    }
+                }
+                return out;
+            }
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator  find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+                return const_cast<self_type*>(this)->template find_batch<Width>(first, last, out);
+            }
+
+            // [[順序統計]]
+            // 配列なのでどれも O(1) か O(log n)。
+
+            // key より小さい値の数
+            template <class Key>
+            size_type       rank(const Key& key) const {
+                return lower_index_in_(stored_(), size(), key);
+            }
+
+            // 先頭から i 番目(0始まり)の値。i >= size() なら end()。
+            iterator        select(size_type i) {
+                return i < size() ? begin() + i : end();
+            }
+            const_iterator  select(size_type i) const {
+                return i < size() ? begin() + i : end();
+            }
+
+            difference_type distance(const_iterator first, const_iterator last) const {
+                return last - first;
+            }
+
+        FT_PRIVATE:
+
+            // [[探索の下請け]]
+
+            // [first, first + n) で key 以上の最初の位置
+            // 範囲を半分ずつ狭めるが, 比較の結果は条件付き代入にだけ使う(分岐予測に頼らない)。
+            template <class Key>
+            size_type   lower_index_in_(const stored_type* first, size_type n, const Key& key) const {
+                if (n == 0) { return 0; }
+                const stored_type*  base = first;
+                while (n > 1) {
+                    size_type   half = n / 2;
+                    base = value_compare_(*as_value_(base + half), key) ? base + half : base;
+                    n -= half;
+                }
+                return (base - first) + (value_compare_(*as_value_(base), key) ? 1 : 0);
+            }
+
+            // [first, first + n) で key より大きい最初の位置
+            template <class Key>
+            size_type   upper_index_in_(const stored_type* first, size_type n, const Key& key) const {
+                if (n == 0) { return 0; }
+                const stored_type*  base = first;
+                while (n > 1) {
+                    size_type   half = n / 2;
+                    base = value_compare_(key, *as_value_(base + half)) ? base : base + half;
+                    n -= half;
+                }
+                return (base - first) + (value_compare_(key, *as_value_(base)) ? 0 : 1);
+            }
+
+            // [first, first + n) で key 以上の最初の位置を, hint から探す。
+            // hint から離れる向きに幅を 1, 2, 4, ... と広げて答えを挟んでから二分探索する。
+            template <class Key>
+            size_type   gallop_(const stored_type* first, size_type n, size_type hint, const Key& key) const {
+                if (hint > n) { hint = n; }
+                if (hint < n && value_compare_(*as_value_(first + hint), key)) {
+                    // first[hint] < key なので, 答えは後ろ
+                    size_type   lo = hint + 1;
+                    size_type   hi = lo;
+                    size_type   step = 1;
+                    while (hi < n && value_compare_(*as_value_(first + hi), key)) {
+                        lo = hi + 1;
+                        step *= 2;
+                        hi = n - lo > step ? lo + step : n;
+                    }
+                    // first[lo - 1] < key <= first[hi] (hi == n なら末尾)
+                    return lo + lower_index_in_(first + lo, hi - lo, key);
+                }
+                // key <= first[hint] (hint == n なら末尾) なので, 答えは前
+                size_type   hi = hint;
+                size_type   step = 1;
+                while (hi > 0) {
+                    size_type   lo = hi > step ? hi - step : 0;
+                    if (value_compare_(*as_value_(first + lo), key)) {
+                        // first[lo] < key <= first[hi]
+                        return lo + 1 + lower_index_in_(first + lo + 1, hi - lo - 1, key);
+                    }
+                    hi = lo;
+                    step *= 2;
+                }
+                return 0;
+            }
+
+            // lower_bound の位置 i が key と等しければ i を, そうでなければ end() を返す。
+            template <class Key>
+            iterator    found_(size_type i, const Key& key) {
+                if (i == size() || value_compare_(key, *as_value_(stored_() + i))) {
+                    return end();
+                }
+                return begin() + i;
+            }
+
+            // [[範囲挿入の下請け]]
+
+            // [n, size()) に追加された値を, ソート済みの [0, n) とマージする。
+            // sorted なら, 追加分はソート済みかつ重複なし。
+            void        merge_tail_(size_type n, bool sorted) {
+                if (size() == n) { return; }
+                container_type  buffer(values_.get_allocator());
+                stored_type*    values = stored_();
+                if (!sorted) {
+                    buffer.assign(values_.begin() + n, values_.end());
+                    sort_(values + n, buffer.begin().base(), size() - n);
+                }
+                // 追加分から, 追加分の中での重複と既存のキーを除いて前に詰める。
+                // (追加分はソート済みなので, 既存の配列は前の位置から探せばよい)
+                size_type   kept = n;
+                size_type   hint = 0;
+                for (size_type i = n; i < size(); ++i) {
+                    if (kept > n && !less_(values[kept - 1], values[i])) {
+                        continue;
+                    }
+                    if (n > 0) {
+                        hint = gallop_(values, n, hint, *as_value_(values + i));
+                        if (hint < n && !less_(values[i], values[hint])) {
+                            continue;
+                        }
+                    }
+                    if (kept != i) {
+                        values[kept] = values[i];
+                    }
+                    ++kept;
+                }
+                values_.erase(values_.begin() + kept, values_.end());
+                if (kept == n || n == 0 || less_(values[n - 1], values[n])) {
+                    // 既存の値のすべてより大きい(追加するだけでよい)
+                    return;
+                }
+                // 追加分を作業領域に移し, 後ろから大きい方を詰めていく。
+                // 書き込み位置は読み込み位置を追い越さない。
+                buffer.assign(values_.begin() + n, values_.end());
+                const stored_type*  added = buffer.begin().base();
+                size_type   i = n;
+                size_type   j = kept - n;
+                size_type   d = kept;
+                while (j > 0) {
+                    if (i > 0 && less_(added[j - 1], values[i - 1])) {
+                        values[--d] = values[--i];
+                    } else {
+                        values[--d] = added[--j];
+                    }
+                }
+            }
+
+            // [first, first + n) を安定ソートする。buffer は n 要素の構築済みの作業領域。
+            // 短い区間を挿入ソートしてから, buffer との間で交互にマージする。
+            void        sort_(stored_type* first, stored_type* buffer, size_type n) {
+                const size_type run = 16;
+                for (size_type i = 0; i < n; i += run) {
+                    insertion_sort_(first + i, n - i < run ? n - i : run);
+                }
+                stored_type*    from = first;
+                stored_type*    to = buffer;
+                for (size_type width = run; width < n; width *= 2) {
+                    for (size_type i = 0; i < n; i += 2 * width) {
+                        size_type   mid = n - i < width ? n : i + width;
+                        size_type   last = n - i < 2 * width ? n : i + 2 * width;
+                        merge_(from + i, from + mid, from + mid, from + last, to + i);
+                    }
+                    stored_type*    tmp = from;
+                    from = to;
+                    to = tmp;
+                }
+                if (from != first) {
+                    for (size_type i = 0; i < n; ++i) {
+                        first[i] = from[i];
+                    }
+                }
+            }
+
+            void        insertion_sort_(stored_type* first, size_type n) {
+                for (size_type i = 1; i < n; ++i) {
+                    if (!less_(first[i], first[i - 1])) {
+                        continue;
+                    }
+                    stored_type x(first[i]);
+                    size_type   j = i;
+                    for (; j > 0 && less_(x, first[j - 1]); --j) {
+                        first[j] = first[j - 1];
+                    }
+                    first[j] = x;
+                }
+            }
+
+            // 等しい値は左側を先に出す(安定)
+            void        merge_(
+                const stored_type* l, const stored_type* l_last,
+                const stored_type* r, const stored_type* r_last,
+                stored_type* out
+            ) {
+                while (l != l_last && r != r_last) {
+                    if (less_(*r, *l)) {
+                        *out++ = *r++;
+                    } else {
+                        *out++ = *l++;
+                    }
+                }
+                for (; l != l_last; ++l) { *out++ = *l; }
+                for (; r != r_last; ++r) { *out++ = *r; }
+            }
+    };
+}
+
+#endif
@@ -2,20 +2,135 @@
 # define FT_ALGORITHM_HPP
 # include "ft_common.hpp"
 # include "ft_iterator.hpp"
+# include "iterator_wrapper.hpp"
 # include <algorithm>
 # include <iterator>
+# include <cstring>
 
 namespace ft {
 
     // [[swap]]
 
+    // C++11 モードではムーブで入れ替える。
     template<class T>
     inline void swap(T& a, T& b) {
-        T temp(a);
-        a = b;
-        b = temp;
+        T temp(FT_MOVE(a));
+        a = FT_MOVE(b);
+        b = FT_MOVE(temp);
     }
 
+    // [[連続した領域の算術型のためのカーネル]]
+    // memset / memcmp / memcpy (libc の SIMD 実装)にまとめて任せる。
+
+    // [first, first + n) に value を入れる(T は算術型かポインタ)。
+    // 全バイトが同じ値なら memset, そうでなければ, 埋めた部分を倍々に memcpy で複製する
+    // (複製元はキャッシュに載る大きさまでにする)。
+    template <class T>
+    inline void fill_n_trivial_(T* first, std::size_t n, const T& value) {
+        // value が埋める範囲の中にあってもいいように, 先にコピーしておく
+        const T v(value);
+        if (n < 16) {
+            for (std::size_t i = 0; i < n; ++i) {
+                first[i] = v;
+            }
+            return;
+        }
+        unsigned char   bytes[sizeof(T)];
+        std::memcpy(bytes, &v, sizeof(T));
+        bool            same = true;
+        for (std::size_t k = 1; k < sizeof(T); ++k) {
+            same = same && bytes[k] == bytes[0];
+        }
+        if (same) {
+            std::memset(first, bytes[0], n * sizeof(T));
+            return;
+        }
+        const std::size_t   max_chunk = 4096 / sizeof(T) + 1;
+        first[0] = v;
+        std::size_t filled = 1;
+        while (filled < n) {
+            std::size_t chunk = filled < max_chunk ? filled : max_chunk;
+            if (chunk > n - filled) { chunk = n - filled; }
+            std::memcpy(first + filled, first, chunk * sizeof(T));
+            filled += chunk;
+        }
+    }
+
+    // [a, a + n) と [b, b + n) で最初に異なる位置(なければ n)。
+    // 整数型用: ブロックごとに memcmp し, 異なるブロックの中だけ1つずつ比べる。
+    template <class T>
+    inline std::size_t mismatch_integral_(const T* a, const T* b, std::size_t n) {
+        const std::size_t   block = 256 / sizeof(T) + 1;
+        std::size_t         i = 0;
+        for (; block <= n - i; i += block) {
+            if (std::memcmp(a + i, b + i, block * sizeof(T)) != 0) {
+                break;
+            }
+        }
+        for (; i < n; ++i) {
+            if (!(a[i] == b[i])) {
+                break;
+            }
+        }
+        return i;
+    }
+
+    // 整数型: memcmp でまとめて比べる
+    template <class T>
+    inline bool equal_arithmetic_(const T* a, const T* b, std::size_t n, ft::true_type) {
+        return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+    }
+    // 浮動小数点数型: memcmp だと 0.0 と -0.0, NaN の扱いが変わるので, ポインタで回す
+    template <class T>
+    inline bool equal_arithmetic_(const T* a, const T* b, std::size_t n, ft::false_type) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!(a[i] == b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class T>
+    inline bool lexicographical_compare_arithmetic_(
+        const T* a, std::size_t na,
+        const T* b, std::size_t nb,
+        ft::true_type
+    ) {
+        const std::size_t   n = na < nb ? na : nb;
+        const std::size_t   i = mismatch_integral_(a, b, n);
+        if (i < n) {
+            return a[i] < b[i];
+        }
+        return na < nb;
+    }
+    template <class T>
+    inline bool lexicographical_compare_arithmetic_(
+        const T* a, std::size_t na,
+        const T* b, std::size_t nb,
+        ft::false_type
+    ) {
+        const std::size_t   n = na < nb ? na : nb;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (a[i] < b[i]) {
+                return true;
+            }
+            if (b[i] < a[i]) {
+                return false;
+            }
+        }
+        return na < nb;
+    }
+
+    // T, U (const 違いはよい)と比較関数の型 V が同じ算術型のときだけ, 戻り値の型 R を持つ
+    template <class T, class U, class V, class R>
+    struct enable_if_same_arithmetic : enable_if<
+        is_arithmetic<V>::value
+        && is_same<typename remove_cv<T>::type, V>::value
+        && is_same<typename remove_cv<U>::type, V>::value,
+        R
+    > {};
+
     // [[equal, 内部関数]]
 
     template <class Iterator1, class Iterator2, class Compare>
@@ -48,6 +163,31 @@ namespace ft {
         return true;
     }
 
+    template <class T, class U, class V>
+    // 算術型のポインタ, 比較は == の場合のequal
+    // -> 整数型なら memcmp, 浮動小数点数型ならポインタで回す
+    inline typename enable_if_same_arithmetic<T, U, V, bool>::type equal_(
+        T* first1, T* last1,
+        U* first2,
+        std::equal_to<V>
+    ) {
+        return equal_arithmetic_<V>(
+            first1, first2, last1 - first1,
+            integral_constant<bool, is_integral<V>::value>()
+        );
+    }
+
+    template <class T, class U, class V>
+    // vector のイテレータ(算術型のポインタを包んだもの)の場合
+    // -> ポインタ版に転送
+    inline typename enable_if_same_arithmetic<T, U, V, bool>::type equal_(
+        ft::iterator_wrapper<T*> first1, ft::iterator_wrapper<T*> last1,
+        ft::iterator_wrapper<U*> first2,
+        std::equal_to<V> comp
+    ) {
+        return equal_(first1.base(), last1.base(), first2.base(), comp);
+    }
+
     template <class Iterator1, class Iterator2, class Compare>
     // compあり, ランダムアクセスイテレータが与えられた場合のequal
     // -> distanceでサイズを算出。サイスが異なるなら問答無用でfalseを返す。
@@ -178,6 +318,7 @@ namespace ft {
     }
 
     // [[lexicographical_compare]]
+    // 比較関数を渡さない場合は, 下の lexicographical_compare_ を経由する。
 
     template <class InputIterator1, class InputIterator2, class Compare>
     inline bool lexicographical_compare(
@@ -196,12 +337,51 @@ namespace ft {
         return first1 == last1 && first2 != last2;
     }
 
+    // [[lexicographical_compare, 内部関数]]
+
+    template <class InputIterator1, class InputIterator2, class Compare>
+    // 一般イテレータ
+    inline bool lexicographical_compare_(
+        InputIterator1 first1, InputIterator1 last1,
+        InputIterator2 first2, InputIterator2 last2,
+        Compare comp
+    ) {
+        return ft::lexicographical_compare(first1, last1, first2, last2, comp);
+    }
+
+    template <class T, class U, class V>
+    // 算術型のポインタ, 比較は < の場合
+    // -> 整数型なら memcmp で最初に異なる位置を探す
+    inline typename enable_if_same_arithmetic<T, U, V, bool>::type lexicographical_compare_(
+        T* first1, T* last1,
+        U* first2, U* last2,
+        std::less<V>
+    ) {
+        return lexicographical_compare_arithmetic_<V>(
+            first1, last1 - first1,
+            first2, last2 - first2,
+            integral_constant<bool, is_integral<V>::value>()
+        );
+    }
+
+    template <class T, class U, class V>
+    // vector のイテレータの場合 -> ポインタ版に転送
+    inline typename enable_if_same_arithmetic<T, U, V, bool>::type lexicographical_compare_(
+        ft::iterator_wrapper<T*> first1, ft::iterator_wrapper<T*> last1,
+        ft::iterator_wrapper<U*> first2, ft::iterator_wrapper<U*> last2,
+        std::less<V> comp
+    ) {
+        return lexicographical_compare_(first1.base(), last1.base(), first2.base(), last2.base(), comp);
+    }
+
+    // [[lexicographical_compare, インターフェース]]
+
     template <class InputIterator1, class InputIterator2>
     inline bool lexicographical_compare(
         InputIterator1 first1, InputIterator1 last1,
         InputIterator2 first2, InputIterator2 last2
     ) {
-        return ft::lexicographical_compare(
+        return lexicographical_compare_(
             first1, last1,
             first2, last2,
             std::less< typename ft::iterator_traits<InputIterator1>::value_type >()
@@ -8,5 +8,30 @@
 # include <stdexcept>
 # define FT_PRIVATE private
 # define FT_NOEXCEPT throw()
+// C++11 モード(make CXX11=1 -> -std=c++11 -D FT_CXX11=1)
+// ムーブ構築・ムーブ代入, emplace 系の関数, 再確保時のムーブを有効にする。
+// C++98 のインターフェースはそのまま残る。
+// - FT_MOVE(x):              ムーブしてよい要素を渡すとき(C++98 ではコピー)
+// - FT_MOVE_IF_NOEXCEPT(x):  再確保で要素を移すとき。
+//                            ムーブが例外を投げうるならコピーする(強い保証を保つため)。
+# ifdef FT_CXX11
+#  if __cplusplus < 201103L
+#   error "FT_CXX11 requires -std=c++11 or later"
+#  endif
+#  include <utility>
+#  include <type_traits>
+#  define FT_MOVE(x) std::move(x)
+#  define FT_MOVE_IF_NOEXCEPT(x) std::move_if_noexcept(x)
+# else
+#  define FT_MOVE(x) (x)
+#  define FT_MOVE_IF_NOEXCEPT(x) (x)
+# endif
+// 読み込み用のソフトウェアプリフェッチ
+// GCC / Clang 以外では何もしない。
+# if defined(__GNUC__)
+#  define FT_PREFETCH(addr) __builtin_prefetch((addr))
+# else
+#  define FT_PREFETCH(addr) ((void)(addr))
+# endif
 
 #endif
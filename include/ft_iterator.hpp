@@ -1,6 +1,8 @@
 #ifndef FT_ITERATOR_HPP
 # define FT_ITERATOR_HPP
 # include "ft_meta_functions.hpp"
+# include <cstddef>
+# include <iterator>
 
 namespace ft {
     // [[iterator_traits]]
@@ -88,7 +90,7 @@ namespace ft {
 
     template <class T>
     struct iterator_traits<T*, false> {
-        typedef ptrdiff_t                       difference_type; // ポインタの差はptr_diff_t
+        typedef std::ptrdiff_t                  difference_type; // ポインタの差はptr_diff_t
         typedef T                               value_type;
         typedef T*                              pointer;
         typedef T&                              reference;
@@ -99,7 +101,7 @@ namespace ft {
 
     template <class T>
     struct iterator_traits<const T*, false> {
-        typedef ptrdiff_t                       difference_type;
+        typedef std::ptrdiff_t                  difference_type;
         typedef T                               value_type;
         typedef const T*                        pointer;
         typedef const T&                        reference;
@@ -225,58 +227,96 @@ namespace ft {
                 return *(*this + n);
             }
     };
-}
-
-template <class It1, class It2>
-inline bool operator==(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
-{
-    return x.base() == y.base();
-}
 
-template <class It1, class It2>
-inline bool operator!=(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
-{
-    return x.base() != y.base();
-}
+    // [[converting_output_iterator]]
+    // 代入された値を To に変換してから, 元の出力イテレータ Out に書き出す。
+    // (tree のイテレータを map, set のイテレータにして書き出すのに使う)
+    template <class Out, class To>
+    class converting_output_iterator {
+        protected:
+            Out current;
 
-template <class It1, class It2>
-inline bool operator<(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
-{
-    return x.base() > y.base();
-}
+        public:
+            typedef Out                         iterator_type;
+            typedef std::output_iterator_tag    iterator_category;
+            typedef void                        value_type;
+            typedef void                        difference_type;
+            typedef void                        pointer;
+            typedef void                        reference;
 
-template <class It1, class It2>
-inline bool operator>(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
-{
-    return x.base() < y.base();
-}
+            explicit converting_output_iterator(Out out): current(out) {}
 
-template <class It1, class It2>
-inline bool operator<=(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
-{
-    return x.base() >= y.base();
-}
+            Out     base() const { return current; }
 
-template <class It1, class It2>
-inline bool operator>=(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
-{
-    return x.base() <= y.base();
-}
+            template <class From>
+            converting_output_iterator&    operator=(const From& x) {
+                *current = To(x);
+                return *this;
+            }
 
-template <class It1, class It2>
-inline typename ft::reverse_iterator<It1>::difference_type operator-(
-    const ft::reverse_iterator<It1>& x,
-    const ft::reverse_iterator<It2>& y
-) {
-    return y.base() - x.base();
-}
+            converting_output_iterator&    operator*() { return *this; }
+            converting_output_iterator&    operator++() {
+                ++current;
+                return *this;
+            }
+            converting_output_iterator     operator++(int) {
+                converting_output_iterator  it = *this;
+                ++current;
+                return it;
+            }
+    };
 
-template <class It>
-inline ft::reverse_iterator<It>    operator+(
-    typename ft::reverse_iterator<It>::difference_type n,
-    const ft::reverse_iterator<It>& x
-) {
-    return ft::reverse_iterator<It>(x.base() - n);
+    template <class It1, class It2>
+    inline bool operator==(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
+    {
+        return x.base() == y.base();
+    }
+
+    template <class It1, class It2>
+    inline bool operator!=(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
+    {
+        return x.base() != y.base();
+    }
+
+    template <class It1, class It2>
+    inline bool operator<(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
+    {
+        return x.base() > y.base();
+    }
+
+    template <class It1, class It2>
+    inline bool operator>(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
+    {
+        return x.base() < y.base();
+    }
+
+    template <class It1, class It2>
+    inline bool operator<=(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
+    {
+        return x.base() >= y.base();
+    }
+
+    template <class It1, class It2>
+    inline bool operator>=(const ft::reverse_iterator<It1>& x, const ft::reverse_iterator<It2>& y)
+    {
+        return x.base() <= y.base();
+    }
+
+    template <class It1, class It2>
+    inline typename ft::reverse_iterator<It1>::difference_type operator-(
+        const ft::reverse_iterator<It1>& x,
+        const ft::reverse_iterator<It2>& y
+    ) {
+        return y.base() - x.base();
+    }
+
+    template <class It>
+    inline ft::reverse_iterator<It>    operator+(
+        typename ft::reverse_iterator<It>::difference_type n,
+        const ft::reverse_iterator<It>& x
+    ) {
+        return ft::reverse_iterator<It>(x.base() - n);
+    }
 }
 
 #endif
@@ -0,0 +1,186 @@
+#ifndef FT_MEMORY_HPP
+# define FT_MEMORY_HPP
+
+# include "ft_common.hpp"
+# include "ft_meta_functions.hpp"
+# include <cstddef>
+# include <cstdlib>
+# include <cstring>
+# include <new>
+# if defined(__unix__) || defined(__APPLE__)
+#  include <sys/mman.h>
+# endif
+
+// 無名 mmap が使えるか(POSIX の環境)
+# if defined(MAP_ANONYMOUS)
+#  define FT_HAVE_MMAP 1
+#  define FT_MAP_ANONYMOUS MAP_ANONYMOUS
+# elif defined(MAP_ANON)
+#  define FT_HAVE_MMAP 1
+#  define FT_MAP_ANONYMOUS MAP_ANON
+# endif
+
+// mremap が使えるか(Linux のみ。_GNU_SOURCE がないと宣言されない)
+# if defined(FT_HAVE_MMAP) && defined(__linux__) && defined(MREMAP_MAYMOVE)
+#  define FT_HAVE_MREMAP 1
+# endif
+
+// この大きさ(バイト)以上の領域は malloc ではなく mmap で確保し, 伸ばすときは mremap を使う。
+// mremap はページの付け替えで済むので, 中身のコピーも, 伸ばす途中で新旧2つ分のメモリを持つことも起きない。
+// mremap がない環境(Linux 以外)では, 新しく mmap してコピーする。
+// mmap がない環境では, すべて malloc / realloc に任せる。
+# ifndef FT_MREMAP_THRESHOLD
+#  define FT_MREMAP_THRESHOLD (1UL << 20)
+# endif
+
+// MAP_HUGETLB で確保するときの単位(ヒュージページの大きさ)
+# ifndef FT_HUGE_PAGE_SIZE
+#  define FT_HUGE_PAGE_SIZE (1UL << 21)
+# endif
+
+namespace ft {
+
+    // [mmap_option]
+    // mmap で確保する領域へのオプション(ビットの組み合わせ)。
+    // - mmap_transparent_hugepage: madvise(MADV_HUGEPAGE) で, カーネルにヒュージページを使うよう頼む
+    // - mmap_hugetlb: MAP_HUGETLB で予約済みのヒュージページから確保する。
+    //   ヒュージページ単位に切り上げて確保し, 予約がなくて失敗したら普通のページで確保する。
+    //   (ヒュージページの領域は mremap できないことがあるので, 伸ばすときはコピーする)
+    // どちらも Linux のもので, ほかの環境では普通のページで確保する。
+    enum mmap_option {
+        mmap_default = 0,
+        mmap_transparent_hugepage = 1,
+        mmap_hugetlb = 2
+    };
+
+    // [relocatable_storage]
+    // is_trivially_relocatable な要素を入れるための, バイト単位の生の領域。
+    // reallocate で中身ごと新しい大きさの領域に移る(要素のコピーコンストラクタ・デストラクタは呼ばない)。
+    // 確保したときの大きさで malloc / mmap を選ぶので,
+    // 解放・再確保のときには, 確保したときと同じ bytes を渡すこと。
+    // Options: mmap で確保するときの mmap_option
+    template <unsigned Options>
+    class basic_relocatable_storage {
+        public:
+
+            // 確保できなければ std::bad_alloc を投げる。
+            static void*    allocate(std::size_t bytes) {
+                if (is_mapped_(bytes)) {
+                    return map_(bytes);
+                }
+                void*   p = std::malloc(bytes);
+                if (!p) { throw std::bad_alloc(); }
+                return p;
+            }
+
+            // [0, min(old_bytes, new_bytes)) の中身を保ったまま, 大きさを new_bytes に変える。
+            // 確保できなければ std::bad_alloc を投げ, p はそのまま残る(強い保証)。
+            static void*    reallocate(void* p, std::size_t old_bytes, std::size_t new_bytes) {
+                if (!p) {
+                    return allocate(new_bytes);
+                }
+                const bool  old_mapped = is_mapped_(old_bytes);
+                const bool  new_mapped = is_mapped_(new_bytes);
+                if (!old_mapped && !new_mapped) {
+                    void*   q = std::realloc(p, new_bytes);
+                    if (!q) { throw std::bad_alloc(); }
+                    return q;
+                }
+# ifdef FT_HAVE_MREMAP
+                if (old_mapped && new_mapped && !(Options & mmap_hugetlb)) {
+                    void*   q = ::mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE);
+                    if (q == MAP_FAILED) { throw std::bad_alloc(); }
+                    advise_(q, new_bytes);
+                    return q;
+                }
+# endif
+                // malloc と mmap の境目をまたぐとき
+                void*   q = allocate(new_bytes);
+                std::memcpy(q, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+                deallocate(p, old_bytes);
+                return q;
+            }
+
+            static void     deallocate(void* p, std::size_t bytes) {
+                if (!p) { return; }
+# ifdef FT_HAVE_MMAP
+                if (is_mapped_(bytes)) {
+                    ::munmap(p, mapped_size_(bytes));
+                    return;
+                }
+# endif
+                std::free(p);
+            }
+
+        FT_PRIVATE:
+
+            static bool     is_mapped_(std::size_t bytes) {
+# ifdef FT_HAVE_MMAP
+                return bytes >= FT_MREMAP_THRESHOLD;
+# else
+                (void)bytes;
+                return false;
+# endif
+            }
+
+            // 実際に mmap する大きさ(MAP_HUGETLB ならヒュージページ単位に切り上げる)
+            static std::size_t  mapped_size_(std::size_t bytes) {
+                if (Options & mmap_hugetlb) {
+                    return (bytes + FT_HUGE_PAGE_SIZE - 1) / FT_HUGE_PAGE_SIZE * FT_HUGE_PAGE_SIZE;
+                }
+                return bytes;
+            }
+
+            static void*    map_(std::size_t bytes) {
+# ifdef FT_HAVE_MMAP
+                const std::size_t   size = mapped_size_(bytes);
+                const int           prot = PROT_READ | PROT_WRITE;
+                const int           flags = MAP_PRIVATE | FT_MAP_ANONYMOUS;
+                void*               p = MAP_FAILED;
+#  ifdef MAP_HUGETLB
+                if (Options & mmap_hugetlb) {
+                    p = ::mmap(NULL, size, prot, flags | MAP_HUGETLB, -1, 0);
+                }
+#  endif
+                if (p == MAP_FAILED) {
+                    p = ::mmap(NULL, size, prot, flags, -1, 0);
+                }
+                if (p == MAP_FAILED) { throw std::bad_alloc(); }
+                advise_(p, size);
+                return p;
+# else
+                (void)bytes;
+                throw std::bad_alloc();
+# endif
+            }
+
+            // 失敗しても困らないので, 結果は見ない
+            static void     advise_(void* p, std::size_t bytes) {
+# if defined(FT_HAVE_MMAP) && defined(MADV_HUGEPAGE)
+                if (Options & mmap_transparent_hugepage) {
+                    ::madvise(p, bytes, MADV_HUGEPAGE);
+                }
+# else
+                (void)p;
+                (void)bytes;
+# endif
+            }
+    };
+
+    typedef basic_relocatable_storage<mmap_default>    relocatable_storage;
+
+    // [relocatable_storage_for]
+    // vector が, 要素が trivially relocatable なときに Allocator の代わりに使ってよい領域(type)。
+    // value が偽なら Allocator をそのまま使う(状態を持つかもしれないアロケータを飛ばせないので)。
+    // std::allocator は状態を持たないので飛ばしてよい。
+    template <class Allocator>
+    struct relocatable_storage_for : false_type {
+        typedef relocatable_storage type;
+    };
+    template <class T>
+    struct relocatable_storage_for< std::allocator<T> > : true_type {
+        typedef relocatable_storage type;
+    };
+}
+
+#endif
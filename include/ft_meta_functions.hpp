@@ -130,6 +130,42 @@ namespace ft {
         >::value || is_pointer<T>::value
     > {};
 
+    // [is_trivially_relocatable]
+    // オブジェクトを memcpy(や realloc)で別の場所に移し, 元の場所のデストラクタを呼ばずに捨ててよい型。
+    // ft::vector はこれが真の型の領域を realloc / mremap で伸ばす。
+    // 自分自身を指すポインタなどを持たない型なら, 特殊化して真にしてよい。
+    // (trivially copyable かどうかはコンパイラの組み込み関数で調べる。使えなければ算術型とポインタだけ)
+# if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+#  define FT_IS_TRIVIALLY_COPYABLE(T) __is_trivially_copyable(T)
+# else
+#  define FT_IS_TRIVIALLY_COPYABLE(T) false
+# endif
+    template< class T > struct is_trivially_relocatable : integral_constant<bool,
+        is_pseudo_trivially_assignable<T>::value || FT_IS_TRIVIALLY_COPYABLE(T)
+    > {};
+
+    // [is_trivially_destructible]
+    // デストラクタが何もしない型。要素の破壊を省いてよい。
+    // [is_trivially_default_constructible]
+    // デフォルト構築(T t;)が何もしない型。要素を初期化せずに置いてよい。
+    // (どちらもコンパイラの組み込み関数で調べる。使えなければ算術型とポインタだけ)
+# if defined(__clang__)
+#  define FT_IS_TRIVIALLY_DESTRUCTIBLE(T) __is_trivially_destructible(T)
+#  define FT_IS_TRIVIALLY_DEFAULT_CONSTRUCTIBLE(T) __is_trivially_constructible(T)
+# elif defined(__GNUC__) && __GNUC__ >= 5
+#  define FT_IS_TRIVIALLY_DESTRUCTIBLE(T) __has_trivial_destructor(T)
+#  define FT_IS_TRIVIALLY_DEFAULT_CONSTRUCTIBLE(T) __is_trivially_constructible(T)
+# else
+#  define FT_IS_TRIVIALLY_DESTRUCTIBLE(T) false
+#  define FT_IS_TRIVIALLY_DEFAULT_CONSTRUCTIBLE(T) false
+# endif
+    template< class T > struct is_trivially_destructible : integral_constant<bool,
+        is_pseudo_trivially_destructible<T>::value || FT_IS_TRIVIALLY_DESTRUCTIBLE(T)
+    > {};
+    template< class T > struct is_trivially_default_constructible : integral_constant<bool,
+        is_pseudo_trivially_constructible<T>::value || FT_IS_TRIVIALLY_DEFAULT_CONSTRUCTIBLE(T)
+    > {};
+
     // [is_same]
     template<typename S, typename T>
     struct is_same {
@@ -170,6 +206,31 @@ namespace ft {
 
     template <typename From, typename To>
     struct is_convertible<From, To, true>: true_type {};
+
+    // [is_transparent]
+    // コンパレータが is_transparent という型を持つ(= キー以外の型とも比較できると宣言している)かどうか
+    template <class Compare>
+    class is_transparent {
+        private:
+            template <class U>
+            static yes_type f(typename U::is_transparent* = NULL);
+            template <class U>
+            static no_type  f(...);
+        public:
+            static const bool   value = sizeof(f<Compare>(NULL)) == sizeof(yes_type);
+    };
+
+    // [enable_if_transparent]
+    // Compare が transparent で, かつ K が Excluded に変換できない時だけ type = T を持つ.
+    // K はメンバ関数テンプレートの引数で, SFINAE を効かせるために使う.
+    // (K に依存しない enable_if だと, クラスの実体化の時点でエラーになる)
+    template <class Compare, class K, class T, class Excluded = void>
+    struct enable_if_transparent:
+        public enable_if<is_transparent<Compare>::value && !is_convertible<K, Excluded>::value, T> {};
+
+    template <class Compare, class K, class T>
+    struct enable_if_transparent<Compare, K, T, void>:
+        public enable_if<is_transparent<Compare>::value, T> {};
 }
 
 
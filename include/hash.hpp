@@ -0,0 +1,97 @@
+#ifndef HASH_HPP
+# define HASH_HPP
+
+# include "ft_common.hpp"
+# include <cstddef>
+# include <string>
+
+namespace ft {
+
+    // [hash]
+    // unordered_map, unordered_set の既定のハッシュ関数。
+    // 整数・ポインタはそのままの値を返す(かき混ぜるのは hash_table 側でやる)。
+    // 対応していない型を使うとコンパイルエラーになる。
+    template <class T>
+    struct hash;
+
+# define FT_HASH_INTEGRAL(type) \
+    template <> \
+    struct hash<type> { \
+        typedef type        argument_type; \
+        typedef std::size_t result_type; \
+        std::size_t operator()(type x) const { \
+            return static_cast<std::size_t>(x); \
+        } \
+    };
+
+    FT_HASH_INTEGRAL(bool)
+    FT_HASH_INTEGRAL(char)
+    FT_HASH_INTEGRAL(signed char)
+    FT_HASH_INTEGRAL(unsigned char)
+    FT_HASH_INTEGRAL(wchar_t)
+    FT_HASH_INTEGRAL(short)
+    FT_HASH_INTEGRAL(unsigned short)
+    FT_HASH_INTEGRAL(int)
+    FT_HASH_INTEGRAL(unsigned int)
+    FT_HASH_INTEGRAL(long)
+    FT_HASH_INTEGRAL(unsigned long)
+
+# undef FT_HASH_INTEGRAL
+
+    template <class T>
+    struct hash<T*> {
+        typedef T*          argument_type;
+        typedef std::size_t result_type;
+        std::size_t operator()(T* p) const {
+            return reinterpret_cast<std::size_t>(p);
+        }
+    };
+
+    // バイト列の FNV-1a
+    // (size_t が64ビットなら64ビット版, そうでなければ32ビット版)
+    inline std::size_t  hash_bytes(const void* p, std::size_t n) {
+        const bool          wide = sizeof(std::size_t) >= 8;
+        const std::size_t   offset = wide
+            ? (static_cast<std::size_t>(0xcbf29ce4UL) << 16 << 16) | 0x84222325UL
+            : 0x811c9dc5UL;
+        const std::size_t   prime = wide
+            ? (static_cast<std::size_t>(0x100UL) << 16 << 16) | 0x000001b3UL
+            : 0x01000193UL;
+        const unsigned char*    bytes = static_cast<const unsigned char*>(p);
+        std::size_t             h = offset;
+        for (std::size_t i = 0; i < n; ++i) {
+            h = (h ^ bytes[i]) * prime;
+        }
+        return h;
+    }
+
+    template <>
+    struct hash<std::string> {
+        typedef std::string argument_type;
+        typedef std::size_t result_type;
+        std::size_t operator()(const std::string& s) const {
+            return hash_bytes(s.data(), s.size());
+        }
+    };
+
+    // 0.0 と -0.0 は等しいので, 同じハッシュ値にする。
+    template <>
+    struct hash<float> {
+        typedef float       argument_type;
+        typedef std::size_t result_type;
+        std::size_t operator()(float x) const {
+            return x == 0 ? 0 : hash_bytes(&x, sizeof(x));
+        }
+    };
+
+    template <>
+    struct hash<double> {
+        typedef double      argument_type;
+        typedef std::size_t result_type;
+        std::size_t operator()(double x) const {
+            return x == 0 ? 0 : hash_bytes(&x, sizeof(x));
+        }
+    };
+}
+
+#endif
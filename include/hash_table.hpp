@@ -0,0 +1,843 @@
+#ifndef HASH_TABLE_HPP
+# define HASH_TABLE_HPP
+
+# include "ft_common.hpp"
+# include "ft_meta_functions.hpp"
+# include "ft_iterator.hpp"
+# include "ft_algorithm.hpp"
+# include "pair.hpp"
+# include "hash.hpp"
+# include <memory>
+# include <algorithm>
+# include <cstddef>
+# include <limits>
+# include <iterator>
+# include <stdexcept>
+
+namespace ft {
+
+    // hash_table (オープンアドレス法, Robin Hood ハッシュ)
+    // 値を1本の配列(スロット)に直接置き, 各スロットに1バイトの印を持つ。
+    // - 印は「ホーム位置からの距離 + 1」(0 なら空き)。
+    //   線形探索の途中で, 自分より距離の短い値に出会ったらそこに割り込む(Robin Hood)。
+    //   探索は, 印が今の距離より小さくなった時点で打ち切れる。
+    // - スロットと印は1回の確保にまとめる([スロット...][印...][終端の印])。
+    // - 末尾で折り返さない。代わりにバケット数の後ろに max_probe 個の予備スロットを置き,
+    //   距離が max_probe を超えそうならテーブルを大きくする。
+    //   (テーブルが十分に空いているのに置けないなら, 予備スロットの方を増やす。
+    //   同じホーム位置に集まるキーが多すぎて254個の予備でも置けなければ std::length_error)
+    //   (折り返さないので, 削除で値が動くのは後ろから前へだけ。
+    //   erase の戻り値で走査を続けても, 同じ値を2度見ることはない)
+    // - 大きくするときは, 新しいテーブルを確保して古いテーブルを残し,
+    //   挿入のたびに古いテーブルのスロットを rehash_step 個ずつ移す(インクリメンタルな再ハッシュ)。
+    //   一度に全要素を移し替えることによる遅延の山を作らない。
+    //   移し終わるまでの間, 検索は両方のテーブルを見る。
+    // - 値の移動はコピーコンストラクタ+デストラクタで行う。
+    //   値のコピーコンストラクタが例外を投げないことを前提とする(btree と同じ)。
+    //   (新しく挿入する値の構築が例外を投げた場合は, テーブルは変化しない)
+    // - 挿入はすべてのイテレータを無効にする。
+    //   削除は, 消した値より後ろ(同じクラスタ内)のイテレータを無効にする。
+    // キーの重複は許さない(unordered_map, unordered_set 用)。
+    template <
+        // スロットに載る値の型
+        // - unordered_map<MK, MV, ...>  -> pair<const MK, MV>
+        // - unordered_set<SK, ...>      -> SK
+        class Value,
+        // Value, キーのどちらからでもハッシュ値を返す関数オブジェクト
+        class Hasher,
+        // (Value, Value), (Value, キー) が等しいかを返す関数オブジェクト
+        class KeyEqual,
+        // Valueのアロケータ
+        class ValueAllocator = std::allocator<Value>
+    >
+    class hash_table {
+        public:
+            typedef Value                                               value_type;
+            typedef Hasher                                              hasher;
+            typedef KeyEqual                                            key_equal;
+            typedef ValueAllocator                                      value_allocator_type;
+            typedef hash_table<Value, Hasher, KeyEqual, ValueAllocator> self_type;
+            typedef value_type&                                         reference;
+            typedef const value_type&                                   const_reference;
+            typedef typename value_allocator_type::size_type            size_type;
+            typedef typename value_allocator_type::difference_type      difference_type;
+
+            // 空きスロットの印
+            static const unsigned char  empty_mark = 0;
+            // 印の配列の終端(走査の番兵)
+            static const unsigned char  end_mark = 0xff;
+            // バケット数の最小値
+            static const size_type      min_buckets = 8;
+            // 挿入1回あたりに古いテーブルから移すスロットの数
+            // (新しいテーブルが次に大きくなる前に, 古いテーブルを移し終える)
+            static const size_type      rehash_step = 4;
+            // 予備スロットの数の上限(印は1バイトで, end_mark を避ける)
+            static const size_type      max_probe_limit = 254;
+
+        FT_PRIVATE:
+
+            // [テーブル]
+            // slots == NULL なら未確保(marks は終端の印1個だけを指す)。
+            struct table {
+                value_type*     slots;
+                unsigned char*  marks;
+                // バケット数(2のべき)
+                size_type       bucket_count;
+                // スロット数(バケット数 + 予備)
+                size_type       slot_count;
+                // 許される最大の印(距離 + 1)
+                size_type       max_probe;
+                // ハッシュ値からホーム位置を取り出すシフト量
+                size_type       shift;
+            };
+
+            // 未確保のテーブルの印
+            static unsigned char*   null_marks_() {
+                static unsigned char    mark = end_mark;
+                return &mark;
+            }
+
+            static table            null_table_() {
+                table   t;
+                t.slots = NULL;
+                t.marks = null_marks_();
+                t.bucket_count = 0;
+                t.slot_count = 0;
+                t.max_probe = 0;
+                t.shift = 0;
+                return t;
+            }
+
+            // 空きスロットを飛ばす。
+            // 古いテーブルの終端に来たら, 新しいテーブル(next_*)の先頭に移る。
+            static void             skip_(
+                value_type*& slot, unsigned char*& mark,
+                value_type*& next_slot, unsigned char*& next_mark
+            ) {
+                for (;;) {
+                    while (*mark == empty_mark) {
+                        ++slot;
+                        ++mark;
+                    }
+                    if (*mark != end_mark || next_mark == NULL) { return; }
+                    slot = next_slot;
+                    mark = next_mark;
+                    next_slot = NULL;
+                    next_mark = NULL;
+                }
+            }
+
+        public:
+
+            class const_iterator;
+
+            // [イテレータ]
+            // スロットと印の組。古いテーブルを指しているときは, 続けて走査する新しいテーブルも持つ。
+            // end は新しいテーブルの終端の印。
+            class iterator {
+                public:
+                    typedef typename hash_table::value_type             value_type;
+                    typedef typename hash_table::difference_type        difference_type;
+                    typedef value_type*                                 pointer;
+                    typedef value_type&                                 reference;
+                    typedef std::forward_iterator_tag                   iterator_category;
+
+                    value_type*     slot_;
+                    unsigned char*  mark_;
+                    value_type*     next_slot_;
+                    unsigned char*  next_mark_;
+
+                    iterator(): slot_(NULL), mark_(NULL), next_slot_(NULL), next_mark_(NULL) {}
+                    iterator(value_type* s, unsigned char* m, value_type* ns, unsigned char* nm)
+                        : slot_(s), mark_(m), next_slot_(ns), next_mark_(nm) {}
+
+                    reference   operator*() const { return *slot_; }
+                    pointer     operator->() const { return slot_; }
+
+                    iterator&   operator++() {
+                        ++slot_;
+                        ++mark_;
+                        hash_table::skip_(slot_, mark_, next_slot_, next_mark_);
+                        return *this;
+                    }
+                    iterator    operator++(int) {
+                        iterator    it = *this;
+                        ++*this;
+                        return it;
+                    }
+
+                    bool        operator==(const iterator& rhs) const {
+                        return mark_ == rhs.mark_;
+                    }
+                    bool        operator!=(const iterator& rhs) const {
+                        return !(*this == rhs);
+                    }
+                    bool        operator==(const const_iterator& rhs) const {
+                        return mark_ == rhs.mark_;
+                    }
+                    bool        operator!=(const const_iterator& rhs) const {
+                        return !(*this == rhs);
+                    }
+            };
+
+            // [constイテレータ]
+            class const_iterator {
+                public:
+                    typedef typename hash_table::value_type             value_type;
+                    typedef typename hash_table::difference_type        difference_type;
+                    typedef const value_type*                           pointer;
+                    typedef const value_type&                           reference;
+                    typedef std::forward_iterator_tag                   iterator_category;
+
+                    // (非constイテレータへ戻せるように, 非constで持つ)
+                    value_type*     slot_;
+                    unsigned char*  mark_;
+                    value_type*     next_slot_;
+                    unsigned char*  next_mark_;
+
+                    const_iterator(): slot_(NULL), mark_(NULL), next_slot_(NULL), next_mark_(NULL) {}
+                    // これは explicit つけない
+                    const_iterator(const iterator& variable)
+                        : slot_(variable.slot_), mark_(variable.mark_),
+                        next_slot_(variable.next_slot_), next_mark_(variable.next_mark_) {}
+
+                    reference       operator*() const { return *slot_; }
+                    pointer         operator->() const { return slot_; }
+
+                    const_iterator& operator++() {
+                        ++slot_;
+                        ++mark_;
+                        hash_table::skip_(slot_, mark_, next_slot_, next_mark_);
+                        return *this;
+                    }
+                    const_iterator  operator++(int) {
+                        const_iterator  it = *this;
+                        ++*this;
+                        return it;
+                    }
+
+                    bool            operator==(const const_iterator& rhs) const {
+                        return mark_ == rhs.mark_;
+                    }
+                    bool            operator!=(const const_iterator& rhs) const {
+                        return !(*this == rhs);
+                    }
+            };
+
+        FT_PRIVATE:
+
+            // [[メンバ変数]]
+
+            // 新しいテーブル(挿入先)
+            table                   cur_;
+            // 移し替え中の古いテーブル(なければ未確保)
+            table                   old_;
+            // 古いテーブルの, 次に移すスロット
+            // (これより前のスロットはすべて空き)
+            size_type               old_pos_;
+            // 古いテーブルに残っている要素数
+            size_type               old_size_;
+            // 全体の要素数
+            size_type               size_;
+            float                   max_load_factor_;
+            hasher                  hasher_;
+            key_equal               key_equal_;
+            value_allocator_type    value_allocator_;
+
+        public:
+
+            // [[コンストラクタ群]]
+
+            hash_table(
+                size_type bucket_count,
+                const hasher& hash,
+                const key_equal& equal,
+                const value_allocator_type& allocator
+            ):
+                cur_(null_table_()), old_(null_table_()), old_pos_(0), old_size_(0), size_(0),
+                max_load_factor_(0.875f),
+                hasher_(hash), key_equal_(equal), value_allocator_(allocator)
+            {
+                if (bucket_count > 0) {
+                    rehash(bucket_count);
+                }
+            }
+
+            // コピーコンストラクタ
+            // other が移し替え中でなければ, 同じ位置に値をコピーする(ハッシュ値を計算しない)。
+            hash_table(const self_type& other):
+                cur_(null_table_()), old_(null_table_()), old_pos_(0), old_size_(0), size_(0),
+                max_load_factor_(other.max_load_factor_),
+                hasher_(other.hasher_), key_equal_(other.key_equal_),
+                value_allocator_(other.value_allocator_)
+            {
+                if (other.size_ == 0) { return; }
+                if (other.old_.slots == NULL) {
+                    table   t;
+                    allocate_(t, other.cur_.bucket_count, other.cur_.max_probe);
+                    try {
+                        for (size_type i = 0; i < t.slot_count; ++i) {
+                            if (other.cur_.marks[i] != empty_mark) {
+                                construct_value_(t.slots + i, other.cur_.slots[i]);
+                                t.marks[i] = other.cur_.marks[i];
+                            }
+                        }
+                    } catch (...) {
+                        destroy_all_(t);
+                        release_(t);
+                        throw;
+                    }
+                    cur_ = t;
+                } else {
+                    cur_ = build_(other, other.cur_.bucket_count, other.cur_.max_probe);
+                }
+                size_ = other.size_;
+            }
+
+            ~hash_table() {
+                destroy_all_(old_);
+                release_(old_);
+                destroy_all_(cur_);
+                release_(cur_);
+            }
+
+            self_type&  operator=(const self_type& rhs) {
+                if (this == &rhs) { return *this; }
+                self_type   copied(rhs);
+                swap(copied);
+                return *this;
+            }
+
+            // [[getter群]]
+
+            value_allocator_type    get_allocator() const { return value_allocator_; }
+            const hasher&           hash_function() const { return hasher_; }
+            const key_equal&        key_eq() const { return key_equal_; }
+
+            iterator        begin() {
+                if (old_.slots != NULL) {
+                    iterator    it(
+                        old_.slots + old_pos_, old_.marks + old_pos_, cur_.slots, cur_.marks
+                    );
+                    skip_(it.slot_, it.mark_, it.next_slot_, it.next_mark_);
+                    return it;
+                }
+                iterator    it(cur_.slots, cur_.marks, NULL, NULL);
+                skip_(it.slot_, it.mark_, it.next_slot_, it.next_mark_);
+                return it;
+            }
+            const_iterator  begin() const {
+                return const_cast<self_type*>(this)->begin();
+            }
+            iterator        end() {
+                return iterator(
+                    cur_.slots + cur_.slot_count, cur_.marks + cur_.slot_count, NULL, NULL
+                );
+            }
+            const_iterator  end() const {
+                return const_cast<self_type*>(this)->end();
+            }
+
+            bool            empty() const { return size_ == 0; }
+            size_type       size() const { return size_; }
+            size_type       max_size() const {
+                return std::min<size_type>(
+                    value_allocator_.max_size(),
+                    std::numeric_limits<difference_type>::max()
+                ) / 2;
+            }
+
+            // [[バケット]]
+
+            size_type       bucket_count() const { return cur_.bucket_count; }
+
+            float           load_factor() const {
+                return cur_.bucket_count == 0 ? 0.0f
+                    : static_cast<float>(size_) / static_cast<float>(cur_.bucket_count);
+            }
+
+            float           max_load_factor() const { return max_load_factor_; }
+
+            // Robin Hood でも埋まりすぎると探索が長くなるので, 0.95 までに抑える。
+            void            max_load_factor(float ml) {
+                if (!(ml > 0.0f)) { return; }
+                max_load_factor_ = ml < 0.95f ? ml : 0.95f;
+                if (cur_.slots != NULL && size_ > capacity_of_(cur_)) {
+                    rehash(0);
+                }
+            }
+
+            // バケット数を count 以上(かつ今の要素数を max_load_factor 以内で載せられる数)にする。
+            // 移し替え中なら, それも一度に終わらせる。
+            void            rehash(size_type count) {
+                size_type   need = static_cast<size_type>(
+                    static_cast<float>(size_) / max_load_factor_
+                ) + 1;
+                if (count < need) { count = need; }
+                size_type   buckets = min_buckets;
+                while (buckets < count) { buckets *= 2; }
+                if (cur_.slots != NULL && old_.slots == NULL && buckets == cur_.bucket_count) {
+                    return;
+                }
+                rebuild_(buckets, default_probe_(buckets));
+            }
+
+            // count 要素を, 大きくせずに載せられるようにする。
+            void            reserve(size_type count) {
+                rehash(static_cast<size_type>(
+                    static_cast<float>(count) / max_load_factor_
+                ) + 1);
+            }
+
+            // 移し替え中か(テスト用)
+            bool            rehashing() const { return old_.slots != NULL; }
+
+            // [[ライフサイクル]]
+
+            // 要素をすべて破壊する。バケット数はそのまま。
+            void            clear() {
+                destroy_all_(old_);
+                release_(old_);
+                old_pos_ = 0;
+                old_size_ = 0;
+                destroy_all_(cur_);
+                size_ = 0;
+            }
+
+            void            swap(self_type& other) {
+                ft::swap(cur_, other.cur_);
+                ft::swap(old_, other.old_);
+                ft::swap(old_pos_, other.old_pos_);
+                ft::swap(old_size_, other.old_size_);
+                ft::swap(size_, other.size_);
+                ft::swap(max_load_factor_, other.max_load_factor_);
+                ft::swap(hasher_, other.hasher_);
+                ft::swap(key_equal_, other.key_equal_);
+                ft::swap(value_allocator_, other.value_allocator_);
+            }
+
+            // [[挿入]]
+
+            pair<iterator, bool>    insert(const value_type& v) {
+                const size_type h = hasher_(v);
+                iterator        found = find_hashed_(v, h);
+                if (found != end()) {
+                    return ft::make_pair(found, false);
+                }
+                reserve_one_();
+                migrate_(rehash_step);
+                size_type   i;
+                while ((i = place_(cur_, h, v)) == npos_()) {
+                    size_type   buckets = cur_.bucket_count;
+                    size_type   probe = cur_.max_probe;
+                    next_shape_(size_ + 1, buckets, probe);
+                    rebuild_(buckets, probe);
+                }
+                ++size_;
+                return ft::make_pair(iterator_at_(cur_, i), true);
+            }
+
+            template <class InputIterator>
+            void                    insert(InputIterator first, InputIterator last) {
+                for (; first != last; ++first) {
+                    insert(*first);
+                }
+            }
+
+            // [[削除]]
+
+            // 次の要素を指すイテレータを返す。
+            // (後ろの値が前に詰められていれば, 同じ位置を指す)
+            iterator    erase(const_iterator position) {
+                table&      t = in_old_(position.mark_) ? old_ : cur_;
+                size_type   i = position.mark_ - t.marks;
+                erase_at_(t, i);
+                if (&t == &old_) {
+                    --old_size_;
+                }
+                --size_;
+                iterator    it = iterator_at_(t, i);
+                skip_(it.slot_, it.mark_, it.next_slot_, it.next_mark_);
+                return it;
+            }
+
+            // 削除のたびに値が前に詰められうるので, 個数を数えてから消す。
+            iterator    erase(const_iterator first, const_iterator last) {
+                size_type   n = 0;
+                for (const_iterator it = first; it != last; ++it) {
+                    ++n;
+                }
+                iterator    it(first.slot_, first.mark_, first.next_slot_, first.next_mark_);
+                for (; n > 0; --n) {
+                    it = erase(it);
+                }
+                return it;
+            }
+
+            template <class Key>
+            size_type   erase_by_key(const Key& key) {
+                iterator    it = find(key);
+                if (it == end()) {
+                    return 0;
+                }
+                erase(it);
+                return 1;
+            }
+
+            // [[検索]]
+
+            template <class Key>
+            iterator        find(const Key& key) {
+                return find_hashed_(key, hasher_(key));
+            }
+            template <class Key>
+            const_iterator  find(const Key& key) const {
+                return const_cast<self_type*>(this)->find(key);
+            }
+
+            template <class Key>
+            size_type       count(const Key& key) const {
+                return find(key) == end() ? 0 : 1;
+            }
+
+            template <class Key>
+            pair<iterator, iterator>    equal_range(const Key& key) {
+                iterator    first = find(key);
+                iterator    last = first;
+                if (last != end()) {
+                    ++last;
+                }
+                return ft::make_pair(first, last);
+            }
+            template <class Key>
+            pair<const_iterator, const_iterator>    equal_range(const Key& key) const {
+                pair<iterator, iterator>    r = const_cast<self_type*>(this)->equal_range(key);
+                return ft::make_pair(const_iterator(r.first), const_iterator(r.second));
+            }
+
+            // 内部構造が正しいか(テスト用)
+            // - 印がホーム位置からの距離と合っているか
+            // - 隣り合う値の距離が Robin Hood の条件を満たしているか
+            // - 古いテーブルの, 移し終えた位置より前が空か
+            // - 要素数が合っているか
+            bool            debug_valid() const {
+                size_type   n = 0;
+                if (!debug_valid_table_(cur_, n) || !debug_valid_table_(old_, n)) {
+                    return false;
+                }
+                for (size_type i = 0; i < old_pos_ && i < old_.slot_count; ++i) {
+                    if (old_.marks[i] != empty_mark) { return false; }
+                }
+                return n == size_;
+            }
+
+        FT_PRIVATE:
+
+            static size_type    npos_() {
+                return std::numeric_limits<size_type>::max();
+            }
+
+            // 黄金比のハッシュ(ハッシュ値にかけて上位ビットを取る)
+            static size_type    golden_() {
+                return sizeof(size_type) >= 8
+                    ? (static_cast<size_type>(0x9e3779b9UL) << 16 << 16) | 0x7f4a7c15UL
+                    : static_cast<size_type>(0x9e3779b9UL);
+            }
+
+            static size_type    home_(const table& t, size_type h) {
+                return (h * golden_()) >> t.shift;
+            }
+
+            // t が count 要素まで大きくせずに載せられるか
+            size_type   capacity_of_(const table& t) const {
+                return static_cast<size_type>(
+                    static_cast<float>(t.bucket_count) * max_load_factor_
+                );
+            }
+
+            bool        in_old_(const unsigned char* mark) const {
+                return old_.slots != NULL
+                    && old_.marks <= mark && mark < old_.marks + old_.slot_count;
+            }
+
+            iterator    iterator_at_(table& t, size_type i) {
+                if (&t == &old_) {
+                    return iterator(t.slots + i, t.marks + i, cur_.slots, cur_.marks);
+                }
+                return iterator(t.slots + i, t.marks + i, NULL, NULL);
+            }
+
+            // [[探索]]
+
+            // t の中で key を探す。from より前のスロットは空きとして飛ばす。
+            template <class Key>
+            size_type   probe_(const table& t, const Key& key, size_type h, size_type from) const {
+                if (t.slots == NULL) { return npos_(); }
+                size_type   i = home_(t, h);
+                size_type   d = 1;
+                if (i < from) {
+                    d += from - i;
+                    i = from;
+                }
+                // 印が d より小さければ, key はこれより後ろにない。
+                // (距離は max_probe までなので, 終端の印までは進まない)
+                for (; t.marks[i] >= d; ++i, ++d) {
+                    if (t.marks[i] == d && key_equal_(t.slots[i], key)) {
+                        return i;
+                    }
+                }
+                return npos_();
+            }
+
+            template <class Key>
+            iterator    find_hashed_(const Key& key, size_type h) {
+                size_type   i = probe_(cur_, key, h, 0);
+                if (i != npos_()) {
+                    return iterator_at_(cur_, i);
+                }
+                if (old_size_ > 0) {
+                    i = probe_(old_, key, h, old_pos_);
+                    if (i != npos_()) {
+                        return iterator_at_(old_, i);
+                    }
+                }
+                return end();
+            }
+
+            // [[配置・削除]]
+
+            // v のコピーを t に置き, その位置を返す。
+            // 距離が max_probe を超える場合は何もせずに npos_() を返す。
+            size_type   place_(table& t, size_type h, const value_type& v) {
+                size_type   i = home_(t, h);
+                size_type   d = 1;
+                for (; t.marks[i] >= d; ++i, ++d);
+                if (d > t.max_probe) { return npos_(); }
+                // [i, e) の値を1つずつ後ろにずらす。
+                size_type   e = i;
+                for (; t.marks[e] != empty_mark; ++e) {
+                    if (t.marks[e] >= t.max_probe) { return npos_(); }
+                }
+                for (size_type j = e; j > i; --j) {
+                    relocate_(t.slots + j, t.slots + j - 1);
+                    t.marks[j] = static_cast<unsigned char>(t.marks[j - 1] + 1);
+                }
+                try {
+                    construct_value_(t.slots + i, v);
+                } catch (...) {
+                    for (size_type j = i; j < e; ++j) {
+                        relocate_(t.slots + j, t.slots + j + 1);
+                        t.marks[j] = static_cast<unsigned char>(t.marks[j + 1] - 1);
+                    }
+                    t.marks[e] = empty_mark;
+                    throw;
+                }
+                t.marks[i] = static_cast<unsigned char>(d);
+                return i;
+            }
+
+            // t の i 番目の値を破壊し, 後ろの値を(ホーム位置にいるものの手前まで)前に詰める。
+            void        erase_at_(table& t, size_type i) {
+                destroy_value_(t.slots + i);
+                size_type   j = i + 1;
+                for (; t.marks[j] > 1 && t.marks[j] != end_mark; ++j) {
+                    relocate_(t.slots + j - 1, t.slots + j);
+                    t.marks[j - 1] = static_cast<unsigned char>(t.marks[j] - 1);
+                }
+                t.marks[j - 1] = empty_mark;
+            }
+
+            // [[大きくする]]
+
+            // もう1要素入れるとあふれるなら, テーブルを2倍にして移し替えを始める。
+            // 前の移し替えが終わっていなければ, 先に終わらせる。
+            void        reserve_one_() {
+                if (cur_.slots == NULL) {
+                    allocate_(cur_, min_buckets, default_probe_(min_buckets));
+                    return;
+                }
+                if (size_ + 1 <= capacity_of_(cur_)) { return; }
+                if (old_.slots != NULL) {
+                    migrate_(old_.slot_count);
+                    if (size_ + 1 <= capacity_of_(cur_)) { return; }
+                }
+                table   bigger;
+                allocate_(
+                    bigger, cur_.bucket_count * 2,
+                    std::max(cur_.max_probe, default_probe_(cur_.bucket_count * 2))
+                );
+                old_ = cur_;
+                old_pos_ = 0;
+                old_size_ = size_;
+                cur_ = bigger;
+            }
+
+            // 古いテーブルのスロットを step 個, 新しいテーブルに移す。
+            // 移し終えたら古いテーブルを解放する。
+            void        migrate_(size_type step) {
+                if (old_.slots == NULL) { return; }
+                for (; step > 0 && old_pos_ < old_.slot_count && old_size_ > 0; --step, ++old_pos_) {
+                    if (old_.marks[old_pos_] == empty_mark) { continue; }
+                    value_type* v = old_.slots + old_pos_;
+                    if (place_(cur_, hasher_(*v), *v) == npos_()) {
+                        // 新しいテーブルに置けなければ, 全体を一度に作り直す。
+                        size_type   buckets = cur_.bucket_count;
+                        size_type   probe = cur_.max_probe;
+                        next_shape_(size_, buckets, probe);
+                        rebuild_(buckets, probe);
+                        return;
+                    }
+                    destroy_value_(v);
+                    old_.marks[old_pos_] = empty_mark;
+                    --old_size_;
+                }
+                if (old_size_ == 0 || old_pos_ == old_.slot_count) {
+                    release_(old_);
+                    old_pos_ = 0;
+                    old_size_ = 0;
+                }
+            }
+
+            // バケット数 buckets の新しいテーブルに全要素を(両方のテーブルから)移す。
+            void        rebuild_(size_type buckets, size_type probe) {
+                table   t = build_(*this, buckets, probe);
+                destroy_all_(old_);
+                release_(old_);
+                old_pos_ = 0;
+                old_size_ = 0;
+                destroy_all_(cur_);
+                release_(cur_);
+                cur_ = t;
+            }
+
+            // src の全要素のコピーを持つ, バケット数 buckets 以上のテーブルを作る。
+            // 置けない値があれば, テーブルの形を変えてやり直す。
+            table       build_(const self_type& src, size_type buckets, size_type probe) {
+                for (;;) {
+                    table   t;
+                    allocate_(t, buckets, probe);
+                    bool    placed;
+                    try {
+                        placed = copy_into_(t, src.old_) && copy_into_(t, src.cur_);
+                    } catch (...) {
+                        destroy_all_(t);
+                        release_(t);
+                        throw;
+                    }
+                    if (placed) { return t; }
+                    destroy_all_(t);
+                    release_(t);
+                    next_shape_(src.size_, buckets, probe);
+                }
+            }
+
+            // count 要素を置けなかったテーブルの, 次の形を決める。
+            // - テーブルが十分に空いている(負荷率が max_load_factor の 1/4 以下)なら,
+            //   ハッシュ値の偏りが原因なので, バケット数はそのままで予備スロットを2倍にする。
+            // - そうでなければバケット数を2倍にする。
+            void        next_shape_(size_type count, size_type& buckets, size_type& probe) const {
+                if (count * 4 <= static_cast<size_type>(static_cast<float>(buckets) * max_load_factor_)) {
+                    if (probe >= max_probe_limit) {
+                        throw std::length_error("hash_table: too many collisions");
+                    }
+                    probe = probe * 2 < max_probe_limit ? probe * 2 : max_probe_limit;
+                } else {
+                    buckets *= 2;
+                    probe = std::max(probe, default_probe_(buckets));
+                }
+            }
+
+            bool        copy_into_(table& t, const table& src) {
+                for (size_type i = 0; i < src.slot_count; ++i) {
+                    if (src.marks[i] == empty_mark) { continue; }
+                    if (place_(t, hasher_(src.slots[i]), src.slots[i]) == npos_()) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            // [[テーブルの確保・解放]]
+
+            // スロットの後ろに印を置くので, 印の分も value_type 単位で確保する。
+            static size_type    units_(size_type slot_count) {
+                return slot_count + (slot_count + 1 + sizeof(value_type) - 1) / sizeof(value_type);
+            }
+
+            // バケット数に応じた予備スロットの数(4 * log2(バケット数), 16 以上)
+            // 負荷率 0.875 での最大の距離は 2^20 バケットで50程度なので,
+            // ふつうのハッシュ関数ならあふれて作り直すことはまずない。
+            static size_type    default_probe_(size_type buckets) {
+                size_type   bits = 0;
+                while ((static_cast<size_type>(1) << bits) < buckets) { ++bits; }
+                size_type   probe = bits * 4 < 16 ? 16 : bits * 4;
+                return probe < max_probe_limit ? probe : max_probe_limit;
+            }
+
+            void        allocate_(table& t, size_type buckets, size_type probe) {
+                size_type   bits = 0;
+                while ((static_cast<size_type>(1) << bits) < buckets) { ++bits; }
+                t.bucket_count = static_cast<size_type>(1) << bits;
+                t.max_probe = probe;
+                t.slot_count = t.bucket_count + probe;
+                t.shift = std::numeric_limits<size_type>::digits - bits;
+                t.slots = value_allocator_.allocate(units_(t.slot_count));
+                t.marks = reinterpret_cast<unsigned char*>(t.slots + t.slot_count);
+                for (size_type i = 0; i < t.slot_count; ++i) {
+                    t.marks[i] = empty_mark;
+                }
+                t.marks[t.slot_count] = end_mark;
+            }
+
+            void        release_(table& t) {
+                if (t.slots != NULL) {
+                    value_allocator_.deallocate(t.slots, units_(t.slot_count));
+                }
+                t = null_table_();
+            }
+
+            void        destroy_all_(table& t) {
+                for (size_type i = 0; i < t.slot_count; ++i) {
+                    if (t.marks[i] != empty_mark) {
+                        destroy_value_(t.slots + i);
+                        t.marks[i] = empty_mark;
+                    }
+                }
+            }
+
+            // [[値の構築・移動]]
+
+            void    construct_value_(value_type* p, const value_type& x) {
+                value_allocator_.construct(p, x);
+            }
+
+            void    destroy_value_(value_type* p) {
+                value_allocator_.destroy(p);
+            }
+
+            // src の値を dst に移す(dst は未構築, 移した後 src は未構築)。
+            void    relocate_(value_type* dst, value_type* src) {
+                construct_value_(dst, *src);
+                destroy_value_(src);
+            }
+
+            bool    debug_valid_table_(const table& t, size_type& n) const {
+                if (t.marks[t.slot_count] != end_mark) { return false; }
+                for (size_type i = 0; i < t.slot_count; ++i) {
+                    size_type   m = t.marks[i];
+                    if (m == empty_mark) { continue; }
+                    if (m > t.max_probe || home_(t, hasher_(t.slots[i])) + m - 1 != i) {
+                        return false;
+                    }
+                    // 次の値はホーム位置にいるか, 距離が1だけ長いか短い
+                    if (i + 1 < t.slot_count && t.marks[i + 1] > m + 1) {
+                        return false;
+                    }
+                    ++n;
+                }
+                return true;
+            }
+    };
+}
+
+#endif
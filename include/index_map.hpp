@@ -0,0 +1,490 @@
+#ifndef INDEX_MAP_HPP
+# define INDEX_MAP_HPP
+# include "index_tree.hpp"
+# include "pair.hpp"
+# include "ft_algorithm.hpp"
+
+namespace ft {
+
+    // [index_map]
+    // ft::map と同じインターフェースを持つ, 添字でつないだ赤黒木(index_tree)を使ったmap。
+    // ノードは1本の配列に詰めて置かれ, リンクは32ビットの添字なので, 要素あたりのメモリが小さい。
+    // コピーはリンクの配列を memcpy するだけで, 木をたどらない。
+    // ft::map との違い:
+    // - 挿入は値への参照・ポインタを無効にする(配列が再確保されるので)。イテレータは無効にならない。
+    // - 削除は, 消した要素と配列の末尾にあった要素を指すイテレータを無効にする。
+    //   erase(position) は次の要素を指すイテレータを返すので, それで走査を続けるのは安全。
+    // - nth, distance, rank は O(n)。
+    template <
+        class Key,
+        class Value,
+        class KeyComparator = std::less<Key>,
+        class PairAllocator = std::allocator<ft::pair<const Key, Value> >
+    >
+    class index_map {
+        public:
+            typedef Key                                         key_type;
+            typedef Value                                       mapped_type;
+            typedef ft::pair<const key_type, mapped_type>       value_type;
+            typedef KeyComparator                               key_compare;
+            typedef PairAllocator                               allocator_type;
+            typedef index_map<key_type, mapped_type, key_compare, allocator_type>
+                                                                self_type;
+            typedef value_type&                                 reference;
+            typedef const value_type&                           const_reference;
+            typedef typename allocator_type::pointer            pointer;
+            typedef typename allocator_type::const_pointer      const_pointer;
+            typedef typename allocator_type::size_type          size_type;
+            typedef typename allocator_type::difference_type    difference_type;
+
+            // 配列に載る値の型
+            // (削除で末尾の要素を移すときに代入するので, キーと値の const を外す)
+            typedef ft::pair<
+                typename ft::remove_const<key_type>::type,
+                typename ft::remove_const<mapped_type>::type
+            >                                                   stored_type;
+
+            // index_tree と index_map を接続するコンパレータ
+            // (map の map_value_compare と同じもの)
+            class index_value_compare {
+                FT_PRIVATE:
+                    key_compare key_compare_;
+
+                public:
+                    index_value_compare()
+                        : key_compare_() {}
+
+                    explicit index_value_compare(key_compare c)
+                        : key_compare_(c) {}
+
+                    const key_compare&  key_comp() const { return key_compare_; }
+
+                    bool operator()(const value_type& x, const value_type& y) const {
+                        return key_compare_(x.first, y.first);
+                    }
+
+                    bool operator()(const value_type& x, const key_type& y) const {
+                        return key_compare_(x.first, y);
+                    }
+
+                    bool operator()(const key_type& x, const value_type& y) const {
+                        return key_compare_(x, y.first);
+                    }
+
+                    // Key以外の型との比較(transparent な場合)
+                    template <class K>
+                    bool operator()(const value_type& x, const K& y) const {
+                        return key_compare_(x.first, y);
+                    }
+
+                    template <class K>
+                    bool operator()(const K& x, const value_type& y) const {
+                        return key_compare_(x, y.first);
+                    }
+            };
+
+            // 内部index_tree
+            typedef ft::index_tree<value_type, stored_type, index_value_compare, allocator_type>
+                                                                base;
+            // index_tree のイテレータは (木, 添字) の組なので, そのまま使う。
+            typedef typename base::iterator                     iterator;
+            typedef typename base::const_iterator               const_iterator;
+            typedef ft::reverse_iterator<iterator>              reverse_iterator;
+            typedef ft::reverse_iterator<const_iterator>        const_reverse_iterator;
+
+            // pair<MK, MV> のコンパレータ
+            class value_compare {
+                friend class index_map;
+
+                protected:
+                    key_compare comp;
+
+                    value_compare(key_compare c): comp(c) {}
+
+                public:
+                    typedef bool        result_type;
+                    typedef value_type  first_argument_type;
+                    typedef value_type  second_argument_type;
+
+                    bool operator()(const value_type& x, const value_type& y) const {
+                        return comp(x.first, y.first);
+                    }
+            };
+
+        FT_PRIVATE:
+
+            // 内部index_tree
+            base    tree_;
+
+        public:
+
+            // [[コンストラクタ群]]
+
+            index_map(): tree_(index_value_compare(KeyComparator()), PairAllocator()) {}
+
+            explicit index_map(
+                const KeyComparator& comp
+            ): tree_(index_value_compare(comp), PairAllocator()) {}
+
+            explicit index_map(
+                const KeyComparator& comp,
+                const PairAllocator& alloc
+            ): tree_(index_value_compare(comp), alloc) {}
+
+            template <class InputIterator>
+            index_map(InputIterator first,
+                InputIterator last,
+                const KeyComparator& comp = KeyComparator(),
+                const PairAllocator& alloc = PairAllocator()
+            ): tree_(index_value_compare(comp), alloc) {
+                insert(first, last);
+            }
+
+            // [first, last) がソート済みかつ重複なしであれば, 線形時間で構築する。
+            template <class InputIterator>
+            index_map(ft::sorted_unique_t,
+                InputIterator first,
+                InputIterator last,
+                const KeyComparator& comp = KeyComparator(),
+                const PairAllocator& alloc = PairAllocator()
+            ): tree_(index_value_compare(comp), alloc) {
+                insert(ft::sorted_unique, first, last);
+            }
+
+            index_map(const self_type& other)
+                : tree_(other.tree_) {}
+
+            ~index_map() {}
+
+            self_type&      operator=(const self_type& rhs) {
+                if (this == &rhs) { return *this; }
+                tree_ = rhs.tree_;
+                return *this;
+            }
+
+            // [[getter群]]
+
+            allocator_type  get_allocator() const {
+                return allocator_type(tree_.get_allocator());
+            }
+
+            iterator                begin() { return tree_.begin(); }
+            const_iterator          begin() const { return tree_.begin(); }
+            iterator                end() { return tree_.end(); }
+            const_iterator          end() const { return tree_.end(); }
+            reverse_iterator        rbegin() { return reverse_iterator(end()); }
+            const_reverse_iterator  rbegin() const { return const_reverse_iterator(end()); }
+            reverse_iterator        rend() { return reverse_iterator(begin()); }
+            const_reverse_iterator  rend() const { return const_reverse_iterator(begin()); }
+
+            bool            empty() const { return tree_.empty(); }
+            size_type       size() const { return tree_.size(); }
+            size_type       max_size() const { return tree_.max_size(); }
+            size_type       capacity() const { return tree_.capacity(); }
+
+            // [[ライフサイクル]]
+
+            void            clear() { tree_.clear(); }
+
+            // n 要素分の領域を確保しておく(範囲挿入の前など)。
+            void            reserve(size_type n) { tree_.reserve(n); }
+
+            // [[挿入系関数群]]
+
+            pair<iterator, bool>    insert(const value_type& v) {
+                return tree_.insert(v);
+            }
+            iterator                insert(const_iterator hint, const value_type& v) {
+                return tree_.insert(hint, v);
+            }
+            // 前に入れた位置をヒントにするので, ソート済みなら探索しない。
+            template <class InputIterator>
+            void                    insert(InputIterator first, InputIterator last) {
+                tree_.insert(first, last);
+            }
+            // [first, last) がソート済みかつ重複なしであることを呼び出し側が保証する範囲挿入。
+            // 既存の要素より大きいキーばかりなら, 最大のノードの右につなぐだけ。
+            template <class InputIterator>
+            void                    insert(ft::sorted_unique_t, InputIterator first, InputIterator last) {
+                tree_.insert(ft::sorted_unique, first, last);
+            }
+
+            // [[削除]]
+
+            // 次の要素を指すイテレータを返す(削除で末尾の要素を指すイテレータは無効になるので)。
+            iterator     erase(const_iterator position) {
+                return tree_.erase(position);
+            }
+            size_type    erase(const key_type& x) {
+                return tree_.erase_by_key(x);
+            }
+            // key_compare が transparent なら, key_type を作らずに削除できる。
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, size_type, const_iterator>::type
+                         erase(const K& x) {
+                return tree_.erase_by_key(x);
+            }
+            iterator     erase(const_iterator first, const_iterator last) {
+                return tree_.erase(first, last);
+            }
+
+            void         swap(self_type& other) {
+                tree_.swap(other.tree_);
+            }
+
+            // [[分割・連結]]
+
+            // key 以上の要素をすべて out に移す。out の元の要素は破棄される。
+            void         split(const key_type& key, self_type& out) {
+                tree_.split(key, out.tree_);
+            }
+
+            // other の要素をすべて this に移し, other を空にする。
+            void         join(self_type& other) {
+                tree_.join(other.tree_);
+            }
+
+            // [[検索系関数]]
+
+            // 挿入位置を1回だけ探す(見つからなければ, その位置をヒントに挿入する)。
+            Value&          operator[](const key_type& x) {
+                iterator    it = tree_.lower_bound(x);
+                if (it == end() || key_comp()(x, it->first)) {
+                    it = tree_.insert(it, value_type(x, mapped_type()));
+                }
+                return it->second;
+            }
+
+            size_type       count(const key_type& x) const {
+                return tree_.count(x);
+            }
+
+            iterator        find(const key_type& x) {
+                return tree_.find(x);
+            }
+            const_iterator  find(const key_type& x) const {
+                return tree_.find(x);
+            }
+
+            pair<iterator, iterator>                equal_range(const key_type& x) {
+                return tree_.equal_range(x);
+            }
+            pair<const_iterator, const_iterator>    equal_range(const key_type& x) const {
+                return tree_.equal_range(x);
+            }
+
+            iterator                                lower_bound(const key_type& x) {
+                return tree_.lower_bound(x);
+            }
+            const_iterator                          lower_bound(const key_type& x) const {
+                return tree_.lower_bound(x);
+            }
+
+            iterator                                upper_bound(const key_type& x) {
+                return tree_.upper_bound(x);
+            }
+            const_iterator                          upper_bound(const key_type& x) const {
+                return tree_.upper_bound(x);
+            }
+
+            // [[ヒントつき検索]]
+            // hint が結果かその直前なら O(1)。そうでなければ根から探す。
+
+            iterator                                lower_bound(iterator hint, const key_type& x) {
+                return tree_.lower_bound(hint, x);
+            }
+            const_iterator                          lower_bound(const_iterator hint, const key_type& x) const {
+                return tree_.lower_bound(hint, x);
+            }
+
+            iterator                                find(iterator hint, const key_type& x) {
+                return tree_.find(hint, x);
+            }
+            const_iterator                          find(const_iterator hint, const key_type& x) const {
+                return tree_.find(hint, x);
+            }
+
+            // [[一括検索]]
+
+            // ソート済み(key_comp の順, 重複可)のキー列 [first, last) のそれぞれについて,
+            // find した結果(なければ end())を順に out に書き出す。
+            template <class InputIterator, class OutputIterator>
+            OutputIterator          find_sorted(InputIterator first, InputIterator last, OutputIterator out) {
+                return tree_.find_sorted(first, last, out);
+            }
+            template <class InputIterator, class OutputIterator>
+            OutputIterator          find_sorted(InputIterator first, InputIterator last, OutputIterator out) const {
+                return tree_.find_sorted(first, last, out);
+            }
+
+            // 順不同のキー列 [first, last) のそれぞれについて,
+            // find した結果(なければ end())を順に out に書き出す。
+            // Width 個の二分探索をそろえて進め, 次に読む位置をプリフェッチする。
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+                return tree_.template find_batch<Width>(first, last, out);
+            }
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+                return tree_.template find_batch<Width>(first, last, out);
+            }
+            // 幅を指定しない場合は8
+            template <class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+                return find_batch<8>(first, last, out);
+            }
+            template <class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+                return find_batch<8>(first, last, out);
+            }
+
+            // [[異種キーでの検索]]
+            // key_compare が is_transparent 型を持つなら, key_type と比較できる任意の型で検索できる。
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, size_type>::type
+                                                    count(const K& x) const {
+                return tree_.count(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, iterator>::type
+                                                    find(const K& x) {
+                return tree_.find(x);
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    find(const K& x) const {
+                return tree_.find(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, pair<iterator, iterator> >::type
+                                                    equal_range(const K& x) {
+                return tree_.equal_range(x);
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, pair<const_iterator, const_iterator> >::type
+                                                    equal_range(const K& x) const {
+                return tree_.equal_range(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, iterator>::type
+                                                    lower_bound(const K& x) {
+                return tree_.lower_bound(x);
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    lower_bound(const K& x) const {
+                return tree_.lower_bound(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, iterator>::type
+                                                    upper_bound(const K& x) {
+                return tree_.upper_bound(x);
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    upper_bound(const K& x) const {
+                return tree_.upper_bound(x);
+            }
+
+            // [[順序統計]]
+
+            // x より小さいキーを持つ要素の数
+            size_type                               rank(const key_type& x) const {
+                return tree_.rank(x);
+            }
+
+            // 先頭から i 番目(0始まり)の要素を返す。i >= size() なら end()。
+            iterator                                nth(size_type i) {
+                return tree_.select(i);
+            }
+            const_iterator                          nth(size_type i) const {
+                return tree_.select(i);
+            }
+
+            // first から last までの要素数 (std::distance と同じ結果)
+            difference_type                         distance(const_iterator first, const_iterator last) const {
+                return tree_.distance(first, last);
+            }
+
+            // 内部構造が正しいか(テスト用)
+            bool            debug_valid() const {
+                return tree_.debug_valid();
+            }
+
+            key_compare     key_comp() const {
+                return tree_.value_compare().key_comp();
+            }
+
+            value_compare   value_comp() const {
+                return value_compare(tree_.value_compare().key_comp());
+            }
+    };
+
+    // [比較演算子]
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator>
+    inline bool operator==(
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& lhs,
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& rhs
+    ) {
+        return lhs.size() == rhs.size()
+            && ft::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator>
+    inline bool operator!=(
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& lhs,
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& rhs
+    ) {
+        return !(lhs == rhs);
+    }
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator>
+    inline bool operator<(
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& lhs,
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& rhs
+    ) {
+        return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator>
+    inline bool operator<=(
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& lhs,
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& rhs
+    ) {
+        return !(lhs > rhs);
+    }
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator>
+    inline bool operator>(
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& lhs,
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& rhs
+    ) {
+        return rhs < lhs;
+    }
+
+    template <class Key, class Value, class KeyComparator, class PairAllocator>
+    inline bool operator>=(
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& lhs,
+        const ft::index_map<Key, Value, KeyComparator, PairAllocator>& rhs
+    ) {
+        return !(lhs < rhs);
+    }
+}
+
+namespace std {
+    template <class Key, class Value, class KeyComparator, class PairAllocator>
+    inline void swap(
+        ft::index_map<Key, Value, KeyComparator, PairAllocator>& lhs,
+        ft::index_map<Key, Value, KeyComparator, PairAllocator>& rhs
+    ) {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
@@ -0,0 +1,984 @@
+#ifndef INDEX_TREE_HPP
+# define INDEX_TREE_HPP
+
+# include "ft_common.hpp"
+# include "ft_meta_functions.hpp"
+# include "ft_iterator.hpp"
+# include "ft_algorithm.hpp"
+# include "pair.hpp"
+# include "vector.hpp"
+# include "tree.hpp"
+# include <memory>
+# include <cstddef>
+# include <cstring>
+# include <iterator>
+# include <stdexcept>
+
+namespace ft {
+
+    // index_tree (添字でつないだ赤黒木)
+    // tree と同じ赤黒木だが, ノードを1本の ft::vector に並べて持ち,
+    // 子・親をポインタではなく32ビットの添字でつなぐ。
+    // - リンクは 4バイト x 3 (親の添字の最上位ビットに色を埋め込む)。
+    //   tree のノード(ポインタ3個 + 色)の半分以下で, ノードごとの確保もない。
+    // - リンクと値は別々の配列に置く(添字が同じものが1つのノード)。
+    //   リンクの配列にはポインタがないので, コピーは memcpy で済み, そのまま書き出せる。
+    // - 配列は隙間なく詰める。削除したノードの位置には末尾のノードを移す。
+    // - イテレータは (木, 添字) の組なので, 挿入しても無効にならない
+    //   (配列が再確保されても添字は変わらない)。
+    //   ただし値への参照・ポインタは, 挿入による再確保で無効になる。
+    //   削除は, 消した要素と末尾のノードを指すイテレータを無効にする。
+    // - 値の移動(削除で末尾のノードを移すとき)は代入で行う。
+    //   値の代入が例外を投げないことを前提とする(btree の値の移動と同じ)。
+    // - ノード数は 2^31 - 1 個まで。
+    // キーの重複は許さない(index_map, index_set 用)。
+    template <
+        // 公開する値の型
+        // - index_map<MK, MV, MKC, MA>  -> pair<const MK, MV>
+        // - index_set<SK, SKC, SA>      -> SK
+        class Value,
+        // 配列に実際に載る値の型
+        // 末尾のノードを移すのに代入するので, const を外したもの。
+        // (Value と同じ配置であること)
+        class StoredValue,
+        // Valueのコンパレータ(tree と同じ)
+        class ValueComparator = std::less<Value>,
+        // Valueのアロケータ(StoredValue, リンク用に rebind して使う)
+        class ValueAllocator = std::allocator<Value>
+    >
+    class index_tree {
+        public:
+            typedef Value                                               value_type;
+            typedef StoredValue                                         stored_type;
+            typedef ValueComparator                                     value_comparator_type;
+            typedef typename ValueAllocator::template rebind<StoredValue>::other
+                                                                        stored_allocator_type;
+            typedef index_tree<Value, StoredValue, ValueComparator, ValueAllocator>
+                                                                        self_type;
+            typedef value_type&                                         reference;
+            typedef const value_type&                                   const_reference;
+            typedef value_type*                                         pointer;
+            typedef const value_type*                                   const_pointer;
+            typedef std::size_t                                         size_type;
+            typedef std::ptrdiff_t                                      difference_type;
+
+            // ノードの添字(32ビット)
+            typedef unsigned int                                        index_type;
+
+            // [ノードのリンク]
+            // ポインタを持たないので, memcpy でコピーできる。
+            struct link_type {
+                index_type  left;
+                index_type  right;
+                // 親の添字と色(最上位ビットが立っていれば黒)
+                index_type  parent_and_color;
+            };
+
+            typedef typename ValueAllocator::template rebind<link_type>::other
+                                                                        link_allocator_type;
+            typedef ft::vector<stored_type, stored_allocator_type>      value_container_type;
+            typedef ft::vector<link_type, link_allocator_type>          link_container_type;
+
+            // 子・親がないことを表す添字(end もこれ)
+            static const index_type nil = 0x7fffffffU;
+            static const index_type black_bit = 0x80000000U;
+
+            class const_iterator;
+
+            // [イテレータ]
+            // 木へのポインタとノードの添字の組。end の添字は nil。
+            class iterator {
+                public:
+                    typedef typename index_tree::value_type             value_type;
+                    typedef typename index_tree::difference_type        difference_type;
+                    typedef value_type*                                 pointer;
+                    typedef value_type&                                 reference;
+                    typedef std::bidirectional_iterator_tag             iterator_category;
+
+                    self_type*  tree_;
+                    index_type  index_;
+
+                    iterator(): tree_(NULL), index_(nil) {}
+                    iterator(self_type* tree, index_type index): tree_(tree), index_(index) {}
+
+                    reference   operator*() const { return tree_->value_at_(index_); }
+                    pointer     operator->() const { return &tree_->value_at_(index_); }
+
+                    iterator&   operator++() {
+                        index_ = tree_->next_(index_);
+                        return *this;
+                    }
+                    iterator    operator++(int) {
+                        iterator    it = *this;
+                        ++*this;
+                        return it;
+                    }
+                    iterator&   operator--() {
+                        index_ = tree_->prev_(index_);
+                        return *this;
+                    }
+                    iterator    operator--(int) {
+                        iterator    it = *this;
+                        --*this;
+                        return it;
+                    }
+
+                    bool        operator==(const iterator& rhs) const {
+                        return index_ == rhs.index_;
+                    }
+                    bool        operator!=(const iterator& rhs) const {
+                        return !(*this == rhs);
+                    }
+                    bool        operator==(const const_iterator& rhs) const {
+                        return index_ == rhs.index_;
+                    }
+                    bool        operator!=(const const_iterator& rhs) const {
+                        return !(*this == rhs);
+                    }
+            };
+
+            // [constイテレータ]
+            class const_iterator {
+                public:
+                    typedef typename index_tree::value_type             value_type;
+                    typedef typename index_tree::difference_type        difference_type;
+                    typedef const value_type*                           pointer;
+                    typedef const value_type&                           reference;
+                    typedef std::bidirectional_iterator_tag             iterator_category;
+
+                    const self_type*    tree_;
+                    index_type          index_;
+
+                    const_iterator(): tree_(NULL), index_(nil) {}
+                    const_iterator(const self_type* tree, index_type index): tree_(tree), index_(index) {}
+                    // これは explicit つけない
+                    const_iterator(const iterator& variable)
+                        : tree_(variable.tree_), index_(variable.index_) {}
+
+                    reference       operator*() const { return tree_->value_at_(index_); }
+                    pointer         operator->() const { return &tree_->value_at_(index_); }
+
+                    const_iterator& operator++() {
+                        index_ = tree_->next_(index_);
+                        return *this;
+                    }
+                    const_iterator  operator++(int) {
+                        const_iterator  it = *this;
+                        ++*this;
+                        return it;
+                    }
+                    const_iterator& operator--() {
+                        index_ = tree_->prev_(index_);
+                        return *this;
+                    }
+                    const_iterator  operator--(int) {
+                        const_iterator  it = *this;
+                        --*this;
+                        return it;
+                    }
+
+                    bool            operator==(const const_iterator& rhs) const {
+                        return index_ == rhs.index_;
+                    }
+                    bool            operator!=(const const_iterator& rhs) const {
+                        return !(*this == rhs);
+                    }
+            };
+
+        FT_PRIVATE:
+
+            // ノードのリンク(添字 i のノードは links_[i] と values_[i])
+            link_container_type     links_;
+            value_container_type    values_;
+            // 根の添字(空なら nil)
+            index_type              root_;
+            value_comparator_type   value_compare_;
+
+        public:
+
+            // [[コンストラクタ群]]
+
+            index_tree(
+                const value_comparator_type& comp,
+                const ValueAllocator& allocator
+            ):
+                links_(link_allocator_type(allocator)),
+                values_(stored_allocator_type(allocator)),
+                root_(nil),
+                value_compare_(comp) {}
+
+            // 木をたどらずに配列ごとコピーする。
+            // リンクはポインタを持たないので, そのまま memcpy する。
+            index_tree(const self_type& other):
+                links_(other.links_.get_allocator()),
+                values_(other.values_),
+                root_(other.root_),
+                value_compare_(other.value_compare_)
+            {
+                copy_links_(other);
+            }
+
+            ~index_tree() {}
+
+            self_type&  operator=(const self_type& rhs) {
+                if (this == &rhs) { return *this; }
+                values_ = rhs.values_;
+                copy_links_(rhs);
+                root_ = rhs.root_;
+                value_compare_ = rhs.value_compare_;
+                return *this;
+            }
+
+            // [[getter群]]
+
+            stored_allocator_type   get_allocator() const {
+                return values_.get_allocator();
+            }
+
+            const value_comparator_type&    value_compare() const {
+                return value_compare_;
+            }
+
+            iterator        begin() { return iterator(this, min_(root_)); }
+            const_iterator  begin() const { return const_iterator(this, min_(root_)); }
+            iterator        end() { return iterator(this, nil); }
+            const_iterator  end() const { return const_iterator(this, nil); }
+
+            bool            empty() const { return values_.empty(); }
+            size_type       size() const { return values_.size(); }
+            size_type       max_size() const {
+                size_type   n = values_.max_size();
+                return n < size_type(nil) ? n : size_type(nil);
+            }
+            size_type       capacity() const { return values_.capacity(); }
+
+            void            reserve(size_type n) {
+                values_.reserve(n);
+                links_.reserve(n);
+            }
+
+            void            clear() {
+                values_.clear();
+                links_.clear();
+                root_ = nil;
+            }
+
+            void            swap(self_type& other) {
+                links_.swap(other.links_);
+                values_.swap(other.values_);
+                ft::swap(root_, other.root_);
+                ft::swap(value_compare_, other.value_compare_);
+            }
+
+            // [[挿入]]
+
+            pair<iterator, bool>    insert(const value_type& v) {
+                index_type  parent = nil;
+                bool        to_left = true;
+                for (index_type i = root_; i != nil;) {
+                    parent = i;
+                    if (value_compare_(v, value_at_(i))) {
+                        to_left = true;
+                        i = links_[i].left;
+                    } else if (value_compare_(value_at_(i), v)) {
+                        to_left = false;
+                        i = links_[i].right;
+                    } else {
+                        return ft::make_pair(iterator(this, i), false);
+                    }
+                }
+                return ft::make_pair(iterator(this, attach_(parent, to_left, v)), true);
+            }
+
+            // hint の直前に入るなら, 探さずにつなぐ。
+            // (hint の前の要素 < v < hint なら, 前の要素の右か hint の左が空いている)
+            iterator                insert(const_iterator hint, const value_type& v) {
+                index_type  h = hint.index_;
+                if (h == nil || value_compare_(v, value_at_(h))) {
+                    index_type  before = prev_(h);
+                    if (before == nil) {
+                        if (root_ == nil) {
+                            return iterator(this, attach_(nil, true, v));
+                        }
+                        if (h != nil) {
+                            // hint が先頭
+                            return iterator(this, attach_(h, true, v));
+                        }
+                    } else if (value_compare_(value_at_(before), v)) {
+                        if (links_[before].right == nil) {
+                            return iterator(this, attach_(before, false, v));
+                        }
+                        return iterator(this, attach_(h, true, v));
+                    }
+                }
+                return insert(v).first;
+            }
+
+            // 最大のノードを覚えておき, それより大きい値はその右につなぐ(ソート済みなら探索しない)。
+            template <class InputIterator>
+            void                    insert(InputIterator first, InputIterator last) {
+                index_type  rightmost = max_(root_);
+                for (; first != last; ++first) {
+                    const value_type&   v = *first;
+                    if (rightmost == nil || value_compare_(value_at_(rightmost), v)) {
+                        rightmost = attach_(rightmost, false, v);
+                    } else {
+                        insert(v);
+                        rightmost = max_(root_);
+                    }
+                }
+            }
+
+            // [first, last) がソート済みかつ重複なしであることを呼び出し側が保証する範囲挿入。
+            // 既存の値のすべてより大きければ, 最大のノードの右につなぐだけ。
+            template <class InputIterator>
+            void                    insert(sorted_unique_t, InputIterator first, InputIterator last) {
+                insert(first, last);
+            }
+
+            // [[削除]]
+
+            // 次の要素を指すイテレータを返す。
+            iterator    erase(const_iterator position) {
+                index_type  z = position.index_;
+                index_type  next = next_(z);
+                unlink_(z);
+                index_type  moved = static_cast<index_type>(size() - 1);
+                fill_hole_(z);
+                if (next == moved) {
+                    next = z;
+                }
+                return iterator(this, next);
+            }
+
+            // 削除のたびに末尾のノードが移るので, 個数を数えてから消す。
+            iterator    erase(const_iterator first, const_iterator last) {
+                if (first == begin() && last == end()) {
+                    clear();
+                    return end();
+                }
+                size_type   n = 0;
+                for (const_iterator it = first; it != last; ++it) {
+                    ++n;
+                }
+                iterator    it(this, first.index_);
+                for (; n > 0; --n) {
+                    it = erase(it);
+                }
+                return it;
+            }
+
+            template <class Key>
+            size_type   erase_by_key(const Key& key) {
+                iterator    it = find(key);
+                if (it == end()) {
+                    return 0;
+                }
+                erase(it);
+                return 1;
+            }
+
+            // [[分割・連結]]
+            // 部分木の大きさを持たないので, 移す要素ごとに挿入・削除する。
+
+            // key 以上の値をすべて out に移す。out の元の値は破棄される。
+            template <class Key>
+            void        split(const Key& key, self_type& out) {
+                if (&out == this) { return; }
+                out.clear();
+                const_iterator  first = lower_bound(key);
+                out.insert(first, const_iterator(end()));
+                erase(first, end());
+            }
+
+            // other の値をすべて this に移し, other を空にする。
+            // 同じキーがあれば this の値が残る。
+            void        join(self_type& other) {
+                if (&other == this || other.empty()) { return; }
+                if (empty()) {
+                    // 値だけを引き取り, 比較関数はそれぞれ自分のものを残す
+                    swap(other);
+                    ft::swap(value_compare_, other.value_compare_);
+                    return;
+                }
+                insert(other.begin(), other.end());
+                other.clear();
+            }
+
+            // [[検索系]]
+
+            template <class Key>
+            iterator        lower_bound(const Key& key) {
+                return iterator(this, lower_index_(key));
+            }
+            template <class Key>
+            const_iterator  lower_bound(const Key& key) const {
+                return const_iterator(this, lower_index_(key));
+            }
+
+            template <class Key>
+            iterator        upper_bound(const Key& key) {
+                return iterator(this, upper_index_(key));
+            }
+            template <class Key>
+            const_iterator  upper_bound(const Key& key) const {
+                return const_iterator(this, upper_index_(key));
+            }
+
+            template <class Key>
+            iterator        find(const Key& key) {
+                return iterator(this, find_index_(key));
+            }
+            template <class Key>
+            const_iterator  find(const Key& key) const {
+                return const_iterator(this, find_index_(key));
+            }
+
+            template <class Key>
+            size_type       count(const Key& key) const {
+                return find_index_(key) == nil ? 0 : 1;
+            }
+
+            template <class Key>
+            pair<iterator, iterator>    equal_range(const Key& key) {
+                iterator    first = lower_bound(key);
+                iterator    last = first;
+                if (last != end() && !value_compare_(key, *last)) {
+                    ++last;
+                }
+                return ft::make_pair(first, last);
+            }
+            template <class Key>
+            pair<const_iterator, const_iterator>    equal_range(const Key& key) const {
+                pair<iterator, iterator>    r = const_cast<self_type*>(this)->equal_range(key);
+                return ft::make_pair(const_iterator(r.first), const_iterator(r.second));
+            }
+
+            // [[ヒントつき検索]]
+            // hint が答えかその直前なら O(1)。そうでなければ根から探す。
+
+            template <class Key>
+            iterator        lower_bound(const_iterator hint, const Key& key) {
+                index_type  h = hint.index_;
+                if (h != nil && !value_compare_(value_at_(h), key)) {
+                    index_type  before = prev_(h);
+                    if (before == nil || value_compare_(value_at_(before), key)) {
+                        return iterator(this, h);
+                    }
+                } else if (h != nil) {
+                    index_type  after = next_(h);
+                    if (after == nil || !value_compare_(value_at_(after), key)) {
+                        return iterator(this, after);
+                    }
+                }
+                return lower_bound(key);
+            }
+            template <class Key>
+            const_iterator  lower_bound(const_iterator hint, const Key& key) const {
+                return const_cast<self_type*>(this)->lower_bound(hint, key);
+            }
+
+            template <class Key>
+            iterator        find(const_iterator hint, const Key& key) {
+                iterator    it = lower_bound(hint, key);
+                if (it == end() || value_compare_(key, *it)) {
+                    return end();
+                }
+                return it;
+            }
+            template <class Key>
+            const_iterator  find(const_iterator hint, const Key& key) const {
+                return const_cast<self_type*>(this)->find(hint, key);
+            }
+
+            // ソート済みのキー列 [first, last) のそれぞれについて find した結果を out に書き出す。
+            // 前の結果をヒントにする。
+            template <class InputIterator, class OutputIterator>
+            OutputIterator  find_sorted(InputIterator first, InputIterator last, OutputIterator out) {
+                const_iterator  hint = begin();
+                for (; first != last; ++first, ++out) {
+                    iterator    lb = lower_bound(hint, *first);
+                    hint = lb;
+                    *out = (lb == end() || value_compare_(*first, *lb)) ? end() : lb;
+                }
+                return out;
+            }
+            template <class InputIterator, class OutputIterator>
+            OutputIterator  find_sorted(InputIterator first, InputIterator last, OutputIterator out) const {
+                return const_cast<self_type*>(this)->find_sorted(first, last, out);
+            }
+
+            // 順不同のキー列 [first, last) のそれぞれについて find した結果を out に書き出す。
+            // Width 個の探索を1段ずつそろえて進め, 次に読むノードの値をプリフェッチする。
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator  find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+                ForwardIterator keys[Width];
+                index_type      cursors[Width];
+                index_type      found[Width];
+                while (first != last) {
+                    std::size_t w = 0;
+                    for (; w < Width && first != last; ++w, ++first) {
+                        keys[w] = first;
+                        cursors[w] = root_;
+                        found[w] = nil;
+                    }
+                    for (std::size_t active = w; active > 0;) {
+                        active = 0;
+                        for (std::size_t i = 0; i < w; ++i) {
+                            index_type  c = cursors[i];
+                            if (c == nil) { continue; }
+                            if (value_compare_(*keys[i], value_at_(c))) {
+                                c = links_[c].left;
+                            } else if (value_compare_(value_at_(c), *keys[i])) {
+                                c = links_[c].right;
+                            } else {
+                                found[i] = c;
+                                c = nil;
+                            }
+                            if (c != nil) {
+                                FT_PREFETCH(&values_[c]);
+                                ++active;
+                            }
+                            cursors[i] = c;
+                        }
+                    }
+                    for (std::size_t i = 0; i < w; ++i, ++out) {
+                        *out = iterator(this, found[i]);
+                    }
+                }
+                return out;
+            }
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator  find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+                return const_cast<self_type*>(this)->template find_batch<Width>(first, last, out);
+            }
+
+            // [[順序統計]]
+            // 部分木の大きさを持たないので, どれも O(n)。
+
+            // key より小さい値の数
+            template <class Key>
+            size_type       rank(const Key& key) const {
+                return distance(begin(), lower_bound(key));
+            }
+
+            // 先頭から i 番目(0始まり)の値。i >= size() なら end()。
+            iterator        select(size_type i) {
+                if (i >= size()) { return end(); }
+                iterator    it = begin();
+                for (; i > 0; --i) { ++it; }
+                return it;
+            }
+            const_iterator  select(size_type i) const {
+                return const_cast<self_type*>(this)->select(i);
+            }
+
+            difference_type distance(const_iterator first, const_iterator last) const {
+                difference_type n = 0;
+                for (; first != last; ++first) { ++n; }
+                return n;
+            }
+
+            // 内部構造が正しいか(テスト用)
+            // - 親子のリンクが双方向に合っているか
+            // - 根が黒く, 赤いノードの子が赤くなく, 黒高さがそろっているか
+            // - 中間順に値が昇順か
+            // - すべてのノードが根から届くか
+            bool            debug_valid() const {
+                if (links_.size() != values_.size()) { return false; }
+                if (root_ == nil) { return empty(); }
+                if (root_ >= size() || parent_(root_) != nil || !is_black_(root_)) {
+                    return false;
+                }
+                size_type   reached = 0;
+                if (debug_black_height_(root_, reached) == 0 || reached != size()) {
+                    return false;
+                }
+                index_type  prev = nil;
+                for (index_type i = min_(root_); i != nil; i = next_(i)) {
+                    if (prev != nil && !value_compare_(value_at_(prev), value_at_(i))) {
+                        return false;
+                    }
+                    prev = i;
+                }
+                return true;
+            }
+
+        FT_PRIVATE:
+
+            // [[値・リンクへのアクセス]]
+
+            reference           value_at_(index_type i) {
+                return *reinterpret_cast<pointer>(values_.begin().base() + i);
+            }
+            const_reference     value_at_(index_type i) const {
+                return *reinterpret_cast<const_pointer>(values_.begin().base() + i);
+            }
+
+            index_type  parent_(index_type i) const {
+                return links_[i].parent_and_color & ~black_bit;
+            }
+            void        set_parent_(index_type i, index_type p) {
+                links_[i].parent_and_color = p | (links_[i].parent_and_color & black_bit);
+            }
+            // nil は黒
+            bool        is_black_(index_type i) const {
+                return i == nil || (links_[i].parent_and_color & black_bit) != 0;
+            }
+            void        set_black_(index_type i, bool black) {
+                if (black) {
+                    links_[i].parent_and_color |= black_bit;
+                } else {
+                    links_[i].parent_and_color &= ~black_bit;
+                }
+            }
+
+            // 親 p の, old を指していた子を node に付け替える(p が nil なら根)
+            void        replace_child_(index_type p, index_type old, index_type node) {
+                if (p == nil) {
+                    root_ = node;
+                } else if (links_[p].left == old) {
+                    links_[p].left = node;
+                } else {
+                    links_[p].right = node;
+                }
+            }
+
+            void        copy_links_(const self_type& other) {
+                links_.resize(other.links_.size());
+                if (!links_.empty()) {
+                    std::memcpy(
+                        links_.begin().base(), other.links_.begin().base(),
+                        links_.size() * sizeof(link_type)
+                    );
+                }
+            }
+
+            // [[たどる]]
+
+            index_type  min_(index_type i) const {
+                if (i == nil) { return nil; }
+                while (links_[i].left != nil) { i = links_[i].left; }
+                return i;
+            }
+
+            index_type  max_(index_type i) const {
+                if (i == nil) { return nil; }
+                while (links_[i].right != nil) { i = links_[i].right; }
+                return i;
+            }
+
+            // 次のノード(最後なら nil)
+            index_type  next_(index_type i) const {
+                if (links_[i].right != nil) {
+                    return min_(links_[i].right);
+                }
+                index_type  p = parent_(i);
+                while (p != nil && links_[p].right == i) {
+                    i = p;
+                    p = parent_(p);
+                }
+                return p;
+            }
+
+            // 前のノード(nil の前は最大のノード)
+            index_type  prev_(index_type i) const {
+                if (i == nil) {
+                    return max_(root_);
+                }
+                if (links_[i].left != nil) {
+                    return max_(links_[i].left);
+                }
+                index_type  p = parent_(i);
+                while (p != nil && links_[p].left == i) {
+                    i = p;
+                    p = parent_(p);
+                }
+                return p;
+            }
+
+            // [[探索]]
+
+            template <class Key>
+            index_type  lower_index_(const Key& key) const {
+                index_type  rv = nil;
+                for (index_type i = root_; i != nil;) {
+                    if (value_compare_(value_at_(i), key)) {
+                        i = links_[i].right;
+                    } else {
+                        rv = i;
+                        i = links_[i].left;
+                    }
+                }
+                return rv;
+            }
+
+            template <class Key>
+            index_type  upper_index_(const Key& key) const {
+                index_type  rv = nil;
+                for (index_type i = root_; i != nil;) {
+                    if (value_compare_(key, value_at_(i))) {
+                        rv = i;
+                        i = links_[i].left;
+                    } else {
+                        i = links_[i].right;
+                    }
+                }
+                return rv;
+            }
+
+            template <class Key>
+            index_type  find_index_(const Key& key) const {
+                index_type  i = lower_index_(key);
+                if (i == nil || value_compare_(key, value_at_(i))) {
+                    return nil;
+                }
+                return i;
+            }
+
+            // [[挿入・削除の下請け]]
+
+            // v のコピーを末尾に置き, parent の子(to_left なら左)としてつないで均衡を直す。
+            index_type  attach_(index_type parent, bool to_left, const value_type& v) {
+                if (size() >= nil - 1) {
+                    throw std::length_error("index_tree");
+                }
+                values_.push_back(stored_type(v));
+                link_type   link = { nil, nil, parent };
+                try {
+                    links_.push_back(link);
+                } catch (...) {
+                    values_.pop_back();
+                    throw;
+                }
+                index_type  z = static_cast<index_type>(size() - 1);
+                if (parent == nil) {
+                    root_ = z;
+                } else if (to_left) {
+                    links_[parent].left = z;
+                } else {
+                    links_[parent].right = z;
+                }
+                insert_fixup_(z);
+                return z;
+            }
+
+            void        rotate_left_(index_type x) {
+                index_type  y = links_[x].right;
+                links_[x].right = links_[y].left;
+                if (links_[y].left != nil) {
+                    set_parent_(links_[y].left, x);
+                }
+                set_parent_(y, parent_(x));
+                replace_child_(parent_(x), x, y);
+                links_[y].left = x;
+                set_parent_(x, y);
+            }
+
+            void        rotate_right_(index_type x) {
+                index_type  y = links_[x].left;
+                links_[x].left = links_[y].right;
+                if (links_[y].right != nil) {
+                    set_parent_(links_[y].right, x);
+                }
+                set_parent_(y, parent_(x));
+                replace_child_(parent_(x), x, y);
+                links_[y].right = x;
+                set_parent_(x, y);
+            }
+
+            // 赤いノード z をつないだ後の均衡の回復
+            void        insert_fixup_(index_type z) {
+                while (z != root_ && !is_black_(parent_(z))) {
+                    index_type  p = parent_(z);
+                    index_type  g = parent_(p);
+                    if (p == links_[g].left) {
+                        index_type  u = links_[g].right;
+                        if (!is_black_(u)) {
+                            set_black_(p, true);
+                            set_black_(u, true);
+                            set_black_(g, false);
+                            z = g;
+                            continue;
+                        }
+                        if (z == links_[p].right) {
+                            z = p;
+                            rotate_left_(z);
+                            p = parent_(z);
+                        }
+                        set_black_(p, true);
+                        set_black_(g, false);
+                        rotate_right_(g);
+                    } else {
+                        index_type  u = links_[g].left;
+                        if (!is_black_(u)) {
+                            set_black_(p, true);
+                            set_black_(u, true);
+                            set_black_(g, false);
+                            z = g;
+                            continue;
+                        }
+                        if (z == links_[p].left) {
+                            z = p;
+                            rotate_right_(z);
+                            p = parent_(z);
+                        }
+                        set_black_(p, true);
+                        set_black_(g, false);
+                        rotate_left_(g);
+                    }
+                }
+                set_black_(root_, true);
+            }
+
+            // z を木から外して均衡を直す(配列からはまだ消さない)。
+            // 子が2つなら, 後隣接ノードを z の位置に付け替える。
+            void        unlink_(index_type z) {
+                index_type  y = z;
+                index_type  x;
+                index_type  x_parent;
+                if (links_[z].left == nil) {
+                    x = links_[z].right;
+                } else if (links_[z].right == nil) {
+                    x = links_[z].left;
+                } else {
+                    y = min_(links_[z].right);
+                    x = links_[y].right;
+                }
+                if (y != z) {
+                    // y を z の位置に移す
+                    set_parent_(links_[z].left, y);
+                    links_[y].left = links_[z].left;
+                    if (y != links_[z].right) {
+                        x_parent = parent_(y);
+                        if (x != nil) {
+                            set_parent_(x, x_parent);
+                        }
+                        links_[x_parent].left = x;
+                        links_[y].right = links_[z].right;
+                        set_parent_(links_[z].right, y);
+                    } else {
+                        x_parent = y;
+                    }
+                    replace_child_(parent_(z), z, y);
+                    set_parent_(y, parent_(z));
+                    // 色は位置に付くので入れ替える(外れるのは z の色)
+                    bool    y_was_black = is_black_(y);
+                    set_black_(y, is_black_(z));
+                    set_black_(z, y_was_black);
+                } else {
+                    x_parent = parent_(z);
+                    if (x != nil) {
+                        set_parent_(x, x_parent);
+                    }
+                    replace_child_(x_parent, z, x);
+                }
+                if (is_black_(z)) {
+                    erase_fixup_(x, x_parent);
+                }
+            }
+
+            // 黒いノードが外れて, x (nil もありうる) の側の黒高さが1足りない状態を直す。
+            void        erase_fixup_(index_type x, index_type x_parent) {
+                while (x != root_ && is_black_(x)) {
+                    if (x == links_[x_parent].left) {
+                        index_type  w = links_[x_parent].right;
+                        if (!is_black_(w)) {
+                            set_black_(w, true);
+                            set_black_(x_parent, false);
+                            rotate_left_(x_parent);
+                            w = links_[x_parent].right;
+                        }
+                        if (is_black_(links_[w].left) && is_black_(links_[w].right)) {
+                            set_black_(w, false);
+                            x = x_parent;
+                            x_parent = parent_(x);
+                            continue;
+                        }
+                        if (is_black_(links_[w].right)) {
+                            set_black_(links_[w].left, true);
+                            set_black_(w, false);
+                            rotate_right_(w);
+                            w = links_[x_parent].right;
+                        }
+                        set_black_(w, is_black_(x_parent));
+                        set_black_(x_parent, true);
+                        if (links_[w].right != nil) {
+                            set_black_(links_[w].right, true);
+                        }
+                        rotate_left_(x_parent);
+                        x = root_;
+                    } else {
+                        index_type  w = links_[x_parent].left;
+                        if (!is_black_(w)) {
+                            set_black_(w, true);
+                            set_black_(x_parent, false);
+                            rotate_right_(x_parent);
+                            w = links_[x_parent].left;
+                        }
+                        if (is_black_(links_[w].right) && is_black_(links_[w].left)) {
+                            set_black_(w, false);
+                            x = x_parent;
+                            x_parent = parent_(x);
+                            continue;
+                        }
+                        if (is_black_(links_[w].left)) {
+                            set_black_(links_[w].right, true);
+                            set_black_(w, false);
+                            rotate_left_(w);
+                            w = links_[x_parent].left;
+                        }
+                        set_black_(w, is_black_(x_parent));
+                        set_black_(x_parent, true);
+                        if (links_[w].left != nil) {
+                            set_black_(links_[w].left, true);
+                        }
+                        rotate_right_(x_parent);
+                        x = root_;
+                    }
+                }
+                if (x != nil) {
+                    set_black_(x, true);
+                }
+            }
+
+            // 木から外したノード hole の位置に末尾のノードを移し, 配列を1つ縮める。
+            void        fill_hole_(index_type hole) {
+                index_type  last = static_cast<index_type>(size() - 1);
+                if (hole != last) {
+                    values_[hole] = values_[last];
+                    links_[hole] = links_[last];
+                    replace_child_(parent_(hole), last, hole);
+                    if (links_[hole].left != nil) {
+                        set_parent_(links_[hole].left, hole);
+                    }
+                    if (links_[hole].right != nil) {
+                        set_parent_(links_[hole].right, hole);
+                    }
+                }
+                values_.pop_back();
+                links_.pop_back();
+            }
+
+            // i を根とする部分木の黒高さ(赤黒木の条件を満たさなければ0)
+            // reached には部分木のノード数を足す。
+            size_type   debug_black_height_(index_type i, size_type& reached) const {
+                if (i == nil) { return 1; }
+                if (i >= size() || ++reached > size()) { return 0; }
+                index_type  l = links_[i].left;
+                index_type  r = links_[i].right;
+                if ((l != nil && parent_(l) != i) || (r != nil && parent_(r) != i)) {
+                    return 0;
+                }
+                if (!is_black_(i) && (!is_black_(l) || !is_black_(r))) {
+                    return 0;
+                }
+                size_type   lh = debug_black_height_(l, reached);
+                size_type   rh = debug_black_height_(r, reached);
+                if (lh == 0 || lh != rh) { return 0; }
+                return lh + (is_black_(i) ? 1 : 0);
+            }
+    };
+}
+
+#endif
@@ -28,10 +28,10 @@ namespace ft {
                 >::type* = NULL) FT_NOEXCEPT
                 : base_(u.operator->()) {}
             // ~iterator_wrapper() {}
-            // iterator_wrapper&   operator=(const iterator_wrapper& other) FT_NOEXCEPT {
-            //     base_ = other.base_;
-            //     return *this;
-            // }
+            iterator_wrapper&   operator=(const iterator_wrapper& other) FT_NOEXCEPT {
+                base_ = other.base_;
+                return *this;
+            }
 
             iterator_type   base() const FT_NOEXCEPT { return base_; }
 
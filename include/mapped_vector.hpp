@@ -0,0 +1,388 @@
+#ifndef MAPPED_VECTOR_HPP
+# define MAPPED_VECTOR_HPP
+
+# include "ft_common.hpp"
+# include "ft_memory.hpp"
+# include "vector.hpp"
+# include <cstddef>
+# include <cstring>
+# include <string>
+# include <stdint.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+
+// 先に書いたメモリへの書き込みが, 後の書き込みより後回しにされないようにする
+// (コンパイラにも CPU にも並べ替えさせない)。
+# if defined(__GNUC__)
+#  define FT_STORE_FENCE() __sync_synchronize()
+# else
+#  define FT_STORE_FENCE() ((void)0)
+# endif
+
+namespace ft {
+
+    // [mapped_vector]
+    // 要素をファイルに置く(ファイルを mmap した領域を使う) vector。
+    // 開き直すと, 中身を読み込むことも解釈することもなく, そのまま前回の要素が見える
+    // (ファイルの大きさに関係なく, 開くのにかかる時間は一定。ページは触れたときに読まれる)。
+    // 要素の型は trivially copyable でなければならない(バイト列をそのまま保存するので)。
+    // ポインタを持つ型は保存できても, 開き直したときには意味がないことに注意。
+    //
+    // ファイルの形式:
+    //   [ヘッダ: 目印, ヘッダの大きさ, 要素の大きさ, 要素数][要素 0][要素 1]...
+    //   目印のあとの3つは 64 ビットの符号なし整数(long の大きさによらない)。
+    //   ヘッダの大きさは作ったときのページの大きさで, 要素の先頭はページ境界に来る。
+    //   (ヘッダに書いておくので, ページの大きさが違う環境でも開ける)
+    //   容量はファイルの大きさから決まる(ヘッダには持たない)。
+    // 要素数の整合性:
+    // - 要素を書いてから要素数を書く(減らすときは要素数を先に書く)ので,
+    //   プロセスがどこで落ちても, 要素数が書き終わっていない要素を含むことはない。
+    // - 伸ばすときはファイルを伸ばしてから要素数を書くので, 要素数が容量を超えることもない
+    //   (ファイルが外から切り詰められていたら, 開くときに要素数を容量に切り詰める)。
+    // - ヘッダの目印は最後に書くので, 作る途中で落ちたファイルは空のものとして作り直す。
+    //   (作り直すのは, 1ページで, 自分が書くはずの値と0のほかに何も書かれていないファイルだけ。
+    //    先頭が0なだけのほかのファイルを上書きすることはない)
+    // - OS ごと落ちる場合に備えるなら sync() を呼ぶ。sync() が戻った時点の中身はディスクにある。
+    // 失敗すると std::runtime_error を投げる(ファイルを伸ばせなかったときも)。
+    template < class T, class GrowthPolicy = ft::vector_growth_double >
+    class mapped_vector {
+        public:
+            typedef T                                           value_type;
+            typedef std::size_t                                 size_type;
+            typedef std::ptrdiff_t                              difference_type;
+            typedef value_type&                                 reference;
+            typedef const value_type&                           const_reference;
+            typedef value_type*                                 pointer;
+            typedef const value_type*                           const_pointer;
+            typedef ft::iterator_wrapper<pointer>               iterator;
+            typedef ft::iterator_wrapper<const_pointer>         const_iterator;
+            typedef ft::reverse_iterator<iterator>              reverse_iterator;
+            typedef ft::reverse_iterator<const_iterator>        const_reverse_iterator;
+
+        FT_PRIVATE:
+            typedef char    value_type_must_be_trivially_copyable[
+                ft::is_trivially_relocatable<value_type>::value
+                    && !ft::is_pointer<value_type>::value ? 1 : -1
+            ];
+
+            struct header_type {
+                char                magic[8];
+                uint64_t            header_bytes;
+                uint64_t            element_size;
+                volatile uint64_t   size;
+            };
+
+            int         fd_;
+            void*       map_;
+            std::size_t map_bytes_;
+            std::size_t header_bytes_;
+            size_type   capacity_;
+            size_type   size_;
+
+        public:
+            // [コンストラクタ]
+            // 引数なしなら何も開かない(open で開く)。
+            // パスを渡すと open(path) する。
+            mapped_vector()
+                : fd_(-1), map_(NULL), map_bytes_(0), header_bytes_(0), capacity_(0), size_(0) {}
+            explicit mapped_vector(const std::string& path)
+                : fd_(-1), map_(NULL), map_bytes_(0), header_bytes_(0), capacity_(0), size_(0) {
+                open(path);
+            }
+
+            // [デストラクタ]
+            // 閉じるだけで, ファイルは消さない。
+            ~mapped_vector() {
+                close();
+            }
+
+            // [open]
+            // ファイルを開いて対応づける。なければ空のものを作る。
+            // 既にあれば, ヘッダを確かめて対応づけるだけ(要素を読むことはない)。
+            // 別の型・別の形式のファイルなら std::runtime_error を投げる。
+            void    open(const std::string& path) {
+                close();
+                int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+                if (fd < 0) {
+                    throw std::runtime_error("mapped_vector: cannot open " + path);
+                }
+                struct stat st;
+                if (::fstat(fd, &st) != 0) {
+                    ::close(fd);
+                    throw std::runtime_error("mapped_vector: cannot stat " + path);
+                }
+                std::size_t bytes = static_cast<std::size_t>(st.st_size);
+                if (bytes == 0) {
+                    bytes = page_size_();
+                    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                        ::close(fd);
+                        throw std::runtime_error("mapped_vector: cannot extend " + path);
+                    }
+                } else if (bytes < sizeof(header_type)) {
+                    ::close(fd);
+                    throw std::runtime_error("mapped_vector: broken file " + path);
+                }
+                void*   p = ::mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (p == MAP_FAILED) {
+                    ::close(fd);
+                    throw std::runtime_error("mapped_vector: cannot map " + path);
+                }
+                header_type*    h = static_cast<header_type*>(p);
+                if (is_blank_(h, bytes)) {
+                    // 新しく作ったファイル(作る途中で落ちたものも, ここからやり直す)
+                    // 目印は最後に書く(目印があれば, ほかのヘッダの値は書き終わっている)
+                    h->header_bytes = bytes;
+                    h->element_size = sizeof(value_type);
+                    h->size = 0;
+                    FT_STORE_FENCE();
+                    std::memcpy(h->magic, magic_(), sizeof(h->magic));
+                } else if (
+                    std::memcmp(h->magic, magic_(), sizeof(h->magic)) != 0
+                    || h->element_size != sizeof(value_type)
+                    || !is_valid_header_size_(h->header_bytes)
+                ) {
+                    ::munmap(p, bytes);
+                    ::close(fd);
+                    throw std::runtime_error("mapped_vector: not a mapped_vector of this type " + path);
+                } else if (h->header_bytes > bytes) {
+                    ::munmap(p, bytes);
+                    ::close(fd);
+                    throw std::runtime_error("mapped_vector: broken file " + path);
+                }
+                fd_ = fd;
+                map_ = p;
+                map_bytes_ = bytes;
+                header_bytes_ = static_cast<std::size_t>(h->header_bytes);
+                capacity_ = (bytes - header_bytes_) / sizeof(value_type);
+                size_ = h->size < capacity_ ? static_cast<size_type>(h->size) : capacity_;
+            }
+
+            // [close]
+            // 対応づけを外してファイルを閉じる。開いていなければ何もしない。
+            // (書いた要素は, sync() しなくても, 閉じる前にすでにファイルに反映されている)
+            void    close() {
+                if (map_ == NULL) { return; }
+                ::munmap(map_, map_bytes_);
+                ::close(fd_);
+                fd_ = -1;
+                map_ = NULL;
+                map_bytes_ = 0;
+                header_bytes_ = 0;
+                capacity_ = 0;
+                size_ = 0;
+            }
+
+            bool    is_open() const {
+                return map_ != NULL;
+            }
+
+            // [sync]
+            // 中身をディスクに書き出す。要素を先に, ヘッダを後に書くので,
+            // OS ごと落ちても, 最後に sync() したときより古い要素数になることはない。
+            // (msync はページ境界からしか呼べない。今のページより小さいヘッダのファイルでは,
+            // ヘッダと先頭の要素が同じページに入るので, そのページはまとめて書き出す)
+            void    sync() {
+                if (map_ == NULL) { return; }
+                char*       base = static_cast<char*>(map_);
+                std::size_t page = page_size_();
+                std::size_t data_from = header_bytes_ / page * page;
+                if (
+                    (data_from > 0 && ::msync(base + data_from, map_bytes_ - data_from, MS_SYNC) != 0)
+                    || ::msync(base, data_from > 0 ? data_from : map_bytes_, MS_SYNC) != 0
+                ) {
+                    throw std::runtime_error("mapped_vector: msync failed");
+                }
+            }
+
+            // ヘッダの大きさ(ファイルの先頭から要素までのバイト数)。開いていなければ 0
+            std::size_t header_bytes() const {
+                return header_bytes_;
+            }
+
+            // [イテレータ]
+            iterator                begin() { return iterator(data_()); }
+            const_iterator          begin() const { return const_iterator(data_()); }
+            iterator                end() { return iterator(data_() + size_); }
+            const_iterator          end() const { return const_iterator(data_() + size_); }
+            reverse_iterator        rbegin() { return reverse_iterator(end()); }
+            const_reverse_iterator  rbegin() const { return const_reverse_iterator(end()); }
+            reverse_iterator        rend() { return reverse_iterator(begin()); }
+            const_reverse_iterator  rend() const { return const_reverse_iterator(begin()); }
+
+            // [要素アクセス]
+            reference   operator[](size_type pos) { return data_()[pos]; }
+            const_reference operator[](size_type pos) const { return data_()[pos]; }
+            reference   at(size_type pos) {
+                if (pos >= size_) {
+                    throw std::out_of_range("mapped_vector");
+                }
+                return data_()[pos];
+            }
+            const_reference at(size_type pos) const {
+                if (pos >= size_) {
+                    throw std::out_of_range("mapped_vector");
+                }
+                return data_()[pos];
+            }
+            reference       front() { return data_()[0]; }
+            const_reference front() const { return data_()[0]; }
+            reference       back() { return data_()[size_ - 1]; }
+            const_reference back() const { return data_()[size_ - 1]; }
+            pointer         data() { return data_(); }
+            const_pointer   data() const { return data_(); }
+
+            // [容量]
+            bool        empty() const { return size_ == 0; }
+            size_type   size() const { return size_; }
+            size_type   capacity() const { return capacity_; }
+            size_type   max_size() const {
+                return (static_cast<size_type>(std::numeric_limits<off_t>::max()) - header_bytes_)
+                    / sizeof(value_type);
+            }
+
+            // [reserve]
+            // ファイルを伸ばし(ftruncate), 対応づけた領域も伸ばす(mremap)。
+            // 伸ばした分のファイルは0で埋まっていて, ディスクの領域はまだ使わない。
+            void    reserve(size_type new_cap) {
+                if (new_cap <= capacity_) { return; }
+                if (map_ == NULL) {
+                    throw std::runtime_error("mapped_vector: not open");
+                }
+                if (new_cap > max_size()) {
+                    throw std::length_error("mapped_vector");
+                }
+                std::size_t new_bytes = header_bytes_ + new_cap * sizeof(value_type);
+                if (::ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0) {
+                    throw std::runtime_error("mapped_vector: cannot extend file");
+                }
+                remap_(new_bytes);
+                capacity_ = new_cap;
+            }
+
+            // [変更]
+            void    clear() {
+                publish_size_(0);
+            }
+
+            void    push_back(const_reference value) {
+                if (size_ == capacity_) {
+                    // value が自分の要素でも, 伸ばしたあとに読めるように写しておく
+                    value_type  v(value);
+                    reserve(recommended_capacity_(size_ + 1));
+                    data_()[size_] = v;
+                } else {
+                    data_()[size_] = value;
+                }
+                publish_size_(size_ + 1);
+            }
+
+            void    pop_back() {
+                publish_size_(size_ - 1);
+            }
+
+            void    resize(size_type count, value_type value = value_type()) {
+                if (count > size_) {
+                    if (count > capacity_) {
+                        reserve(recommended_capacity_(count));
+                    }
+                    std::fill(data_() + size_, data_() + count, value);
+                }
+                publish_size_(count);
+            }
+
+        FT_PRIVATE:
+            // コピーはできない(同じファイルを2つで書き換えることになるので)
+            mapped_vector(const mapped_vector&);
+            mapped_vector&  operator=(const mapped_vector&);
+
+            static const char*  magic_() {
+                return "ftmvec2";
+            }
+
+            static std::size_t  page_size_() {
+                long    page = ::sysconf(_SC_PAGESIZE);
+                return page > 0 ? static_cast<std::size_t>(page) : 4096;
+            }
+
+            // どこかの環境のページの大きさ(ヘッダが入る大きさの2のべき)か
+            static bool         is_valid_header_size_(uint64_t bytes) {
+                return bytes >= sizeof(header_type) && (bytes & (bytes - 1)) == 0;
+            }
+
+            // ヘッダだけで, 目印がまだ書かれていない(今の環境で作る途中で落ちた)。
+            // 目印のほかのヘッダの値は, 0 か, 作るときに書く値でなければならず,
+            // ヘッダの後ろ(ページの残り)はすべて 0 でなければならない。
+            static bool         is_blank_(const header_type* h, std::size_t bytes) {
+                if (bytes != page_size_()) { return false; }
+                if (
+                    (h->header_bytes != 0 && h->header_bytes != bytes)
+                    || (h->element_size != 0 && h->element_size != sizeof(value_type))
+                    || h->size != 0
+                ) {
+                    return false;
+                }
+                for (std::size_t i = 0; i < sizeof(h->magic); ++i) {
+                    if (h->magic[i] != '\0') { return false; }
+                }
+                const char* rest = reinterpret_cast<const char*>(h);
+                for (std::size_t i = sizeof(header_type); i < bytes; ++i) {
+                    if (rest[i] != '\0') { return false; }
+                }
+                return true;
+            }
+
+            header_type*    header_() const {
+                return static_cast<header_type*>(map_);
+            }
+
+            pointer         data_() const {
+                if (map_ == NULL) { return NULL; }
+                return reinterpret_cast<pointer>(static_cast<char*>(map_) + header_bytes_);
+            }
+
+            // 要素数を変え, ファイルにも書く。
+            // それまでの要素の書き込みが済んでから書く(途中で落ちても, 書いていない要素は見えない)。
+            void    publish_size_(size_type n) {
+                FT_STORE_FENCE();
+                header_()->size = n;
+                size_ = n;
+            }
+
+            // 空からは1ページ分に伸ばし, あとは GrowthPolicy に従う
+            // (n 個が今の容量に収まるなら, 今の容量のまま)
+            size_type   recommended_capacity_(size_type n) const {
+                if (n <= capacity_) { return capacity_; }
+                if (n > max_size()) {
+                    throw std::length_error("mapped_vector");
+                }
+                size_type   c = GrowthPolicy::next_capacity(capacity_, n, sizeof(value_type));
+                size_type   least = header_bytes_ / sizeof(value_type);
+                if (c < least) { c = least; }
+                if (c < n) { c = n; }
+                if (c > max_size()) { c = max_size(); }
+                return c;
+            }
+
+            void    remap_(std::size_t new_bytes) {
+# ifdef FT_HAVE_MREMAP
+                void*   p = ::mremap(map_, map_bytes_, new_bytes, MREMAP_MAYMOVE);
+                if (p == MAP_FAILED) {
+                    throw std::runtime_error("mapped_vector: mremap failed");
+                }
+# else
+                // 新しく対応づけてから古いものを外す(失敗しても古いものは使える)
+                void*   p = ::mmap(NULL, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+                if (p == MAP_FAILED) {
+                    throw std::runtime_error("mapped_vector: cannot map");
+                }
+                ::munmap(map_, map_bytes_);
+# endif
+                map_ = p;
+                map_bytes_ = new_bytes;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef MMAP_ALLOCATOR_HPP
+# define MMAP_ALLOCATOR_HPP
+
+# include "ft_common.hpp"
+# include "ft_memory.hpp"
+# include <cstddef>
+# include <new>
+
+namespace ft {
+
+    // [mmap_allocator]
+    // 大きな領域(FT_MREMAP_THRESHOLD 以上)を, 無名 mmap から直接確保するアロケータ。
+    // それより小さい領域は malloc から確保する。
+    // - 解放すると munmap ですぐに OS に返る(malloc のように手元に残らない)
+    // - ft::vector は, 要素が trivially relocatable なら, この領域を mremap で伸ばす
+    //   (コピーも, 伸ばす途中で新旧2つ分のメモリを持つことも起きない。
+    //   mremap は Linux のみで, ほかの環境では新しく mmap してコピーする)
+    // mmap がない環境(POSIX でない)では, すべて malloc から確保する。
+    // Options: mmap_option の組み合わせ(ヒュージページを使うかどうか)
+    // 状態を持たないので, 同じ型のものはすべて等しい。
+    template <class T, unsigned Options = ft::mmap_default>
+    class mmap_allocator {
+        public:
+            typedef T                   value_type;
+            typedef T*                  pointer;
+            typedef const T*            const_pointer;
+            typedef T&                  reference;
+            typedef const T&            const_reference;
+            typedef std::size_t         size_type;
+            typedef std::ptrdiff_t      difference_type;
+            typedef ft::basic_relocatable_storage<Options>  storage_type;
+
+            template <class U>
+            struct rebind { typedef mmap_allocator<U, Options> other; };
+
+            // コピー・代入・デストラクタは暗黙のもの(状態がないので何もしない)
+            mmap_allocator() FT_NOEXCEPT {}
+            template <class U>
+            mmap_allocator(const mmap_allocator<U, Options>&) FT_NOEXCEPT {}
+
+            pointer         address(reference x) const { return &x; }
+            const_pointer   address(const_reference x) const { return &x; }
+
+            // 確保できなければ std::bad_alloc を投げる。
+            pointer allocate(size_type n, const void* = 0) {
+                if (n > max_size()) {
+                    throw std::bad_alloc();
+                }
+                return static_cast<pointer>(storage_type::allocate(bytes_(n)));
+            }
+
+            void    deallocate(pointer p, size_type n) {
+                storage_type::deallocate(p, bytes_(n));
+            }
+
+            size_type   max_size() const {
+                return size_type(-1) / sizeof(value_type);
+            }
+
+            void    construct(pointer p, const_reference value) {
+                ::new(static_cast<void*>(p)) value_type(value);
+            }
+# ifdef FT_CXX11
+            template <class U, class... Args>
+            void    construct(U* p, Args&&... args) {
+                ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+            }
+# endif
+
+            void    destroy(pointer p) {
+                p->~value_type();
+            }
+
+        FT_PRIVATE:
+            // 0 個でも有効なポインタを返すように, 1 個分は確保する
+            static std::size_t  bytes_(size_type n) {
+                return (n == 0 ? 1 : n) * sizeof(value_type);
+            }
+    };
+
+    template <class T, class U, unsigned Options>
+    inline bool operator==(const mmap_allocator<T, Options>&, const mmap_allocator<U, Options>&) {
+        return true;
+    }
+
+    template <class T, class U, unsigned Options>
+    inline bool operator!=(const mmap_allocator<T, Options>&, const mmap_allocator<U, Options>&) {
+        return false;
+    }
+
+    // mmap_allocator の領域は basic_relocatable_storage そのものなので,
+    // vector は要素ごと mremap で伸ばしてよい。
+    template <class T, unsigned Options>
+    struct relocatable_storage_for< mmap_allocator<T, Options> > : true_type {
+        typedef basic_relocatable_storage<Options>  type;
+    };
+}
+
+#endif
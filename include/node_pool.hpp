@@ -0,0 +1,258 @@
+#ifndef NODE_POOL_HPP
+# define NODE_POOL_HPP
+
+# include "ft_common.hpp"
+# include <memory>
+# include <new>
+# include <cstddef>
+# include <limits>
+
+namespace ft {
+
+    // [node_pool]
+    // 同じ大きさの要素を1個ずつ確保・解放するためのアロケータ。
+    // map, set の PairAllocator / KeyAllocator に指定すると,
+    // tree が rebind したノードアロケータがノードをプールから取り出す。
+    // - ノードは大きな塊(スラブ)から切り出す。スラブは確保するたびに倍に大きくする。
+    // - 解放されたノードはフリーリストにつないで再利用する。
+    // - 確保中のノードが0個になったら(clear() した時など), 最初の(いちばん小さい)スラブだけ残して解放する。
+    //   空になっては入れる, を繰り返しても, そのたびにスラブを確保し直さずに済む。
+    //   残したスラブは, プールを共有するアロケータがすべてなくなったときに解放する。
+    // コピーしたアロケータはプールを共有する(参照カウント)。
+    // rebind して作ったアロケータは別のプールを持つので, 元のアロケータとは等しくない。
+    // (そのため, 同じアロケータを渡して作った map どうしでもノードアロケータは等しくならず,
+    //  split / join はノードを付け替えられずに, 要素ごとの挿入・削除になる。
+    //  map をコピーして作った場合だけは, コピー元とプールを共有する)
+    // n != 1 の確保・解放は std::allocator に任せる。
+    // スレッドセーフではない。
+    template <class T>
+    class node_pool {
+        public:
+            typedef T                   value_type;
+            typedef T*                  pointer;
+            typedef const T*            const_pointer;
+            typedef T&                  reference;
+            typedef const T&            const_reference;
+            typedef std::size_t         size_type;
+            typedef std::ptrdiff_t      difference_type;
+
+            template <class U>
+            struct rebind { typedef node_pool<U> other; };
+
+        FT_PRIVATE:
+            template <class> friend class node_pool;
+
+            // 空きノードの先頭に埋め込む, 次の空きノードへのリンク
+            struct free_node {
+                free_node*  next;
+            };
+
+            // プールの実体
+            // スラブは先頭のチャンクに次のスラブへのポインタを持つ単方向リストにする。
+            struct pool_type {
+                // このプールを共有しているアロケータの数
+                size_type   refs;
+                // 確保済みスラブのリスト
+                free_node*  slabs;
+                // 解放されたノードのリスト
+                free_node*  free_list;
+                // 最新のスラブのうち, まだ切り出していない範囲 [cursor, slab_end)
+                char*       cursor;
+                char*       slab_end;
+                // 次に確保するスラブのチャンク数
+                size_type   next_slab_chunks;
+                // 確保済みスラブの合計バイト数
+                size_type   bytes;
+                // 確保中のノード数
+                size_type   live;
+
+                pool_type()
+                    : refs(1), slabs(NULL), free_list(NULL),
+                    cursor(NULL), slab_end(NULL),
+                    next_slab_chunks(min_slab_chunks_()), bytes(0), live(0) {}
+                ~pool_type() { release(); }
+
+                void*   allocate() {
+                    void*   p;
+                    if (free_list != NULL) {
+                        p = free_list;
+                        free_list = free_list->next;
+                    } else {
+                        if (cursor == slab_end) {
+                            add_slab();
+                        }
+                        p = cursor;
+                        cursor += chunk_size_();
+                    }
+                    ++live;
+                    return p;
+                }
+
+                void    deallocate(void* p) {
+                    free_node*  node = static_cast<free_node*>(p);
+                    node->next = free_list;
+                    free_list = node;
+                    if (--live == 0) {
+                        keep_first_slab();
+                    }
+                }
+
+                // 先頭のチャンクはリンクに使うので, 切り出せるのは残りのチャンク。
+                void    add_slab() {
+                    size_type   bytes = chunk_size_() * next_slab_chunks;
+                    char*       slab = static_cast<char*>(::operator new(bytes));
+                    free_node*  link = reinterpret_cast<free_node*>(slab);
+                    link->next = slabs;
+                    slabs = link;
+                    cursor = slab + chunk_size_();
+                    slab_end = slab + bytes;
+                    this->bytes += bytes;
+                    slab_bytes_in_use() += bytes;
+                    if (next_slab_chunks < max_slab_chunks_()) {
+                        next_slab_chunks *= 2;
+                    }
+                }
+
+                // 最初のスラブ(リストの末尾)以外を解放し, 最初のスラブを確保した直後の状態に戻す。
+                // 確保中のノードがないときだけ呼べる。
+                void    keep_first_slab() {
+                    if (slabs == NULL) { return; }
+                    while (slabs->next != NULL) {
+                        free_node*  next = slabs->next;
+                        ::operator delete(static_cast<void*>(slabs));
+                        slabs = next;
+                    }
+                    size_type   first_bytes = chunk_size_() * min_slab_chunks_();
+                    slab_bytes_in_use() -= bytes - first_bytes;
+                    bytes = first_bytes;
+                    free_list = NULL;
+                    cursor = reinterpret_cast<char*>(slabs) + chunk_size_();
+                    slab_end = reinterpret_cast<char*>(slabs) + first_bytes;
+                    next_slab_chunks = min_slab_chunks_() * 2;
+                }
+
+                // スラブをすべて解放し, 最初の状態に戻す。
+                void    release() {
+                    while (slabs != NULL) {
+                        free_node*  next = slabs->next;
+                        ::operator delete(static_cast<void*>(slabs));
+                        slabs = next;
+                    }
+                    slab_bytes_in_use() -= bytes;
+                    bytes = 0;
+                    free_list = NULL;
+                    cursor = NULL;
+                    slab_end = NULL;
+                    next_slab_chunks = min_slab_chunks_();
+                }
+            };
+
+            pool_type*  pool_;
+
+        public:
+            // [[コンストラクタ群]]
+
+            node_pool(): pool_(new pool_type()) {}
+            node_pool(const node_pool& other) FT_NOEXCEPT
+                : pool_(other.pool_) {
+                ++pool_->refs;
+            }
+            // rebind 先は要素の大きさが違うので, 新しいプールを作る。
+            template <class U>
+            node_pool(const node_pool<U>&): pool_(new pool_type()) {}
+            ~node_pool() {
+                if (--pool_->refs == 0) {
+                    delete pool_;
+                }
+            }
+
+            node_pool&  operator=(const node_pool& rhs) {
+                if (pool_ == rhs.pool_) { return *this; }
+                ++rhs.pool_->refs;
+                if (--pool_->refs == 0) {
+                    delete pool_;
+                }
+                pool_ = rhs.pool_;
+                return *this;
+            }
+
+            pointer         address(reference x) const { return &x; }
+            const_pointer   address(const_reference x) const { return &x; }
+
+            pointer allocate(size_type n, const void* hint = 0) {
+                if (n != 1) {
+                    return std::allocator<T>().allocate(n, hint);
+                }
+                return static_cast<pointer>(pool_->allocate());
+            }
+
+            void    deallocate(pointer p, size_type n) {
+                if (n != 1) {
+                    std::allocator<T>().deallocate(p, n);
+                    return;
+                }
+                pool_->deallocate(p);
+            }
+
+            size_type   max_size() const {
+                return std::numeric_limits<size_type>::max() / sizeof(T);
+            }
+
+            void    construct(pointer p, const_reference val) {
+                ::new (static_cast<void*>(p)) T(val);
+            }
+# ifdef FT_CXX11
+            // args から直接構築する(C++11 モード)
+            template <class U, class... Args>
+            void    construct(U* p, Args&&... args) {
+                ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+            }
+# endif
+
+            void    destroy(pointer p) {
+                p->~T();
+            }
+
+            // このアロケータのプールが確保中のノード数
+            size_type   nodes_in_use() const { return pool_->live; }
+
+            // すべての node_pool が確保中のスラブの合計バイト数
+            static size_type&   slab_bytes_in_use() {
+                return node_pool<char>::slab_bytes_();
+            }
+
+            // 同じプールを共有しているか
+            template <class U>
+            bool    shares_pool_with(const node_pool<U>& other) const {
+                return static_cast<const void*>(pool_) == static_cast<const void*>(other.pool_);
+            }
+
+        FT_PRIVATE:
+            static size_type&   slab_bytes_() {
+                static size_type    bytes = 0;
+                return bytes;
+            }
+
+            // チャンク(ノード1個分の領域)の大きさ
+            // 空きリンクが入る大きさで, ポインタの大きさの倍数に切り上げる。
+            // (T のアラインメントは sizeof(T) を割り切るので, これで T のアラインメントも満たす)
+            static size_type    chunk_size_() {
+                size_type   size = sizeof(T) < sizeof(free_node) ? sizeof(free_node) : sizeof(T);
+                return (size + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+            }
+            static size_type    min_slab_chunks_() { return 32; }
+            static size_type    max_slab_chunks_() { return 8192; }
+    };
+
+    template <class T, class U>
+    inline bool operator==(const node_pool<T>& lhs, const node_pool<U>& rhs) {
+        return lhs.shares_pool_with(rhs);
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const node_pool<T>& lhs, const node_pool<U>& rhs) {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
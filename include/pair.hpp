@@ -3,6 +3,7 @@
 
 # include "ft_common.hpp"
 # include "ft_meta_functions.hpp"
+# include "ft_algorithm.hpp"
 
 namespace ft {
     template <class First, class Second>
@@ -31,6 +32,38 @@ namespace ft {
                 return *this;
             }
 
+# ifdef FT_CXX11
+            // [[ムーブ・完全転送(C++11 モード)]]
+            // const な要素(map の キー)はコピーされる。
+            pair(pair<First, Second>&& other) noexcept(
+                std::is_nothrow_constructible<First, First&&>::value
+                && std::is_nothrow_constructible<Second, Second&&>::value
+            ): first(std::forward<First>(other.first)), second(std::forward<Second>(other.second)) {}
+
+            template <
+                class U, class V,
+                class = typename std::enable_if<
+                    std::is_constructible<First, U&&>::value
+                    && std::is_constructible<Second, V&&>::value
+                >::type
+            >
+            pair(U&& f, V&& s)
+                : first(std::forward<U>(f)), second(std::forward<V>(s)) {}
+
+            template <class U, class V>
+            pair(pair<U, V>&& other)
+                : first(std::forward<U>(other.first)), second(std::forward<V>(other.second)) {}
+
+            pair<First, Second>& operator=(pair<First, Second>&& rhs) noexcept(
+                std::is_nothrow_assignable<First&, First&&>::value
+                && std::is_nothrow_assignable<Second&, Second&&>::value
+            ) {
+                first = std::forward<First>(rhs.first);
+                second = std::forward<Second>(rhs.second);
+                return *this;
+            }
+# endif
+
             void    swap(pair<First, Second>& other) {
                 ft::swap(first, other.first);
                 ft::swap(second, other.second);
@@ -97,6 +130,12 @@ namespace ft {
     inline void    swap(ft::pair<First, Second>& x, ft::pair<First, Second>& y) {
         x.swap(y);
     }
+
+    // 両方の要素がそのまま移せるなら, pair もそのまま移せる。
+    template <class First, class Second>
+    struct is_trivially_relocatable< ft::pair<First, Second> > : integral_constant<bool,
+        is_trivially_relocatable<First>::value && is_trivially_relocatable<Second>::value
+    > {};
 }
 
 namespace std {
@@ -56,6 +56,10 @@ namespace ft {
                     const_iterator(const const_iterator_type& other) {
                         *this = other;
                     }
+                    const_iterator&  operator=(const const_iterator_type& rhs) {
+                        tree_it_ = rhs.tree_it_;
+                        return *this;
+                    }
                     ~const_iterator() {}
 
                     tree_const_iterator tree_iter() const {
@@ -134,10 +138,26 @@ namespace ft {
                 insert(first, last);
             }
 
-            set(const self_type& other) {
-                *this = other;
+            // [first, last) がソート済みかつ重複なしであれば, 線形時間で構築する。
+            template <class InputIterator>
+            set(ft::sorted_unique_t,
+                InputIterator first,
+                InputIterator last,
+                const KeyComparator& comp = KeyComparator(),
+                const KeyAllocator& alloc = KeyAllocator()
+            ): tree_(comp, alloc) {
+                insert(ft::sorted_unique, first, last);
             }
 
+            set(const self_type& other)
+                : tree_(other.tree_) {}
+
+# ifdef FT_CXX11
+            // ノードをそのまま引き取る。other は空になる。
+            set(self_type&& other)
+                : tree_(std::move(other.tree_)) {}
+# endif
+
             ~set() {
                 // 破壊処理はtreeのデストラクタがやる
             }
@@ -148,6 +168,13 @@ namespace ft {
                 return *this;
             }
 
+# ifdef FT_CXX11
+            self_type&      operator=(self_type&& rhs) {
+                tree_ = std::move(rhs.tree_);
+                return *this;
+            }
+# endif
+
             allocator_type      get_allocator() const {
                 return allocator_type(tree_.get_allocator());
             }
@@ -157,9 +184,9 @@ namespace ft {
             iterator                 end() { return iterator(tree_.end()); }
             const_iterator           end() const { return const_iterator(tree_.end()); }
             reverse_iterator         rbegin() { return reverse_iterator(end()); }
-            const_reverse_iterator   rbegin() const { return reverse_iterator(end()); }
+            const_reverse_iterator   rbegin() const { return const_reverse_iterator(end()); }
             reverse_iterator         rend() { return reverse_iterator(begin()); }
-            const_reverse_iterator   rend() const { return reverse_iterator(begin()); }
+            const_reverse_iterator   rend() const { return const_reverse_iterator(begin()); }
 
             bool             empty() const { return tree_.empty(); }
             size_type        size() const {return tree_.size();}
@@ -184,6 +211,37 @@ namespace ft {
                     tree_.insert(e, *first);
                 }
             }
+            // [first, last) がソート済みかつ重複なしであることを呼び出し側が保証する範囲挿入。
+            // 空のsetへの挿入なら線形時間。
+            template <class InputIterator>
+            void                    insert(ft::sorted_unique_t, InputIterator first, InputIterator last) {
+                tree_.insert(ft::sorted_unique, first, last);
+            }
+
+# ifdef FT_CXX11
+            // [[ムーブ挿入・emplace(C++11 モード)]]
+
+            pair<iterator, bool>    insert(value_type&& v) {
+                ft::pair<typename base::iterator, bool>   result = tree_.insert(std::move(v));
+                return ft::make_pair(iterator(result.first), result.second);
+            }
+            iterator                insert(iterator hint, value_type&& v) {
+                return iterator(tree_.insert(hint.tree_iter(), std::move(v)));
+            }
+
+            // args から要素を構築して挿入する。
+            // 先にノードを作るので, キーがすでにあってもノードの確保・構築は起こる。
+            template <class... Args>
+            pair<iterator, bool>    emplace(Args&&... args) {
+                ft::pair<typename base::iterator, bool>   result
+                    = tree_.emplace(std::forward<Args>(args)...);
+                return ft::make_pair(iterator(result.first), result.second);
+            }
+            template <class... Args>
+            iterator                emplace_hint(const_iterator hint, Args&&... args) {
+                return iterator(tree_.emplace_hint(hint.tree_iter(), std::forward<Args>(args)...));
+            }
+# endif
 
             // [[削除]]
             void         erase(const_iterator position) {
@@ -192,6 +250,13 @@ namespace ft {
             size_type    erase(const key_type& x) {
                 return tree_.erase_by_key(x);
             }
+            // key_compare が transparent なら, key_type を作らずに削除できる。
+            // (イテレータに変換できる型はイテレータ版に任せる)
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, size_type, const_iterator>::type
+                         erase(const K& x) {
+                return tree_.erase_by_key(x);
+            }
             void         erase(iterator first, iterator last) {
                 return tree_.erase(first.tree_iter(), last.tree_iter());
             }
@@ -200,6 +265,25 @@ namespace ft {
                 tree_.swap(other.tree_);
             }
 
+            // [[分割・連結]]
+
+            // key 以上の要素をすべて out に移す。out の元の要素は破棄される。
+            // 木の組み換えは O(log n) だが, 要素数を数え直すので,
+            // 2つに分けたうち小さい方の要素数に比例する時間がかかる
+            // (順序統計木モード(FT_ORDER_STATISTICS_TREE)では O(log n))。
+            // ノードアロケータが等しくない場合(node_pool を使い, 別々に作ったコンテナどうしなど)は,
+            // 要素を1つずつ移すので O(k log n) になる(k は移す要素数)。
+            void         split(const key_type& key, self_type& out) {
+                tree_.split(key, out.tree_);
+            }
+
+            // other の要素をすべて this に移し, other を空にする。
+            // キーの範囲が重ならなければ O(log n)。
+            // ただし split と同じく, ノードアロケータが等しくなければ要素を1つずつ移す。
+            void         join(self_type& other) {
+                tree_.join(other.tree_);
+            }
+
             // [[検索系関数]]
 
             size_type                count(const key_type& x) const {
@@ -235,6 +319,133 @@ namespace ft {
                 return const_iterator(tree_.upper_bound(x));
             }
 
+            // [[ヒントつき検索]]
+            // hint の位置から探す。hint と結果が近ければ, 根から探すより速い。
+            // (hint はこの set の任意のイテレータでよい)
+
+            const_iterator                          lower_bound(const_iterator hint, const key_type& x) const {
+                return const_iterator(tree_.lower_bound(hint.tree_iter(), x));
+            }
+
+            const_iterator                          find(const_iterator hint, const key_type& x) const {
+                return const_iterator(tree_.find(hint.tree_iter(), x));
+            }
+
+            // [[一括検索]]
+
+            // ソート済み(key_comp の順, 重複可)のキー列 [first, last) のそれぞれについて,
+            // find した結果(なければ end())を順に out に書き出す。
+            // 前のキーの位置から木をたどるので, n 要素の木で k 個のキーを探すのに O(k log(n/k))。
+            template <class InputIterator, class OutputIterator>
+            OutputIterator          find_sorted(InputIterator first, InputIterator last, OutputIterator out) {
+                return tree_.find_sorted(first, last,
+                    ft::converting_output_iterator<OutputIterator, iterator>(out)).base();
+            }
+            template <class InputIterator, class OutputIterator>
+            OutputIterator          find_sorted(InputIterator first, InputIterator last, OutputIterator out) const {
+                return tree_.find_sorted(first, last,
+                    ft::converting_output_iterator<OutputIterator, const_iterator>(out)).base();
+            }
+
+            // 順不同のキー列 [first, last) のそれぞれについて,
+            // find した結果(なければ end())を順に out に書き出す。
+            // Width 個の探索を並べて進め, 次のノードをプリフェッチする(メモリ待ちを重ねる)。
+            // キーを複数回読むので, [first, last) は前方向イテレータであること。
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+                return tree_.template find_batch<Width>(first, last,
+                    ft::converting_output_iterator<OutputIterator, iterator>(out)).base();
+            }
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+                return tree_.template find_batch<Width>(first, last,
+                    ft::converting_output_iterator<OutputIterator, const_iterator>(out)).base();
+            }
+            // 幅を指定しない場合は8
+            template <class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+                return find_batch<8>(first, last, out);
+            }
+            template <class ForwardIterator, class OutputIterator>
+            OutputIterator          find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+                return find_batch<8>(first, last, out);
+            }
+
+            // [[異種キーでの検索]]
+            // key_compare が is_transparent 型を持つなら, key_type と比較できる任意の型で検索できる。
+            // (一時的な key_type を作らない)
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, size_type>::type
+                                                    count(const K& x) const {
+                return tree_.count(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, iterator>::type
+                                                    find(const K& x) {
+                return iterator(tree_.find(x));
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    find(const K& x) const {
+                return const_iterator(tree_.find(x));
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, pair<iterator, iterator> >::type
+                                                    equal_range(const K& x) {
+                return tree_.equal_range(x);
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, pair<const_iterator, const_iterator> >::type
+                                                    equal_range(const K& x) const {
+                return tree_.equal_range(x);
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, iterator>::type
+                                                    lower_bound(const K& x) {
+                return iterator(tree_.lower_bound(x));
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    lower_bound(const K& x) const {
+                return const_iterator(tree_.lower_bound(x));
+            }
+
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, iterator>::type
+                                                    upper_bound(const K& x) {
+                return iterator(tree_.upper_bound(x));
+            }
+            template <class K>
+            typename ft::enable_if_transparent<key_compare, K, const_iterator>::type
+                                                    upper_bound(const K& x) const {
+                return const_iterator(tree_.upper_bound(x));
+            }
+
+            // [[順序統計]]
+            // FT_ORDER_STATISTICS_TREE が有効なら O(log n), そうでなければ O(n)。
+
+            // x より小さいキーを持つ要素の数
+            size_type                               rank(const key_type& x) const {
+                return tree_.rank(x);
+            }
+
+            // 先頭から i 番目(0始まり)の要素を返す。i >= size() なら end()。
+            iterator                                nth(size_type i) {
+                return iterator(tree_.select(i));
+            }
+            const_iterator                          nth(size_type i) const {
+                return const_iterator(tree_.select(i));
+            }
+
+            // first から last までの要素数 (std::distance と同じ結果)
+            difference_type                         distance(const_iterator first, const_iterator last) const {
+                return tree_.distance(first.tree_iter(), last.tree_iter());
+            }
+
             // Key同士を取って比較するコンパレータを返す
             key_compare     key_comp() const {
                 return tree_.value_compare();
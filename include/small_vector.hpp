@@ -0,0 +1,65 @@
+#ifndef SMALL_VECTOR_HPP
+# define SMALL_VECTOR_HPP
+
+# include "vector.hpp"
+
+namespace ft {
+
+    // [small_vector]
+    // 要素 N 個分の領域をオブジェクトの中に持つ vector。
+    // 要素が N 個を超えるまではヒープから確保しない(超えたら普通の vector と同じように伸びる)。
+    // 中身は ft::vector<T, Allocator, GrowthPolicy, N> そのもので, インターフェースもイテレータも同じ。
+    // ft::stack の Container にもできる: ft::stack<T, ft::small_vector<T, 16> >
+    // 普通の vector との違い:
+    // - capacity() は N より小さくならない
+    // - 内部の領域を使っている間は, swap・ムーブで要素が1つずつ移される
+    //   (なのでイテレータ・参照は無効化され, swap が例外を投げうる)
+    // - オブジェクトが sizeof(T) * N だけ大きい
+    template <
+        class T,
+        std::size_t N,
+        class Allocator = std::allocator<T>,
+        class GrowthPolicy = ft::vector_growth_double
+    >
+    class small_vector : public ft::vector<T, Allocator, GrowthPolicy, N> {
+        FT_PRIVATE:
+            typedef ft::vector<T, Allocator, GrowthPolicy, N>   base_type;
+
+        public:
+            typedef typename base_type::value_type              value_type;
+            typedef typename base_type::allocator_type          allocator_type;
+            typedef typename base_type::size_type               size_type;
+            typedef typename base_type::const_reference         const_reference;
+
+            static const std::size_t    inline_capacity = N;
+
+            // [コンストラクタ]
+            // コピー・ムーブ・代入は vector のものがそのまま使われる。
+            small_vector()
+                : base_type() {}
+            explicit small_vector(const allocator_type& alloc)
+                : base_type(alloc) {}
+            explicit small_vector(size_type count)
+                : base_type(count) {}
+            small_vector(
+                size_type count,
+                const_reference value,
+                const allocator_type& alloc = allocator_type()
+            ): base_type(count, value, alloc) {}
+            template <class InputIt>
+            small_vector(
+                InputIt first, InputIt last,
+                const allocator_type& alloc = allocator_type(),
+                typename ft::disable_if< ft::is_integral<InputIt>::value >::type* = NULL
+            ): base_type(first, last, alloc) {}
+    };
+}
+
+namespace std {
+    template <class T, std::size_t N, class Alloc, class Growth>
+    inline void swap( ft::small_vector<T, N, Alloc, Growth>& lhs, ft::small_vector<T, N, Alloc, Growth>& rhs ) {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
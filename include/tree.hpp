@@ -7,6 +7,8 @@
 # include "ft_algorithm.hpp"
 # include "pair.hpp"
 # include <memory>
+# include <cstddef>
+# include <climits>
 # include <iostream>
 # include <iterator>
 # include <exception>
@@ -14,6 +16,13 @@
 
 namespace ft {
 
+    // [sorted_unique]
+    // 範囲挿入・範囲コンストラクタに渡すタグ。
+    // 範囲がコンテナのコンパレータについてソート済みかつ重複なしであることを,
+    // 呼び出し側が保証する(確認はしない)。
+    struct sorted_unique_t {};
+    const sorted_unique_t   sorted_unique = sorted_unique_t();
+
     // tree (Red-Black Tree)
     template <
         // ノードに載る値の型
@@ -39,47 +48,66 @@ namespace ft {
         public:
             // インナークラス
 
+            template<class TreeValue>
+            class TreeValueNode;
+
             // [treeのノード]
-            // ツリーの各要素(Value)のポインタ(Value*)を持つ。
-            // 左子・右子・親へのポインタを持つ。
+            // 左子・右子・親へのポインタと色を持つ。
             // - 親がnull -> endノード
             // - 子がnull -> 子はNILノード
-            // ノードはelementのライフタイムについて責を負わない。
+            // endノードの左子は根で, 右子は最大ノード(キャッシュ; 空ならnull)。
+            // (endノードの右子は木の辺ではない)
+            // ノード自身はValueを持たない。
+            // endでないノードは実際には TreeValueNode として確保されていて,
+            // Valueはそちらにインラインで載っている。
             // (ので、コピーフリー)
             template<class TreeValue>
             class TreeNode {
                 public:
-                    typedef TreeValue               tree_value;
-                    typedef tree_value*             tree_value_pointer;
-                    typedef TreeNode<tree_value>    tree_node;
-                    typedef tree_node*              tree_node_pointer;
-                    typedef const tree_node*        tree_node_const_pointer;
+                    typedef TreeValue                   tree_value;
+                    typedef tree_value*                 tree_value_pointer;
+                    typedef TreeNode<tree_value>        tree_node;
+                    typedef tree_node*                  tree_node_pointer;
+                    typedef const tree_node*            tree_node_const_pointer;
+                    typedef TreeValueNode<tree_value>   tree_value_node;
 
                 FT_PRIVATE:
-                    // ツリーが保持する要素
-                    tree_value_pointer  tree_value_;
                     // 左子へのポインタ
                     tree_node_pointer   left_child_node_;
                     // 右子へのポインタ
                     tree_node_pointer   right_child_node_;
+# ifdef FT_COMPACT_TREE_NODE
+                    // 親へのポインタと色
+                    // ノードのアラインメントは2以上なので、ポインタの最下位ビットは常に0。
+                    // そこに「ノードが黒か」を埋め込んで、ノードを1ワード小さくする。
+                    std::size_t         parent_and_color_;
+# else
                     // 親へのポインタ
                     tree_node_pointer   parent_node_;
                     // ノードが黒か
                     bool                is_black_;
+# endif
+# ifdef FT_ORDER_STATISTICS_TREE
+                    // 自身を根とする部分木のノード数
+                    std::size_t         subtree_size_;
+# endif
 
                 public:
                     // デフォルト構築
                     // endノードもこれで作る。
                     // endノードは黒。
                     explicit TreeNode()
-                        :   tree_value_(NULL),
-                            left_child_node_(NULL), right_child_node_(NULL), parent_node_(NULL),
-                            is_black_(true) {}
-                    // endでないノードは赤。
-                    explicit TreeNode(tree_value& element)
-                        :   tree_value_(&element),
-                            left_child_node_(NULL), right_child_node_(NULL), parent_node_(NULL),
-                            is_black_(false) {}
+                        :   left_child_node_(NULL), right_child_node_(NULL) {
+                        init_parent_and_color_(true);
+                        init_subtree_size_();
+                    }
+                    // 色指定
+                    // endでないノードは赤で作る。
+                    explicit TreeNode(bool is_black)
+                        :   left_child_node_(NULL), right_child_node_(NULL) {
+                        init_parent_and_color_(is_black);
+                        init_subtree_size_();
+                    }
                     TreeNode(const TreeNode& other) {
                         *this = other;
                     }
@@ -87,11 +115,17 @@ namespace ft {
 
                     tree_node& operator=(const tree_node& rhs) {
                         if (this == &rhs) { return *this; }
-                        tree_value_ = rhs.tree_value_;
                         left_child_node_ = rhs.left_child_node_;
                         right_child_node_ = rhs.right_child_node_;
+# ifdef FT_COMPACT_TREE_NODE
+                        parent_and_color_ = rhs.parent_and_color_;
+# else
                         parent_node_ = rhs.parent_node_;
                         is_black_ = rhs.is_black_;
+# endif
+# ifdef FT_ORDER_STATISTICS_TREE
+                        subtree_size_ = rhs.subtree_size_;
+# endif
                         return *this;
                     }
 
@@ -99,23 +133,62 @@ namespace ft {
 
                     // [[getters]]
 
-                    tree_value_pointer       value() { return tree_value_; }
-                    const tree_value_pointer value() const { return tree_value_; }
+                    // endノードに対して呼んではいけない。
+                    tree_value_pointer       value() {
+                        return &(static_cast<tree_value_node*>(this)->tree_value_);
+                    }
+                    const tree_value_pointer value() const {
+                        return &(const_cast<tree_value_node*>(
+                            static_cast<const tree_value_node*>(this)
+                        )->tree_value_);
+                    }
                     tree_node_pointer&       left() { return left_child_node_; }
                     tree_node_pointer&       right() { return right_child_node_; }
-                    tree_node_pointer&       parent() { return parent_node_; }
                     const tree_node_pointer& left() const { return left_child_node_; }
                     const tree_node_pointer& right() const { return right_child_node_; }
-                    const tree_node_pointer& parent() const { return parent_node_; }
+                    // 親は参照ではなく値で返す。
+                    // (コンパクトモードでは色と同居しているため)
+                    // 親を付け替える時は set_parent を使うこと。
+# ifdef FT_COMPACT_TREE_NODE
+                    tree_node_pointer        parent() const {
+                        return reinterpret_cast<tree_node_pointer>(parent_and_color_ & ~color_bit_());
+                    }
+                    void                     set_parent(tree_node_pointer parent) {
+                        parent_and_color_ = reinterpret_cast<std::size_t>(parent)
+                            | (parent_and_color_ & color_bit_());
+                    }
+# else
+                    tree_node_pointer        parent() const { return parent_node_; }
+                    void                     set_parent(tree_node_pointer parent) { parent_node_ = parent; }
+# endif
+# ifdef FT_ORDER_STATISTICS_TREE
+                    // 自身を根とする部分木のノード数
+                    std::size_t              subtree_size() const { return subtree_size_; }
+                    void                     set_subtree_size(std::size_t n) { subtree_size_ = n; }
+                    // 子の部分木のノード数から数え直す
+                    void                     update_subtree_size() {
+                        subtree_size_ = 1 + subtree_size_of(left()) + subtree_size_of(right());
+                    }
+                    static std::size_t       subtree_size_of(tree_node_const_pointer node) {
+                        return node ? node->subtree_size_ : 0;
+                    }
+# endif
 
                     // [[predicates]]
 
+# ifdef FT_COMPACT_TREE_NODE
+                    bool is_black() const { return (parent_and_color_ & color_bit_()) != 0; }
+# else
                     bool is_black() const { return is_black_; }
+# endif
                     // 自身が左子かどうか
                     // (rootに対してはfalseを返すことに注意！)
                     bool is_left_child() const { return has_parent_() && parent()->left() == this; }
                     // 自身が右子かどうか
-                    bool is_right_child() const { return has_parent_() && parent()->right() == this; }
+                    // (endノードの右子は最大ノードのキャッシュなので, rootに対してはfalseを返す)
+                    bool is_right_child() const {
+                        return has_parent_() && parent()->right() == this && parent()->has_parent_();
+                    }
                     bool has_left_child() const { return left() != NULL; }
                     bool has_right_child() const { return right() != NULL; }
 
@@ -185,8 +258,11 @@ namespace ft {
                     // O(log2 n)
                     tree_node_pointer    backward_neighbor() {
                         if (has_left_child()) {
+                            // endの場合
+                            // -> キャッシュしてある最大ノードを返す
+                            if (is_end_()) { return right(); }
                             // 左子がある場合
-                            // -> 左子のminを返す
+                            // -> 左子のmaxを返す
                             return left()->max_node_();
                         }
                         // 左子がない場合
@@ -200,6 +276,7 @@ namespace ft {
                     }
                     tree_node_const_pointer    backward_neighbor() const {
                         if (has_left_child()) {
+                            if (is_end_()) { return right(); }
                             return left()->max_node_();
                         }
                         tree_node_const_pointer    ptr = this;
@@ -243,17 +320,14 @@ namespace ft {
                         return !is_end_() && is_left_child() != parent()->is_left_child();
                     }
 
-                    // valueだけをswapする。
-                    void    swap_value(tree_node& other) {
-                        ft::swap(tree_value_, other.tree_value_);
-                    }
-
                     void    swap_color(tree_node& other) {
-                        ft::swap(is_black_, other.is_black_);
+                        bool    other_is_black = other.is_black();
+                        other.set_color_(is_black());
+                        set_color_(other_is_black);
                     }
 
                     // 色を反転する
-                    void flip_color() { is_black_ = !is_black_; }
+                    void flip_color() { set_color_(!is_black()); }
 
                     // 2つのノードの位置関係、つまり接続されているエッジを入れ替える.
                     // 入れ替え対象はどちらも通常のノード.
@@ -263,8 +337,15 @@ namespace ft {
                         bool    other_was_left_child = other.is_root_() || other.is_left_child();
                         // 色をswap
                         swap_color(other);
+# ifdef FT_ORDER_STATISTICS_TREE
+                        // 部分木のノード数は位置に付くものなので, 色と同様にswap
+                        ft::swap(subtree_size_, other.subtree_size_);
+# endif
                         // 出る方のswap
-                        ft::swap(parent(), other.parent());
+                        // (親は色と同居している場合があるので、ポインタだけを入れ替える)
+                        tree_node_pointer   this_parent = parent();
+                        set_parent(other.parent());
+                        other.set_parent(this_parent);
                         ft::swap(left(), other.left());
                         ft::swap(right(), other.right());
                         // 入る方
@@ -276,7 +357,7 @@ namespace ft {
                     void    place_into_left(tree_node_pointer child) {
                         this->left() = child;
                         if (child != NULL) {
-                            child->parent() = this;
+                            child->set_parent(this);
                         }
                     }
 
@@ -284,12 +365,41 @@ namespace ft {
                     void    place_into_right(tree_node_pointer child) {
                         this->right() = child;
                         if (child != NULL) {
-                            child->parent() = this;
+                            child->set_parent(this);
                         }
                     }
 
                 FT_PRIVATE:
 
+# ifdef FT_COMPACT_TREE_NODE
+                    static std::size_t  color_bit_() { return 1; }
+
+                    void init_parent_and_color_(bool is_black) {
+                        parent_and_color_ = is_black ? color_bit_() : 0;
+                    }
+
+                    void set_color_(bool is_black) {
+                        if (is_black) {
+                            parent_and_color_ |= color_bit_();
+                        } else {
+                            parent_and_color_ &= ~color_bit_();
+                        }
+                    }
+# else
+                    void init_parent_and_color_(bool is_black) {
+                        parent_node_ = NULL;
+                        is_black_ = is_black;
+                    }
+
+                    void set_color_(bool is_black) { is_black_ = is_black; }
+# endif
+
+# ifdef FT_ORDER_STATISTICS_TREE
+                    void init_subtree_size_() { subtree_size_ = 1; }
+# else
+                    void init_subtree_size_() {}
+# endif
+
                     // swap_positionの一部分
                     // 自分と隣接するノードを自分に向ける。
                     // ただし、自分とcounterが隣接している場合は特別扱いが必要。
@@ -298,25 +408,25 @@ namespace ft {
                             if (left() == this)
                                 left() = &counter;
                             else
-                                left()->parent() = this;
+                                left()->set_parent(this);
                         }
                         if (right()) {
                             if (right() == this)
                                 right() = &counter;
                             else
-                                right()->parent() = this;
+                                right()->set_parent(this);
                         }
                         if (parent() == this)
-                            parent() = &counter;
+                            set_parent(&counter);
                         else
                             (counter_was_left_child ? parent()->left() : parent()->right())
                                 = this;
                     }
 
-                /*
                 // [[デバッグメソッド]]
                 public:
 
+                /*
                     // TODO: 提出時は消す
                     friend std::ostream&    operator<<(std::ostream& stream, const tree_node& rhs) {
                         stream << "[";
@@ -345,7 +455,10 @@ namespace ft {
                             stream << "-";
                         return stream << "]";
                     }
+                */
 
+                    // 以下はこのノードを根とする部分木の高さ(黒高さ)を返す。
+                    // 赤黒木の条件の確認用。
                     std::size_t debug_shortest_height() const {
                         return 1 + std::min(
                             left() ? left()->debug_shortest_height() : 0,
@@ -373,7 +486,35 @@ namespace ft {
                             right() ? right()->debug_longest_black_height() : 0
                         );
                     }
-                */
+
+                    // 赤いノードの子が赤くないなら true
+                    bool        debug_no_red_red() const {
+                        if (!is_black()
+                            && ((left() && !left()->is_black())
+                                || (right() && !right()->is_black()))) {
+                            return false;
+                        }
+                        return (!left() || left()->debug_no_red_red())
+                            && (!right() || right()->debug_no_red_red());
+                    }
+            };
+
+            // [Valueを持つノード]
+            // TreeNode の後ろにValueの実体をくっつけたもの。
+            // ノードとValueを1回の確保で持つので、比較のたびにポインタを辿らなくてよい。
+            // 構築・破壊は TreeNodeHolder と tree::destroy_node_ が部分ごとに行う。
+            // (Valueはアロケータで、リンク部分は placement new で構築する)
+            template<class TreeValue>
+            class TreeValueNode: public TreeNode<TreeValue> {
+                friend class TreeNode<TreeValue>;
+
+                FT_PRIVATE:
+                    TreeValue   tree_value_;
+
+                    // 直接の構築・コピーはさせない
+                    TreeValueNode();
+                    TreeValueNode(const TreeValueNode& other);
+                    TreeValueNode&  operator=(const TreeValueNode& rhs);
             };
 
             // 要素のタイプ
@@ -384,13 +525,18 @@ namespace ft {
             typedef ValueAllocator                      value_allocator_type;
             // ノードクラス
             typedef TreeNode<value_type>                node_type;
+            // Valueを持つノードクラス(end以外のノードの実体)
+            typedef TreeValueNode<value_type>           value_node_type;
             // ノードのアロケータ
-            typedef typename value_allocator_type::template rebind<node_type>::other
+            // -> Valueを持つノードを丸ごと確保する
+            typedef typename value_allocator_type::template rebind<value_node_type>::other
                                                                     node_allocator_type;
-            typedef typename node_allocator_type::reference         reference;
-            typedef typename node_allocator_type::const_reference   const_reference;
-            typedef typename node_allocator_type::pointer           pointer;
-            typedef typename node_allocator_type::const_pointer     const_pointer;
+            typedef typename node_allocator_type::pointer           value_node_pointer;
+            // イテレータはendも指すので、ノード(リンク部分)のポインタとする
+            typedef node_type&                                      reference;
+            typedef const node_type&                                const_reference;
+            typedef node_type*                                      pointer;
+            typedef const node_type*                                const_pointer;
 
             typedef tree<Value, ValueComparator, ValueAllocator>    self_type;
             typedef typename std::size_t                            size_type;
@@ -404,6 +550,7 @@ namespace ft {
 
             // [ノードホルダー]
             // ノード構築時の例外安全性を担保するための一時オブジェクト
+            // ノードとValueは1回の確保でまとめて持つ。
             class TreeNodeHolder {
                 public:
                     typedef tree::value_type            value_type;
@@ -412,26 +559,26 @@ namespace ft {
                     typedef tree::value_allocator_type  value_allocator_type;
                     typedef tree::node_type             node_type;
                     typedef node_type*                  node_pointer;
+                    typedef tree::value_node_pointer    value_node_pointer;
 
                 FT_PRIVATE:
                     bool                    value_constructed_;
                     bool                    node_constructed_;
                     node_allocator_type     node_alloc_;
                     value_allocator_type    value_alloc_;
-                    node_pointer            node_ptr_;
-                    value_pointer           value_ptr_;
+                    value_node_pointer      node_ptr_;
 
                 public:
                     TreeNodeHolder()
                         :   value_constructed_(false), node_constructed_(false),
                             node_alloc_(), value_alloc_(),
-                            node_ptr_(NULL), value_ptr_(NULL) {}
+                            node_ptr_(NULL) {}
                     TreeNodeHolder(
                         const node_allocator_type& node_alloc,
                         const value_allocator_type& value_alloc
                     ):      value_constructed_(false), node_constructed_(false),
                             node_alloc_(node_alloc), value_alloc_(value_alloc),
-                            node_ptr_(NULL), value_ptr_(NULL) {}
+                            node_ptr_(NULL) {}
                     TreeNodeHolder(const self_type& other) {
                         *this = other;
                     }
@@ -454,36 +601,41 @@ namespace ft {
                         ft::swap(node_alloc_, other.node_alloc_);
                         ft::swap(value_alloc_, other.value_alloc_);
                         ft::swap(node_ptr_, other.node_ptr_);
-                        ft::swap(value_ptr_, other.value_ptr_);
                     }
 
-                    // value構築済みなら、あらかじめ与えておいたアロケータを使い、ノードを構築する
-                    void    construct_node() {
-                        if (value_constructed_ && !node_constructed_ && node_ptr_ == NULL) {
+                    // あらかじめ与えておいたアロケータを使い、
+                    // ノードの領域を確保して、その中にvalueを構築する
+# ifdef FT_CXX11
+                    // (C++11 モードでは args から直接構築する)
+                    template <class... Args>
+                    void    construct_value(Args&&... args) {
+                        if (!node_constructed_ && node_ptr_ == NULL) {
                             node_ptr_ = node_alloc_.allocate(1);
-                            if (node_ptr_ && !node_constructed_) {
-                                node_alloc_.construct(node_ptr_, node_type(*value_ptr_));
-                                // end 以外の新しいノードは赤とする
-                                node_constructed_ = true;
+                            if (node_ptr_ && !value_constructed_) {
+                                value_alloc_.construct(value_address_(), std::forward<Args>(args)...);
+                                value_constructed_ = true;
                             }
                         }
                     }
-
-                    // あらかじめ与えておいたアロケータを使い、valueを構築する
+# else
                     void    construct_value(const value_type& val) {
-                        if (!node_constructed_ && value_ptr_ == NULL) {
-                            value_ptr_ = value_alloc_.allocate(1);
-                            if (value_ptr_ && !value_constructed_) {
-                                value_alloc_.construct(value_ptr_, val);
+                        if (!node_constructed_ && node_ptr_ == NULL) {
+                            node_ptr_ = node_alloc_.allocate(1);
+                            if (node_ptr_ && !value_constructed_) {
+                                value_alloc_.construct(value_address_(), val);
                                 value_constructed_ = true;
                             }
                         }
                     }
+# endif
 
-                    // valueの構築が必要ない場合、value構築フラグだけを立てる
-                    void    construct_blank_value() {
-                        if (node_constructed_) {
-                            value_constructed_ = true;
+                    // value構築済みなら、ノードのリンク部分を構築する
+                    // (no-throw)
+                    void    construct_node() {
+                        if (value_constructed_ && !node_constructed_ && node_ptr_ != NULL) {
+                            // end 以外の新しいノードは赤とする
+                            ::new (static_cast<void*>(link_address_())) node_type(false);
+                            node_constructed_ = true;
                         }
                     }
 
@@ -493,9 +645,8 @@ namespace ft {
                     // 所有権は保持したまま。
                     node_pointer    release() {
                         if (node_constructed_ && value_constructed_) {
-                            node_pointer    rv = node_ptr_;
+                            node_pointer    rv = link_address_();
                             node_ptr_ = NULL;
-                            value_ptr_ = NULL;
                             node_constructed_ = false;
                             value_constructed_ = false;
                             return (rv);
@@ -504,20 +655,25 @@ namespace ft {
                     }
 
                 FT_PRIVATE:
+                    node_pointer    link_address_() const {
+                        return static_cast<node_pointer>(&*node_ptr_);
+                    }
+
+                    value_pointer   value_address_() const {
+                        return link_address_()->value();
+                    }
+
                     // ノード, value を保持している場合、それらを破壊する
                     void    destroy_() {
                         if (node_ptr_) {
+                            if (value_constructed_) {
+                                value_alloc_.destroy(value_address_());
+                            }
                             if (node_constructed_) {
-                                node_alloc_.destroy(node_ptr_);
+                                link_address_()->~node_type();
                             }
                             node_alloc_.deallocate(node_ptr_, 1);
                         }
-                        if (value_ptr_) {
-                            if (value_constructed_) {
-                                value_alloc_.destroy(value_ptr_);
-                            }
-                            value_alloc_.deallocate(value_ptr_, 1);
-                        }
                     }
             };
 
@@ -549,10 +705,10 @@ namespace ft {
                         : ptr_(other.ptr_) {}
                     iterator(const_iterator_type constant)
                         : ptr_(const_cast<pointer>(constant.operator->())) {}
-                    // iterator_type&  operator=(const iterator_type &rhs) {
-                    //     ptr_ = rhs.ptr_;
-                    //     return *this;
-                    // }
+                    iterator_type&  operator=(const iterator_type &rhs) {
+                        ptr_ = rhs.ptr_;
+                        return *this;
+                    }
                     // ~iterator() {}
 
                 FT_PRIVATE:
@@ -712,9 +868,39 @@ namespace ft {
                 begin_node_ = end_node();
             }
             // コピーコンストラクタ
-            tree(const self_type& other) {
-                *this = other;
+            // other の形と色をそのまま複製する。
+            // 比較もリバランスも行わないので O(N).
+            tree(const self_type& other):
+                end_node_(node_type()),
+                node_allocator_(other.node_allocator_),
+                value_allocator_(other.value_allocator_),
+                size_(0),
+                value_compare_(other.value_compare_)
+            {
+                begin_node_ = end_node();
+                if (other.root() != NULL) {
+                    // 例外が出た場合は clone_subtree_ が作りかけの部分を破壊する。
+                    // -> このtreeは空のまま
+                    end_node()->place_into_left(clone_subtree_(other.root()));
+                    size_ = other.size_;
+                    begin_node_ = leftmost_(root());
+                    end_node()->right() = rightmost_(root());
+                }
             }
+# ifdef FT_CXX11
+            // ムーブコンストラクタ
+            // other のノードをそのまま引き取る。other は空になる。
+            tree(self_type&& other):
+                end_node_(node_type()),
+                node_allocator_(other.node_allocator_),
+                value_allocator_(other.value_allocator_),
+                size_(0),
+                value_compare_(other.value_compare_)
+            {
+                begin_node_ = end_node();
+                swap(other);
+            }
+# endif
             // デストラクタ
             ~tree() {
                 clear();
@@ -723,16 +909,25 @@ namespace ft {
             self_type& operator=(const self_type& rhs) {
                 if (this == &rhs) { return *this; }
                 // copy and swap.
-                // - temp の作成に           O(1)
-                // - ranged-insertion に    O(N)
+                // - temp の作成(構造コピー)に O(N)
                 // - swapに                 O(1)
                 // - tempの破壊に            O(N)
                 // 全体で O(N).
-                self_type   temp(rhs.value_compare_, rhs.value_allocator_);
-                temp.insert_node_(rhs.begin(), rhs.end());
+                // temp の作成に失敗した場合 this は変化しない(STRONG).
+                self_type   temp(rhs);
+                swap(temp);
+                return *this;
+            }
+# ifdef FT_CXX11
+            // ムーブ代入
+            // rhs のノードを引き取り, this の元のノードは破壊する。rhs は空になる。
+            self_type& operator=(self_type&& rhs) {
+                if (this == &rhs) { return *this; }
+                self_type   temp(std::move(rhs));
                 swap(temp);
                 return *this;
             }
+# endif
 
             value_allocator_type&        get_allocator() { return value_allocator_; }
             const value_allocator_type&  get_allocator() const { return value_allocator_; }
@@ -772,12 +967,13 @@ namespace ft {
             // すべての要素を削除する(注意: endは破壊しない).
             // sizeが0になる.
             // beginはendと一致する.
-            // endの左子はNULLになる.
+            // endの左子・右子(最大ノードのキャッシュ)はNULLになる.
             void    clear() {
                 destroy_subtree_(root());
                 size_ = 0;
                 begin_node_ = end_node();
                 end_node()->left() = NULL;
+                end_node()->right() = NULL;
             }
 
             // [insert]
@@ -827,15 +1023,162 @@ namespace ft {
                 }
             }
 
+            // ソート済み・重複なし範囲挿入
+            // ツリーが空で, [first, last) が前方向イテレータなら,
+            // 比較もリバランスもせずに釣り合った木を1パスで組み立てる(線形時間)。
+            // そうでなければ end をヒントにした挿入にフォールバックする。
+            // 例外安全性はSTRONG(空のツリーに組み立てる場合は, 失敗すれば空のまま)
+            template <class InputIterator>
+            void    insert(sorted_unique_t, InputIterator first, InputIterator last) {
+                insert_sorted_unique_(first, last,
+                    ft::integral_constant<bool, ft::is_forward_iterator<InputIterator>::value>());
+            }
+
+# ifdef FT_CXX11
+            // [[ムーブ挿入・emplace(C++11 モード)]]
+
+            // key をムーブしてノードを作る(挿入できない場合はムーブしない)。
+            pair<iterator, bool>    insert(value_type&& key) {
+                pair<pointer, pointer*> place = find_equal_(key);
+                if (place.first == *(place.second)) {
+                    return make_pair(iterator(place.first), false);
+                }
+                return make_pair(iterator(link_at_(place, create_node_(std::move(key)))), true);
+            }
+
+            iterator    insert(iterator hint, value_type&& key) {
+                pair<pointer, pointer*> place = find_equal_(&*hint, key);
+                if (place.first == *(place.second)) {
+                    return iterator(place.first);
+                }
+                return iterator(link_at_(place, create_node_(std::move(key))));
+            }
+
+            // args から先にノードを作り, 挿入位置を探す。
+            // 同じ値がすでにあれば, 作ったノードを破壊する。
+            template <class... Args>
+            pair<iterator, bool>    emplace(Args&&... args) {
+                pointer                 node = create_node_(std::forward<Args>(args)...);
+                pair<pointer, pointer*> place;
+                try {
+                    place = find_equal_(*node->value());
+                } catch (...) {
+                    destroy_node_(node);
+                    throw;
+                }
+                if (place.first == *(place.second)) {
+                    destroy_node_(node);
+                    return make_pair(iterator(place.first), false);
+                }
+                return make_pair(iterator(link_at_(place, node)), true);
+            }
+
+            template <class... Args>
+            iterator    emplace_hint(iterator hint, Args&&... args) {
+                pointer                 node = create_node_(std::forward<Args>(args)...);
+                pair<pointer, pointer*> place;
+                try {
+                    place = find_equal_(&*hint, *node->value());
+                } catch (...) {
+                    destroy_node_(node);
+                    throw;
+                }
+                if (place.first == *(place.second)) {
+                    destroy_node_(node);
+                    return iterator(place.first);
+                }
+                return iterator(link_at_(place, node));
+            }
+# endif
+
         FT_PRIVATE:
+            template <class ForwardIterator>
+            void    insert_sorted_unique_(ForwardIterator first, ForwardIterator last, ft::true_type) {
+                if (!empty()) {
+                    insert_sorted_unique_(first, last, ft::false_type());
+                    return;
+                }
+                size_type   n = std::distance(first, last);
+                if (n == 0) { return; }
+                pointer top = build_subtree_(first, n, 0, red_depth_(n));
+                end_node()->place_into_left(top);
+                size_ = n;
+                begin_node_ = leftmost_(top);
+                end_node()->right() = rightmost_(top);
+            }
+
+            template <class InputIterator>
+            void    insert_sorted_unique_(InputIterator first, InputIterator last, ft::false_type) {
+                for (; first != last; ++first) {
+                    insert(end(), *first);
+                }
+            }
+
+            // n 要素を左右の要素数の差が高々1になるように並べた木では,
+            // 深さ(根が0) floor(log2 n) の段だけが埋まりきらない。
+            // その段のノードを赤, それ以外を黒にすれば黒高さが揃う。
+            // (n == 1 なら根しかないので, 赤にする段はない)
+            static size_type    red_depth_(size_type n) {
+                size_type   depth = 0;
+                for (; n > 1; n >>= 1) { ++depth; }
+                return depth > 0 ? depth : size_type(-1);
+            }
+
+            // first から n 要素を中順に読み進めながら, 深さ depth の部分木を組み立てて根を返す。
+            // (根の親は設定しない)
+            // 途中で例外が出た場合は, 作りかけの部分木を破壊してから投げ直す。
+            template <class ForwardIterator>
+            pointer build_subtree_(ForwardIterator& first, size_type n, size_type depth, size_type red_depth) {
+                if (n == 0) { return NULL; }
+                size_type   nl = (n - 1) / 2;
+                pointer     left = build_subtree_(first, nl, depth + 1, red_depth);
+                pointer     top;
+                try {
+                    top = create_node_(*first);
+                } catch (...) {
+                    destroy_subtree_(left);
+                    throw;
+                }
+                ++first;
+                if (depth != red_depth) {
+                    // 新しいノードは赤なので、黒にする段なら反転する
+                    top->flip_color();
+                }
+                if (left) {
+                    top->place_into_left(left);
+                }
+                try {
+                    pointer right = build_subtree_(first, n - 1 - nl, depth + 1, red_depth);
+                    if (right) {
+                        top->place_into_right(right);
+                    }
+                    update_subtree_size_(top);
+                } catch (...) {
+                    destroy_subtree_(top);
+                    throw;
+                }
+                return top;
+            }
+
             // [ライフサイクル]
 
             // value x を保持するノードを構築して、そのメモリアドレスを返す
+            // ノードとValueの確保は1回で済む。
+            // (C++11 モードでは args から value を直接構築する)
+# ifdef FT_CXX11
+            template <class... Args>
+            pointer create_node_(Args&&... args) {
+                node_allocator_type&    na = get_node_allocator();
+                value_allocator_type&   va = get_allocator();
+                node_holder_type        holder(na, va);
+                holder.construct_value(std::forward<Args>(args)...);
+# else
             pointer create_node_(const value_type& x) {
                 node_allocator_type&    na = get_node_allocator();
                 value_allocator_type&   va = get_allocator();
                 node_holder_type        holder(na, va);
                 holder.construct_value(x);
+# endif
                 holder.construct_node();
                 // releaseすると、holderは持っているノードを返す。
                 // その際、holderはノードの所有権も手放す。
@@ -846,16 +1189,55 @@ namespace ft {
             }
 
             // node_ptr が指し示すノードを破壊する
+            // (endノードは確保していないので何もしない)
             void    destroy_node_(pointer node_ptr) {
-                if (node_ptr == NULL) { return; }
-                if (node_ptr != end_node() && node_ptr->value()) {
-                    value_allocator_type&   va = get_allocator();
-                    va.destroy(node_ptr->value());
-                    va.deallocate(node_ptr->value(), 1);
-                }
+                if (node_ptr == NULL || node_ptr == end_node()) { return; }
+                value_allocator_type&   va = get_allocator();
+                va.destroy(node_ptr->value());
+                node_ptr->~node_type();
                 node_allocator_type&    na = get_node_allocator();
-                na.destroy(node_ptr);
-                na.deallocate(node_ptr, 1);
+                na.deallocate(static_cast<value_node_pointer>(node_ptr), 1);
+            }
+
+            // src を根とする部分木を, 形と色を保ったまま複製し, 複製の根を返す。
+            // (複製の根の親は設定しない)
+            // 比較もリバランスも行わない。
+            // 途中で例外が出た場合は, 作りかけの部分木を破壊してから投げ直す。
+            pointer clone_subtree_(const_pointer src) {
+                pointer top = create_node_(*src->value());
+                if (src->is_black()) {
+                    // 新しいノードは赤なので、黒なら反転する
+                    top->flip_color();
+                }
+                try {
+                    if (src->has_left_child()) {
+                        top->place_into_left(clone_subtree_(src->left()));
+                    }
+                    if (src->has_right_child()) {
+                        top->place_into_right(clone_subtree_(src->right()));
+                    }
+                    update_subtree_size_(top);
+                } catch (...) {
+                    destroy_subtree_(top);
+                    throw;
+                }
+                return top;
+            }
+
+            // node_ptr を根とする部分木の最小ノードを返す
+            static pointer  leftmost_(pointer node_ptr) {
+                while (node_ptr->has_left_child()) {
+                    node_ptr = node_ptr->left();
+                }
+                return node_ptr;
+            }
+
+            // node_ptr を根とする部分木の最大ノードを返す
+            static pointer  rightmost_(pointer node_ptr) {
+                while (node_ptr->has_right_child()) {
+                    node_ptr = node_ptr->right();
+                }
+                return node_ptr;
             }
 
             // node_ptr を根とする部分木を再帰的に破壊する。
@@ -917,6 +1299,80 @@ namespace ft {
                 return find_ptr_(x) == end_node() ? 0 : 1;
             }
 
+            // [[ヒントつき検索(フィンガーサーチ)]]
+            // hint の位置から上り, 答えを含む部分木まで来たら下る。
+            // hint と結果の間の要素数を d として, 多くの場合 O(log d)。
+            // (ソート済みのキー列を前回の結果から順に探せば, k 個で O(k log(n/k)))
+            // hint はこのツリーの任意のイテレータ(end を含む)でよい。
+            template <class Key>
+            iterator         lower_bound(iterator hint, const Key& key) {
+                return iterator(const_cast<pointer>(lower_bound_ptr_(&*hint, key)));
+            }
+            template <class Key>
+            const_iterator   lower_bound(const_iterator hint, const Key& key) const {
+                return const_iterator(lower_bound_ptr_(&*hint, key));
+            }
+            template <class Key>
+            iterator         find(iterator hint, const Key& key) {
+                iterator it = lower_bound(hint, key);
+                if (it == end() || value_compare()(key, *(it->value()))) {
+                    return end();
+                }
+                return it;
+            }
+            template <class Key>
+            const_iterator   find(const_iterator hint, const Key& key) const {
+                const_iterator it = lower_bound(hint, key);
+                if (it == end() || value_compare()(key, *(it->value()))) {
+                    return end();
+                }
+                return it;
+            }
+
+            // ソート済みのキー列 [first, last) のそれぞれについて find した結果を out に書き出す。
+            // 木を1回, 順方向にたどるだけで済む。
+            template <class InputIterator, class OutputIterator>
+            OutputIterator   find_sorted(InputIterator first, InputIterator last, OutputIterator out) {
+                iterator    finger = begin();
+                for (; first != last; ++first, ++out) {
+                    finger = lower_bound(finger, *first);
+                    if (finger == end() || value_compare()(*first, *(finger->value()))) {
+                        *out = end();
+                    } else {
+                        *out = finger;
+                    }
+                }
+                return out;
+            }
+            template <class InputIterator, class OutputIterator>
+            OutputIterator   find_sorted(InputIterator first, InputIterator last, OutputIterator out) const {
+                const_iterator  finger = begin();
+                for (; first != last; ++first, ++out) {
+                    finger = lower_bound(finger, *first);
+                    if (finger == end() || value_compare()(*first, *(finger->value()))) {
+                        *out = end();
+                    } else {
+                        *out = finger;
+                    }
+                }
+                return out;
+            }
+
+            // [[グループ検索]]
+            // 順不同のキー列 [first, last) のそれぞれについて find した結果を out に書き出す。
+            // Width 個の探索を並べて1段ずつ進め, 次に読むノードをプリフェッチしておく。
+            // 1つの探索がメモリを待つ間に他の探索を進められるので,
+            // キャッシュに載らない大きな木で効果がある。
+            // (キーを何度も読むので, [first, last) は前方向イテレータであること)
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator   find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+                return find_batch_<iterator, Width>(first, last, out);
+            }
+            template <std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator   find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+                return find_batch_<const_iterator, Width>(first, last, out);
+            }
+
             // ツリーが key を保持しているなら、keyを含む最小の半開区間[lower_bound, upper_bound)を返す。
             // 保持していないなら、[upper_bound, upper_bound)を返す。
             template <class Key>
@@ -959,6 +1415,80 @@ namespace ft {
             //     );
             // }
 
+            // [[順序統計]]
+            // FT_ORDER_STATISTICS_TREE が有効なら各ノードが部分木のノード数を持つので O(log n)。
+            // そうでなければ begin から数えるので O(n)。
+
+            // key より小さい要素の数
+            // (= lower_bound(key) の添字)
+            template <class Key>
+            size_type        rank(const Key& key) const {
+                return index_of_(lower_bound_ptr_(key));
+            }
+
+            // 先頭から i 番目(0始まり)の要素を返す。
+            // i >= size() なら end() を返す。
+            iterator         select(size_type i) {
+                return iterator(const_cast<pointer>(select_ptr_(i)));
+            }
+            const_iterator   select(size_type i) const {
+                return const_iterator(select_ptr_(i));
+            }
+
+            // first から last までの要素数
+            // (last が first より前にある場合は負)
+            difference_type  distance(const_iterator first, const_iterator last) const {
+                return static_cast<difference_type>(index_of_(&*last))
+                    - static_cast<difference_type>(index_of_(&*first));
+            }
+
+        FT_PRIVATE:
+
+            // node の添字を返す。end の添字は size()。
+            size_type        index_of_(const_pointer node) const {
+                if (node == end_node()) { return size_; }
+# ifdef FT_ORDER_STATISTICS_TREE
+                size_type   i = node_type::subtree_size_of(node->left());
+                for (; node->parent() != end_node(); node = node->parent()) {
+                    if (node->is_right_child()) {
+                        i += node_type::subtree_size_of(node->parent()->left()) + 1;
+                    }
+                }
+                return i;
+# else
+                size_type   i = 0;
+                for (const_iterator it = begin(); &*it != node; ++it) {
+                    ++i;
+                }
+                return i;
+# endif
+            }
+
+            // 添字が i のノードを返す。なければ end を返す。
+            const_pointer    select_ptr_(size_type i) const {
+                if (i >= size_) { return end_node(); }
+# ifdef FT_ORDER_STATISTICS_TREE
+                const_pointer   node = root();
+                while (true) {
+                    size_type   nl = node_type::subtree_size_of(node->left());
+                    if (i < nl) {
+                        node = node->left();
+                    } else if (i == nl) {
+                        return node;
+                    } else {
+                        i -= nl + 1;
+                        node = node->right();
+                    }
+                }
+# else
+                const_iterator  it = begin();
+                for (; i > 0; --i) {
+                    ++it;
+                }
+                return &*it;
+# endif
+            }
+
         FT_PRIVATE:
 
             pointer          end_node() { return &end_node_; }
@@ -967,6 +1497,9 @@ namespace ft {
             const_pointer    root() const { return end_node()->left(); }
             pointer          begin_node() { return begin_node_; }
             const_pointer    begin_node() const { return begin_node_; }
+            // 最大ノード(キャッシュ). 空ならNULL.
+            pointer          last_node() { return end_node()->right(); }
+            const_pointer    last_node() const { return end_node()->right(); }
 
             // key と一致するノードがあれば、そのポインタを返す。
             // "key と一致"とはつまり、xが key <= x && x <= key を満たすこと。
@@ -989,6 +1522,50 @@ namespace ft {
 
             // key以上の要素があれば、それらのうち最も小さいもののポインタを返す。
             // なければendのポインタを返す。
+            // find_batch の本体。結果を Iterator にして out に書き出す。
+            template <class Iterator, std::size_t Width, class ForwardIterator, class OutputIterator>
+            OutputIterator   find_batch_(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+                ForwardIterator keys[Width];
+                const_pointer   targets[Width];
+                const_pointer   results[Width];
+                while (first != last) {
+                    std::size_t n = 0;
+                    for (; n < Width && first != last; ++n, ++first) {
+                        keys[n] = first;
+                        targets[n] = root();
+                        results[n] = end_node();
+                    }
+                    // すべての探索が葉に着くまで, 各探索を1段ずつ下ろす。
+                    for (bool active = true; active;) {
+                        active = false;
+                        for (std::size_t i = 0; i < n; ++i) {
+                            const_pointer   target = targets[i];
+                            if (target == NULL) { continue; }
+                            if (value_compare()(*target->value(), *keys[i])) {
+                                target = target->right();
+                            } else {
+                                results[i] = target;
+                                target = target->left();
+                            }
+                            if (target != NULL) {
+                                FT_PREFETCH(target);
+                                active = true;
+                            }
+                            targets[i] = target;
+                        }
+                    }
+                    // results[i] は lower_bound なので, 一致するかを確かめる。
+                    for (std::size_t i = 0; i < n; ++i, ++out) {
+                        const_pointer   p = results[i];
+                        if (p == end_node() || value_compare()(*keys[i], *(p->value()))) {
+                            p = end_node();
+                        }
+                        *out = Iterator(const_cast<pointer>(p));
+                    }
+                }
+                return out;
+            }
+
             template <class Key>
             pointer    lower_bound_ptr_(const Key& key) {
                 pointer rv = end_node();
@@ -1025,6 +1602,61 @@ namespace ft {
                 return rv;
             }
 
+            // hint の位置から探す lower_bound
+            // hint から, 答えを含む部分木の根まで上ってから下る。
+            // hint と答えが近ければ(ソート済みの列を順に探す場合など)速い。
+            template <class Key>
+            const_pointer   lower_bound_ptr_(const_pointer hint, const Key& key) const {
+                if (hint == end_node()) {
+                    // end から探す場合は, 最大ノードから探す。
+                    if (last_node() == NULL || value_compare()(*last_node()->value(), key)) {
+                        return end_node();
+                    }
+                    hint = last_node();
+                }
+                const_pointer   rv = end_node();
+                const_pointer   target = hint;
+                if (value_compare()(*hint->value(), key)) {
+                    // hint < key
+                    // -> 左子である間に, 親が key 以上になるところまで上る。
+                    //    そこまでの部分木と親の間に答えがある。
+                    //    (根まで上った場合は木全体と end の間)
+                    while (target != root()) {
+                        const_pointer   parent = target->parent();
+                        if (target->is_left_child() && !value_compare()(*parent->value(), key)) {
+                            rv = parent;
+                            break;
+                        }
+                        target = parent;
+                    }
+                } else {
+                    // key <= hint
+                    // -> 答えは hint 以前にある。
+                    //    右子である間に, 親が key 未満になるところまで上る。
+                    //    そこまでの部分木(hint を含む)に答えがある。
+                    if (hint == begin_node()) {
+                        return hint;
+                    }
+                    while (target != root()) {
+                        const_pointer   parent = target->parent();
+                        if (target->is_right_child() && value_compare()(*parent->value(), key)) {
+                            break;
+                        }
+                        target = parent;
+                    }
+                }
+                // target の部分木を lower_bound_ptr_ と同じように下る。
+                while (target != NULL) {
+                    if (value_compare()(*target->value(), key)) {
+                        target = target->right();
+                    } else {
+                        rv = target;
+                        target = target->left();
+                    }
+                }
+                return rv;
+            }
+
             template <class Key>
             pointer    upper_bound_ptr_(const Key& key) {
                 pointer rv = end_node();
@@ -1092,11 +1724,7 @@ namespace ft {
                     }
                 }
                 // keyと同じものが見つかった。
-                pointer     target_parent = target->parent();
-                pointer*    target_ptr = &(
-                    target->is_left_child() ? target_parent->left() : target_parent->right()
-                );
-                return pair<pointer, pointer*>(target, target_ptr);
+                return pair<pointer, pointer*>(target, child_slot_(target));
             }
 
             // ヒントありfind_equal
@@ -1123,7 +1751,7 @@ namespace ft {
                             return pair<pointer, pointer*>(&*hint, &(hint->left()));
                         }
                     }
-                    return find_equal_(key);
+                    return find_equal_near_(hint, key);
                 } else if (value_compare()(*(hint->value()), key)) {
                     // (2) *hint < key
                     // -> next = hint + 1 として、 next == end or key < *next なら,
@@ -1143,17 +1771,55 @@ namespace ft {
                             return pair<pointer, pointer*>(&*hint, &(hint->right()));
                         }
                     }
-                    return find_equal_(key);
+                    return find_equal_near_(hint, key);
                 }
                 // (3) *hint == key
-                return pair<pointer, pointer*>(end_node(), &(end_node()->left()));
+                // -> 挿入できない. (first == *second で表す)
+                return pair<pointer, pointer*>(hint, child_slot_(hint));
             }
 
+            // hint と key が隣接していない場合のfind_equal
+            // hint からのフィンガーサーチで lower_bound を求め, その直前を挿入先にする。
+            // (根からの探索にフォールバックするより, hint が近ければ速い)
+            pair<pointer, pointer*> find_equal_near_(pointer hint, const value_type& key) {
+                pointer p = const_cast<pointer>(lower_bound_ptr_(hint, key));
+                if (p != end_node() && !value_compare()(key, *(p->value()))) {
+                    // *p == key -> 挿入不可
+                    return pair<pointer, pointer*>(p, child_slot_(p));
+                }
+                // key は p の直前に入る.
+                if (p == end_node()) {
+                    if (root() == NULL) {
+                        return pair<pointer, pointer*>(end_node(), &(end_node()->left()));
+                    }
+                    return pair<pointer, pointer*>(last_node(), &(last_node()->right()));
+                }
+                if (p->left() == NULL) {
+                    return pair<pointer, pointer*>(p, &(p->left()));
+                }
+                pointer prev = rightmost_(p->left());
+                return pair<pointer, pointer*>(prev, &(prev->right()));
+            }
+
+            // node を指している, 親の子ポインタのアドレス
+            // (根なら end の左子)
+            static pointer* child_slot_(pointer node) {
+                pointer parent = node->parent();
+                return &(node->is_left_child() ? parent->left() : parent->right());
+            }
+
+
             pointer insert_at_(pair<pointer, pointer*>& place, const value_type& x) {
-                *(place.second) = create_node_(x);
+                return link_at_(place, create_node_(x));
+            }
+
+            // 構築済みのノード node を place の位置につなぎ, 均衡を直す。
+            pointer link_at_(pair<pointer, pointer*>& place, pointer node) {
+                *(place.second) = node;
                 pointer inserted = *(place.second);
-                (*(place.second))->parent() = place.first;
+                (*(place.second))->set_parent(place.first);
                 size_ += 1;
+                increase_subtree_sizes_(place.first, 1);
                 // begin が変更されるのは:
                 // 1. beginより小さい要素が挿入された時
                 // 2. beginが削除された時
@@ -1161,16 +1827,14 @@ namespace ft {
                 if (begin_node()->left() == *(place.second)) {
                     begin_node_ = *(place.second);
                 }
+                // 最大ノードも同様. (空のツリーへの挿入なら, 挿入されたノードが最大ノード)
+                if (last_node() == NULL || last_node()->right() == inserted) {
+                    end_node()->right() = inserted;
+                }
                 rebalance_after_insertion_(*(place.second));
                 return inserted;
             }
 
-            void    insert_node_(const_iterator first, const_iterator last) {
-                for (; first != last; ++first) {
-                    insert(end(), *(first->value()));
-                }
-            }
-
 
         public:
             // [[swap]]
@@ -1196,10 +1860,269 @@ namespace ft {
                 if (size() == 0) {
                     // size() == 0 なら、beginをendに再設定する。
                     begin_node_ = end_node();
+                    end_node()->right() = NULL;
                 } else {
                     // ルートノートがある(<=> size() > 0)なら、ルートの親を今のendに設定し直す。
-                    root()->parent() = end_node();
+                    root()->set_parent(end_node());
+                }
+            }
+
+        public:
+
+            // [[split / join]]
+            // ノードを付け替えるだけで, 要素のコピーも確保も行わない。
+            // (そのため, 2つのツリーのアロケータは等しくなければならない。
+            //  等しくない場合は要素ごとの挿入・削除にフォールバックする。
+            //  node_pool ではコピーで作ったツリーどうし以外はプールが別なので, こちらになる)
+
+            // key 以上の要素をすべて out に移し, key 未満の要素を this に残す。
+            // out が元々持っていた要素は破壊される。
+            template <class Key>
+            void    split(const Key& key, self_type& out) {
+                split(lower_bound(key), out);
+            }
+
+            // position 以降の要素をすべて out に移す。
+            // ツリーの組み換えは O(log n)。
+            // ただし要素数の数え直しに, 2つに分けたうち小さい方の要素数に比例する時間がかかる。
+            void    split(iterator position, self_type& out) {
+                if (&out == this) { return; }
+                out.clear();
+                out.value_compare_ = value_compare_;
+                if (position == end()) { return; }
+                if (position == begin()) {
+                    swap(out);
+                    return;
+                }
+                if (!(get_node_allocator() == out.get_node_allocator())) {
+                    for (const_iterator it = position; it != end(); ++it) {
+                        out.insert(out.end(), *(it->value()));
+                    }
+                    erase(position, end());
+                    return;
+                }
+                // 根から position までの道筋(左右)を記録しておく。
+                // 赤黒木の高さは 2 * log2(n + 1) 以下なので, 固定長で足りる。
+                bool        path[sizeof(size_type) * CHAR_BIT * 2];
+                size_type   depth = 0;
+                for (pointer node = &*position; node != root(); node = node->parent()) {
+                    path[depth++] = node->is_right_child();
+                }
+                std::reverse(path, path + depth);
+                size_type   total = size_;
+                size_type   h = black_height_(root());
+                pointer     top = detach_root_();
+                pointer     l;
+                pointer     r;
+                size_type   hl;
+                size_type   hr;
+                split_subtree_(top, h, path, depth, 0, l, hl, r, hr);
+                set_root_(l);
+                out.set_root_(r);
+                recount_(out, total);
+            }
+
+            // other の要素をすべて this に移し, other を空にする。
+            // 一方のすべての要素が他方のすべての要素より小さければ O(log n)。
+            // そうでなければ other の要素を1つずつ挿入する。
+            // (this にすでにある要素と重複する other の要素は破壊される)
+            void    join(self_type& other) {
+                if (&other == this || other.empty()) { return; }
+                if (empty()) {
+                    // ノードだけを引き取り, 比較関数はそれぞれ自分のものを残す
+                    swap(other);
+                    ft::swap(value_compare_, other.value_compare_);
+                    return;
+                }
+                if (!(get_node_allocator() == other.get_node_allocator())) {
+                    join_by_insertion_(other);
+                    return;
+                }
+                const value_type&   this_max = *(last_node()->value());
+                const value_type&   other_max = *(other.last_node()->value());
+                bool    this_is_left;
+                if (value_compare()(this_max, *(other.begin_node()->value()))) {
+                    this_is_left = true;
+                } else if (value_compare()(other_max, *(begin_node()->value()))) {
+                    this_is_left = false;
+                } else {
+                    join_by_insertion_(other);
+                    return;
+                }
+                // 右側のツリーの最小ノードを抜き出して, 2つの木をつなぐノードにする。
+                pointer     mid = this_is_left ? other.extract_(other.begin()) : extract_(begin());
+                size_type   total = size_ + other.size_ + 1;
+                size_type   hl = black_height_(this_is_left ? root() : other.root());
+                size_type   hr = black_height_(this_is_left ? other.root() : root());
+                pointer     lt = this_is_left ? detach_root_() : other.detach_root_();
+                pointer     rt = this_is_left ? other.detach_root_() : detach_root_();
+                size_type   h;
+                set_root_(join_subtrees_(lt, hl, mid, rt, hr, h));
+                size_ = total;
+            }
+
+        FT_PRIVATE:
+
+            // 親から切り離された部分木 node (根は黒, 黒高さ h) を,
+            // path で示される位置より前のノードからなる部分木 l と,
+            // それ以降のノードからなる部分木 r に分ける。
+            // l, r はそれぞれ根が黒の部分木で, 黒高さは hl, hr。
+            void    split_subtree_(
+                pointer node, size_type h,
+                const bool* path, size_type depth, size_type d,
+                pointer& l, size_type& hl, pointer& r, size_type& hr
+            ) {
+                if (node == NULL) {
+                    l = r = NULL;
+                    hl = hr = 0;
+                    return;
+                }
+                size_type   hll = h - 1;
+                size_type   hrr = h - 1;
+                pointer     left = cut_subtree_(node->left(), hll);
+                pointer     right = cut_subtree_(node->right(), hrr);
+                node->left() = NULL;
+                node->right() = NULL;
+                // d < depth: 分割位置は node の path[d] 側にある
+                // d == depth: node が分割位置
+                // d > depth: node は分割位置の左部分木にある
+                bool    node_goes_left = d < depth ? path[d] : d > depth;
+                if (node_goes_left) {
+                    pointer     rl;
+                    size_type   hrl;
+                    split_subtree_(right, hrr, path, depth, d + 1, rl, hrl, r, hr);
+                    l = join_subtrees_(left, hll, node, rl, hrl, hl);
+                } else {
+                    pointer     lr;
+                    size_type   hlr;
+                    split_subtree_(left, hll, path, depth, d + 1, l, hl, lr, hlr);
+                    r = join_subtrees_(lr, hlr, node, right, hrr, hr);
+                }
+            }
+
+            // 部分木 l (黒高さ hl), ノード mid, 部分木 r (黒高さ hr) を,
+            // この順に並ぶ1つの赤黒木にまとめて, その根を返す。
+            // l, r は親から切り離されていて, 根が黒であること。
+            // 作業中は this の end ノードを借りるので, this は空でなければならない。
+            // O(|hl - hr| + 1)
+            pointer join_subtrees_(pointer l, size_type hl, pointer mid, pointer r, size_type hr, size_type& h) {
+                mid->left() = NULL;
+                mid->right() = NULL;
+                if (mid->is_black()) {
+                    mid->flip_color();
+                }
+                if (hl >= hr) {
+                    // l の右端を下り, 黒高さが hr の黒ノード y を探す。
+                    // y の位置に mid を置き, y と r をその子にする。
+                    end_node()->place_into_left(l);
+                    pointer     parent = end_node();
+                    pointer     y = l;
+                    size_type   hy = hl;
+                    while (y != NULL && (hy > hr || !y->is_black())) {
+                        if (y->is_black()) { --hy; }
+                        parent = y;
+                        y = y->right();
+                    }
+                    if (parent == end_node()) {
+                        parent->place_into_left(mid);
+                    } else {
+                        parent->place_into_right(mid);
+                    }
+                    mid->place_into_left(y);
+                    mid->place_into_right(r);
+                    update_subtree_size_(mid);
+                    increase_subtree_sizes_(parent, subtree_size_(r) + 1);
+                } else {
+                    // 左右反対
+                    end_node()->place_into_left(r);
+                    pointer     parent = end_node();
+                    pointer     y = r;
+                    size_type   hy = hr;
+                    while (y != NULL && (hy > hl || !y->is_black())) {
+                        if (y->is_black()) { --hy; }
+                        parent = y;
+                        y = y->left();
+                    }
+                    parent->place_into_left(mid);
+                    mid->place_into_left(l);
+                    mid->place_into_right(y);
+                    update_subtree_size_(mid);
+                    increase_subtree_sizes_(parent, subtree_size_(l) + 1);
+                }
+                // mid は赤なので, 挿入と同じリバランスで赤が連続しないようにする。
+                h = std::max(hl, hr) + (rebalance_after_insertion_(mid) ? 1 : 0);
+                pointer top = root();
+                end_node()->left() = NULL;
+                top->set_parent(NULL);
+                return top;
+            }
+
+            // 部分木の根 node を親から切り離し, 黒く塗る。
+            // h は node の元の黒高さで, 赤から黒にした場合は1増やす。
+            static pointer  cut_subtree_(pointer node, size_type& h) {
+                if (node == NULL) { return NULL; }
+                node->set_parent(NULL);
+                if (!node->is_black()) {
+                    node->flip_color();
+                    ++h;
+                }
+                return node;
+            }
+
+            // node を根とする部分木の黒高さ
+            static size_type    black_height_(const_pointer node) {
+                size_type   h = 0;
+                for (; node != NULL; node = node->left()) {
+                    if (node->is_black()) { ++h; }
+                }
+                return h;
+            }
+
+            // ルートを親から切り離して返し, ツリーを空にする。
+            pointer detach_root_() {
+                pointer top = root();
+                if (top != NULL) {
+                    top->set_parent(NULL);
+                }
+                end_node()->left() = NULL;
+                end_node()->right() = NULL;
+                begin_node_ = end_node();
+                size_ = 0;
+                return top;
+            }
+
+            // 親から切り離された部分木 top をルートにする。
+            // (size_ は呼び出し側で設定する)
+            void    set_root_(pointer top) {
+                end_node()->place_into_left(top);
+                begin_node_ = top != NULL ? leftmost_(top) : end_node();
+                end_node()->right() = top != NULL ? rightmost_(top) : NULL;
+            }
+
+            // 2つに分けた this と other の要素数を, 合計が total であることを使って数え直す。
+            // 2つを同時に走査し, 先に尽きた方の要素数を数えるので, 小さい方の要素数に比例する。
+            void    recount_(self_type& other, size_type total) {
+# ifdef FT_ORDER_STATISTICS_TREE
+                size_ = subtree_size_(root());
+                other.size_ = total - size_;
+# else
+                const_iterator  it = begin();
+                const_iterator  oit = other.begin();
+                size_type       n = 0;
+                for (; it != end() && oit != other.end(); ++it, ++oit) {
+                    ++n;
+                }
+                size_ = it == end() ? n : total - n;
+                other.size_ = total - size_;
+# endif
+            }
+
+            // other の要素を1つずつ this に挿入し, other を空にする。
+            void    join_by_insertion_(self_type& other) {
+                for (const_iterator it = other.begin(); it != other.end(); ++it) {
+                    insert(*(it->value()));
                 }
+                other.clear();
             }
 
         public:
@@ -1209,23 +2132,7 @@ namespace ft {
             // (1)
             // 単一削除
             void        erase(iterator position) {
-                swap_down_(position);
-
-                // ここまで来たということは、positionは子を持たない。
-                pointer target = &(*position);
-                pointer parent = target->parent();
-                bool    target_is_black = target->is_black();
-                bool    target_is_begin = target == begin_node();
-                release_node_from_parent_(target);
-                destroy_node_(target);
-                // Case 0. is red -> 破壊するだけ
-                if (target_is_black) {
-                    rebalance_after_erasure_(parent, NULL);
-                }
-                // 必要なら begin_node_ を更新
-                if (target_is_begin) {
-                    begin_node_ = parent;
-                }
+                destroy_node_(extract_(position));
             }
 
             // (2)
@@ -1276,36 +2183,65 @@ namespace ft {
 
         FT_PRIVATE:
 
+            // position のノードをツリーから切り離して返す。
+            // ノードは破壊しない。
+            pointer     extract_(iterator position) {
+                // 最大ノードを抜くなら, 直前のノードが新しい最大ノード(なければNULL)。
+                // (swap_down_ で位置が変わる前に求めておく)
+                if (&*position == last_node()) {
+                    end_node()->right() = last_node()->backward_neighbor();
+                }
+                swap_down_(position);
+
+                // ここまで来たということは、positionは子を持たない。
+                pointer target = &(*position);
+                pointer parent = target->parent();
+                bool    target_is_black = target->is_black();
+                bool    target_is_begin = target == begin_node();
+                release_node_from_parent_(target);
+                decrease_subtree_sizes_(parent, 1);
+                // Case 0. is red -> 切り離すだけ
+                if (target_is_black) {
+                    rebalance_after_erasure_(parent, NULL);
+                }
+                // 必要なら begin_node_ を更新
+                if (target_is_begin) {
+                    begin_node_ = parent;
+                }
+                return target;
+            }
+
             // [[リバランシング]]
 
             // 挿入後リバランス
-            void    rebalance_after_insertion_(pointer node) {
+            // 根を黒に色変した(=木の黒高さが1増えた)なら true を返す。
+            bool    rebalance_after_insertion_(pointer node) {
                 // 0. Nが通常ノードでないか、黒ノードの場合
                 // -> なにもしない
                 if (node == NULL) {
                     // DOUT() << "do nothing; is NULL" << std::endl;
-                    return;
+                    return false;
                 }
                 if (node == end_node()) {
                     // DOUT() << "do nothing; is end" << std::endl;
-                    return;
+                    return false;
                 }
                 if (node->is_black()) {
                     // DOUT() << "do nothing; is black" << std::endl;
-                    return;
+                    return false;
                 }
                 // 1. Nが根ノードの場合
                 // -> 色変して終わり
                 if (node == root()) {
                     // DOUT() << "flip and exit; is root" << std::endl;
                     node->flip_color();
-                    return;
+                    return true;
                 }
                 // 2. Nの親が黒ノードの場合
                 // -> なにもしなくてよい
                 if (node->parent()->is_black()) {
                     // DOUT() << "do nothing; parent is black" << std::endl;
-                    return;
+                    return false;
                 }
                 // 3. Nの親が赤ノードの場合
                 if (node->is_cis_child()) {
@@ -1326,6 +2262,7 @@ namespace ft {
                     // P, Qを色変する
                     // さらにQ-Pに対して右回転を行う。
                     rotate_flip_(q, p);
+                    return false;
                 } else {
                     // Uが赤ノードの場合
                     // P, Q, Uの色を反転する。
@@ -1333,7 +2270,7 @@ namespace ft {
                     p->flip_color();
                     q->flip_color();
                     u->flip_color();
-                    rebalance_after_insertion_(q);
+                    return rebalance_after_insertion_(q);
                 }
                 // DOUT() << "node -> " << *node << std::endl;
             }
@@ -1418,6 +2355,50 @@ namespace ft {
                 --size_;
             }
 
+            // [[部分木のノード数]]
+            // FT_ORDER_STATISTICS_TREE が無効な場合は何もしない(0を返す)。
+
+            static size_type    subtree_size_(const_pointer node) {
+# ifdef FT_ORDER_STATISTICS_TREE
+                return node_type::subtree_size_of(node);
+# else
+                (void)node;
+                return 0;
+# endif
+            }
+
+            // node の部分木のノード数を, 子の部分木のノード数から数え直す
+            static void update_subtree_size_(pointer node) {
+# ifdef FT_ORDER_STATISTICS_TREE
+                node->update_subtree_size();
+# else
+                (void)node;
+# endif
+            }
+
+            // node から根までの各ノードの部分木のノード数を n 増やす(減らす)。
+            // (node が end なら何もしない)
+            static void increase_subtree_sizes_(pointer node, size_type n) {
+# ifdef FT_ORDER_STATISTICS_TREE
+                for (; node->parent() != NULL; node = node->parent()) {
+                    node->set_subtree_size(node->subtree_size() + n);
+                }
+# else
+                (void)node;
+                (void)n;
+# endif
+            }
+            static void decrease_subtree_sizes_(pointer node, size_type n) {
+# ifdef FT_ORDER_STATISTICS_TREE
+                for (; node->parent() != NULL; node = node->parent()) {
+                    node->set_subtree_size(node->subtree_size() - n);
+                }
+# else
+                (void)node;
+                (void)n;
+# endif
+            }
+
             // [[リバランス関連staticメンバ関数]]
 
             // ノードとその親について, 可能な回転を行う.
@@ -1455,6 +2436,9 @@ namespace ft {
                 } else {
                     pa->place_into_right(c);
                 }
+                // 4. 部分木が変わったA, Cの順に数え直す
+                update_subtree_size_(a);
+                update_subtree_size_(c);
             }
 
             // ノードa, cについて右回転する.
@@ -1480,6 +2464,9 @@ namespace ft {
                 } else {
                     pc->place_into_right(a);
                 }
+                // 4. 部分木が変わったC, Aの順に数え直す
+                update_subtree_size_(c);
+                update_subtree_size_(a);
             }
 
             // 回転と色反転を同時に行う
@@ -1500,7 +2487,6 @@ namespace ft {
                 std::cerr << name << "(" << node << ").(p, l, r) = (" << node->parent() << ", " << node->left() << ", " << node->right() << ")" << std::endl;
             }
 
-        /*
         // [[デバッグメソッド]]
         public:
 
@@ -1521,7 +2507,10 @@ namespace ft {
             size_type   debug_longest_black_height() const {
                 return root() ? root()->debug_longest_black_height() : 0;
             }
-        */
+
+            bool        debug_no_red_red() const {
+                return root() ? root()->debug_no_red_red() : true;
+            }
     };
 }
 
@@ -0,0 +1,303 @@
+#ifndef UNORDERED_MAP_HPP
+# define UNORDERED_MAP_HPP
+# include "hash_table.hpp"
+# include "hash.hpp"
+# include "pair.hpp"
+# include <functional>
+# include <stdexcept>
+
+namespace ft {
+
+    // [unordered_map]
+    // オープンアドレス法のハッシュテーブル(hash_table)を使ったmap。
+    // 要素はテーブルの配列に直接置かれ, ノードごとの確保をしない。
+    // std::unordered_map との違い:
+    // - 挿入はすべてのイテレータ・参照を無効にする(再ハッシュしなくても値が動くことがある)。
+    // - 削除は, 消した要素より後ろにある一部のイテレータを無効にする。
+    //   erase の戻り値で走査を続けるのは安全。
+    // - バケットごとのインターフェース(bucket, begin(n) など)はない。
+    template <
+        class Key,
+        class Value,
+        class Hasher = ft::hash<Key>,
+        class KeyEqual = std::equal_to<Key>,
+        class PairAllocator = std::allocator<ft::pair<const Key, Value> >
+    >
+    class unordered_map {
+        public:
+            typedef Key                                         key_type;
+            typedef Value                                       mapped_type;
+            typedef ft::pair<const key_type, mapped_type>       value_type;
+            typedef Hasher                                      hasher;
+            typedef KeyEqual                                    key_equal;
+            typedef PairAllocator                               allocator_type;
+            typedef unordered_map<key_type, mapped_type, hasher, key_equal, allocator_type>
+                                                                self_type;
+            typedef value_type&                                 reference;
+            typedef const value_type&                           const_reference;
+            typedef typename allocator_type::pointer            pointer;
+            typedef typename allocator_type::const_pointer      const_pointer;
+            typedef typename allocator_type::size_type          size_type;
+            typedef typename allocator_type::difference_type    difference_type;
+
+            // hash_table と unordered_map を接続するハッシュ関数
+            // (値からでもキーからでもハッシュ値を出す)
+            class map_hasher {
+                FT_PRIVATE:
+                    hasher  hasher_;
+
+                public:
+                    map_hasher()
+                        : hasher_() {}
+
+                    explicit map_hasher(hasher h)
+                        : hasher_(h) {}
+
+                    const hasher&   hash_function() const { return hasher_; }
+
+                    std::size_t operator()(const value_type& x) const {
+                        return hasher_(x.first);
+                    }
+
+                    std::size_t operator()(const key_type& x) const {
+                        return hasher_(x);
+                    }
+            };
+
+            // hash_table と unordered_map を接続する等価判定
+            class map_key_equal {
+                FT_PRIVATE:
+                    key_equal   key_equal_;
+
+                public:
+                    map_key_equal()
+                        : key_equal_() {}
+
+                    explicit map_key_equal(key_equal e)
+                        : key_equal_(e) {}
+
+                    const key_equal&    key_eq() const { return key_equal_; }
+
+                    bool operator()(const value_type& x, const value_type& y) const {
+                        return key_equal_(x.first, y.first);
+                    }
+
+                    bool operator()(const value_type& x, const key_type& y) const {
+                        return key_equal_(x.first, y);
+                    }
+            };
+
+            // 内部hash_table
+            typedef ft::hash_table<value_type, map_hasher, map_key_equal, allocator_type>
+                                                                base;
+            typedef typename base::iterator                     iterator;
+            typedef typename base::const_iterator               const_iterator;
+
+        FT_PRIVATE:
+
+            // 内部hash_table
+            base    table_;
+
+        public:
+
+            // [[コンストラクタ群]]
+
+            unordered_map()
+                : table_(0, map_hasher(), map_key_equal(), PairAllocator()) {}
+
+            explicit unordered_map(
+                size_type bucket_count,
+                const Hasher& hash = Hasher(),
+                const KeyEqual& equal = KeyEqual(),
+                const PairAllocator& alloc = PairAllocator()
+            ): table_(bucket_count, map_hasher(hash), map_key_equal(equal), alloc) {}
+
+            template <class InputIterator>
+            unordered_map(InputIterator first,
+                InputIterator last,
+                size_type bucket_count = 0,
+                const Hasher& hash = Hasher(),
+                const KeyEqual& equal = KeyEqual(),
+                const PairAllocator& alloc = PairAllocator()
+            ): table_(bucket_count, map_hasher(hash), map_key_equal(equal), alloc) {
+                insert(first, last);
+            }
+
+            unordered_map(const self_type& other)
+                : table_(other.table_) {}
+
+            ~unordered_map() {}
+
+            self_type&      operator=(const self_type& rhs) {
+                if (this == &rhs) { return *this; }
+                table_ = rhs.table_;
+                return *this;
+            }
+
+            // [[getter群]]
+
+            allocator_type  get_allocator() const {
+                return allocator_type(table_.get_allocator());
+            }
+
+            iterator        begin() { return table_.begin(); }
+            const_iterator  begin() const { return table_.begin(); }
+            iterator        end() { return table_.end(); }
+            const_iterator  end() const { return table_.end(); }
+
+            bool            empty() const { return table_.empty(); }
+            size_type       size() const { return table_.size(); }
+            size_type       max_size() const { return table_.max_size(); }
+
+            // [[ライフサイクル]]
+
+            // バケット数はそのまま。
+            void            clear() { table_.clear(); }
+
+            // [[挿入系関数群]]
+
+            pair<iterator, bool>    insert(const value_type& v) {
+                return table_.insert(v);
+            }
+            // ヒントは使わない。
+            iterator                insert(const_iterator hint, const value_type& v) {
+                (void)hint;
+                return table_.insert(v).first;
+            }
+            template <class InputIterator>
+            void                    insert(InputIterator first, InputIterator last) {
+                table_.insert(first, last);
+            }
+
+            // [[削除]]
+
+            // 次の要素を指すイテレータを返す。
+            iterator     erase(const_iterator position) {
+                return table_.erase(position);
+            }
+            size_type    erase(const key_type& x) {
+                return table_.erase_by_key(x);
+            }
+            iterator     erase(const_iterator first, const_iterator last) {
+                return table_.erase(first, last);
+            }
+
+            void         swap(self_type& other) {
+                table_.swap(other.table_);
+            }
+
+            // [[検索系関数]]
+
+            Value&          operator[](const key_type& x) {
+                iterator    it = table_.find(x);
+                if (it == end()) {
+                    it = table_.insert(value_type(x, mapped_type())).first;
+                }
+                return it->second;
+            }
+
+            // x がなければ std::out_of_range 型の例外が投げられます。
+            Value&          at(const key_type& x) {
+                iterator    it = table_.find(x);
+                if (it == end()) {
+                    throw std::out_of_range("unordered_map");
+                }
+                return it->second;
+            }
+            const Value&    at(const key_type& x) const {
+                const_iterator  it = table_.find(x);
+                if (it == end()) {
+                    throw std::out_of_range("unordered_map");
+                }
+                return it->second;
+            }
+
+            size_type       count(const key_type& x) const {
+                return table_.count(x);
+            }
+
+            iterator        find(const key_type& x) {
+                return table_.find(x);
+            }
+            const_iterator  find(const key_type& x) const {
+                return table_.find(x);
+            }
+
+            pair<iterator, iterator>                equal_range(const key_type& x) {
+                return table_.equal_range(x);
+            }
+            pair<const_iterator, const_iterator>    equal_range(const key_type& x) const {
+                return table_.equal_range(x);
+            }
+
+            // [[バケット]]
+
+            size_type       bucket_count() const { return table_.bucket_count(); }
+            float           load_factor() const { return table_.load_factor(); }
+            float           max_load_factor() const { return table_.max_load_factor(); }
+            // 0.95 より大きい値は 0.95 に切り詰める。
+            void            max_load_factor(float ml) { table_.max_load_factor(ml); }
+            void            rehash(size_type count) { table_.rehash(count); }
+            void            reserve(size_type count) { table_.reserve(count); }
+
+            // [[観察者]]
+
+            hasher          hash_function() const {
+                return table_.hash_function().hash_function();
+            }
+
+            key_equal       key_eq() const {
+                return table_.key_eq().key_eq();
+            }
+
+            // 古いテーブルからの移し替えの途中か(テスト用)
+            bool            rehashing() const {
+                return table_.rehashing();
+            }
+
+            // 内部構造が正しいか(テスト用)
+            bool            debug_valid() const {
+                return table_.debug_valid();
+            }
+    };
+
+    // [比較演算子]
+    // 順序によらず, 同じキーに同じ値が対応していれば等しい。
+
+    template <class Key, class Value, class Hasher, class KeyEqual, class PairAllocator>
+    inline bool operator==(
+        const ft::unordered_map<Key, Value, Hasher, KeyEqual, PairAllocator>& lhs,
+        const ft::unordered_map<Key, Value, Hasher, KeyEqual, PairAllocator>& rhs
+    ) {
+        typedef typename ft::unordered_map<Key, Value, Hasher, KeyEqual, PairAllocator>::const_iterator
+            const_iterator;
+        if (lhs.size() != rhs.size()) { return false; }
+        for (const_iterator it = lhs.begin(); it != lhs.end(); ++it) {
+            const_iterator  found = rhs.find(it->first);
+            if (found == rhs.end() || !(found->second == it->second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class Key, class Value, class Hasher, class KeyEqual, class PairAllocator>
+    inline bool operator!=(
+        const ft::unordered_map<Key, Value, Hasher, KeyEqual, PairAllocator>& lhs,
+        const ft::unordered_map<Key, Value, Hasher, KeyEqual, PairAllocator>& rhs
+    ) {
+        return !(lhs == rhs);
+    }
+}
+
+namespace std {
+    template <class Key, class Value, class Hasher, class KeyEqual, class PairAllocator>
+    inline void swap(
+        ft::unordered_map<Key, Value, Hasher, KeyEqual, PairAllocator>& lhs,
+        ft::unordered_map<Key, Value, Hasher, KeyEqual, PairAllocator>& rhs
+    ) {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
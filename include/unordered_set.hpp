@@ -0,0 +1,205 @@
+#ifndef UNORDERED_SET_HPP
+# define UNORDERED_SET_HPP
+# include "hash_table.hpp"
+# include "hash.hpp"
+# include "pair.hpp"
+# include <functional>
+
+namespace ft {
+
+    // [unordered_set]
+    // ft::unordered_map と同じハッシュテーブルを使ったset。
+    // std::unordered_set との違いは unordered_map と同じ。
+    template <
+        class Key,
+        class Hasher = ft::hash<Key>,
+        class KeyEqual = std::equal_to<Key>,
+        class KeyAllocator = std::allocator<Key>
+    >
+    class unordered_set {
+        public:
+            typedef Key                                         key_type;
+            typedef Key                                         value_type;
+            typedef Hasher                                      hasher;
+            typedef KeyEqual                                    key_equal;
+            typedef KeyAllocator                                allocator_type;
+            typedef unordered_set<key_type, hasher, key_equal, allocator_type>
+                                                                self_type;
+            typedef value_type&                                 reference;
+            typedef const value_type&                           const_reference;
+            typedef typename allocator_type::pointer            pointer;
+            typedef typename allocator_type::const_pointer      const_pointer;
+            typedef typename allocator_type::size_type          size_type;
+            typedef typename allocator_type::difference_type    difference_type;
+
+            // 内部hash_table
+            typedef ft::hash_table<value_type, hasher, key_equal, allocator_type>
+                                                                base;
+            typedef typename base::const_iterator               const_iterator;
+            typedef const_iterator                              iterator;
+
+        FT_PRIVATE:
+
+            // 内部hash_table
+            base    table_;
+
+        public:
+
+            // [[コンストラクタ群]]
+
+            unordered_set()
+                : table_(0, Hasher(), KeyEqual(), KeyAllocator()) {}
+
+            explicit unordered_set(
+                size_type bucket_count,
+                const Hasher& hash = Hasher(),
+                const KeyEqual& equal = KeyEqual(),
+                const KeyAllocator& alloc = KeyAllocator()
+            ): table_(bucket_count, hash, equal, alloc) {}
+
+            template <class InputIterator>
+            unordered_set(InputIterator first,
+                InputIterator last,
+                size_type bucket_count = 0,
+                const Hasher& hash = Hasher(),
+                const KeyEqual& equal = KeyEqual(),
+                const KeyAllocator& alloc = KeyAllocator()
+            ): table_(bucket_count, hash, equal, alloc) {
+                insert(first, last);
+            }
+
+            unordered_set(const self_type& other)
+                : table_(other.table_) {}
+
+            ~unordered_set() {}
+
+            self_type&      operator=(const self_type& rhs) {
+                if (this == &rhs) { return *this; }
+                table_ = rhs.table_;
+                return *this;
+            }
+
+            allocator_type  get_allocator() const {
+                return allocator_type(table_.get_allocator());
+            }
+
+            iterator        begin() const { return table_.begin(); }
+            iterator        end() const { return table_.end(); }
+
+            bool            empty() const { return table_.empty(); }
+            size_type       size() const { return table_.size(); }
+            size_type       max_size() const { return table_.max_size(); }
+
+            // バケット数はそのまま。
+            void            clear() { table_.clear(); }
+
+            // [[挿入系関数群]]
+            pair<iterator, bool>    insert(const value_type& v) {
+                pair<typename base::iterator, bool> result = table_.insert(v);
+                return ft::make_pair(iterator(result.first), result.second);
+            }
+            // ヒントは使わない。
+            iterator                insert(const_iterator hint, const value_type& v) {
+                (void)hint;
+                return table_.insert(v).first;
+            }
+            template <class InputIterator>
+            void                    insert(InputIterator first, InputIterator last) {
+                table_.insert(first, last);
+            }
+
+            // [[削除]]
+            // 次の要素を指すイテレータを返す。
+            iterator     erase(const_iterator position) {
+                return table_.erase(position);
+            }
+            size_type    erase(const key_type& x) {
+                return table_.erase_by_key(x);
+            }
+            iterator     erase(const_iterator first, const_iterator last) {
+                return table_.erase(first, last);
+            }
+
+            void         swap(self_type& other) {
+                table_.swap(other.table_);
+            }
+
+            // [[検索系関数]]
+
+            size_type       count(const key_type& x) const {
+                return table_.count(x);
+            }
+
+            const_iterator  find(const key_type& x) const {
+                return table_.find(x);
+            }
+
+            pair<const_iterator, const_iterator>    equal_range(const key_type& x) const {
+                return table_.equal_range(x);
+            }
+
+            // [[バケット]]
+
+            size_type       bucket_count() const { return table_.bucket_count(); }
+            float           load_factor() const { return table_.load_factor(); }
+            float           max_load_factor() const { return table_.max_load_factor(); }
+            // 0.95 より大きい値は 0.95 に切り詰める。
+            void            max_load_factor(float ml) { table_.max_load_factor(ml); }
+            void            rehash(size_type count) { table_.rehash(count); }
+            void            reserve(size_type count) { table_.reserve(count); }
+
+            // [[観察者]]
+
+            hasher          hash_function() const { return table_.hash_function(); }
+            key_equal       key_eq() const { return table_.key_eq(); }
+
+            // 古いテーブルからの移し替えの途中か(テスト用)
+            bool            rehashing() const {
+                return table_.rehashing();
+            }
+
+            // 内部構造が正しいか(テスト用)
+            bool            debug_valid() const {
+                return table_.debug_valid();
+            }
+    };
+
+    // [比較演算子]
+    // 順序によらず, 同じキーの集合なら等しい。
+
+    template <class Key, class Hasher, class KeyEqual, class KeyAllocator>
+    inline bool operator==(
+        const ft::unordered_set<Key, Hasher, KeyEqual, KeyAllocator>& lhs,
+        const ft::unordered_set<Key, Hasher, KeyEqual, KeyAllocator>& rhs
+    ) {
+        typedef typename ft::unordered_set<Key, Hasher, KeyEqual, KeyAllocator>::const_iterator
+            const_iterator;
+        if (lhs.size() != rhs.size()) { return false; }
+        for (const_iterator it = lhs.begin(); it != lhs.end(); ++it) {
+            if (rhs.find(*it) == rhs.end()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class Key, class Hasher, class KeyEqual, class KeyAllocator>
+    inline bool operator!=(
+        const ft::unordered_set<Key, Hasher, KeyEqual, KeyAllocator>& lhs,
+        const ft::unordered_set<Key, Hasher, KeyEqual, KeyAllocator>& rhs
+    ) {
+        return !(lhs == rhs);
+    }
+}
+
+namespace std {
+    template <class Key, class Hasher, class KeyEqual, class KeyAllocator>
+    inline void swap(
+        ft::unordered_set<Key, Hasher, KeyEqual, KeyAllocator>& lhs,
+        ft::unordered_set<Key, Hasher, KeyEqual, KeyAllocator>& rhs
+    ) {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
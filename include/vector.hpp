@@ -6,11 +6,70 @@
 # include "ft_algorithm.hpp"
 # include "ft_iterator.hpp"
 # include "iterator_wrapper.hpp"
+# include "ft_memory.hpp"
+# include "vector_growth.hpp"
+# include <functional>
 
 namespace ft {
 
-    template<class T, class Allocator = std::allocator<T> >
-    class vector {
+    // 要素ごと realloc / mremap で領域を伸ばしてよいか。
+    // 要素が trivially relocatable で, かつアロケータの代わりに relocatable_storage から確保してよいとき
+    // (std::allocator, mmap_allocator。ft_memory.hpp の relocatable_storage_for)。
+    template <class T, class Allocator>
+    struct is_vector_storage_relocatable : integral_constant<bool,
+        is_trivially_relocatable<T>::value && relocatable_storage_for<Allocator>::value
+    > {};
+
+    // 要素を memset / memcpy でまとめて埋めてよいか。
+    // 要素が算術型かポインタで, かつアロケータが std::allocator (construct がただのコピー)のとき。
+    template <class T, class Allocator>
+    struct is_vector_fill_trivial : integral_constant<bool,
+        is_pseudo_trivially_constructible<T>::value && is_same<Allocator, std::allocator<T> >::value
+    > {};
+
+    // [vector_inline_buffer]
+    // vector の中に置く, 要素 N 個分の(構築されていない)領域。small_vector が使う。
+    // N == 0 のときは空のクラスなので, 普通の vector の大きさは変わらない。
+    // コピー・代入しても中身はコピーしない(要素の扱いは vector がやる)。
+    template <class T, std::size_t N>
+    class vector_inline_buffer {
+        public:
+            vector_inline_buffer() {}
+            vector_inline_buffer(const vector_inline_buffer&) {}
+            vector_inline_buffer&   operator=(const vector_inline_buffer&) { return *this; }
+
+            T*  inline_buffer_() {
+                return reinterpret_cast<T*>(buffer_.bytes);
+            }
+
+        FT_PRIVATE:
+            // 他のメンバは T のアラインメントを揃えるためのもの
+            union {
+                char        bytes[N * sizeof(T)];
+                long double ld;
+                double      d;
+                long        l;
+                void*       p;
+            }   buffer_;
+    };
+    template <class T>
+    class vector_inline_buffer<T, 0> {
+        public:
+            T*  inline_buffer_() {
+                return NULL;
+            }
+    };
+
+    // GrowthPolicy: 容量が足りなくなったときの伸ばし方(vector_growth.hpp)
+    // InlineCapacity: オブジェクトの中に持つ領域の要素数(small_vector.hpp)。
+    //   0 でなければ, 要素がその数を超えるまではヒープを使わない。
+    template<
+        class T,
+        class Allocator = std::allocator<T>,
+        class GrowthPolicy = ft::vector_growth_double,
+        std::size_t InlineCapacity = 0
+    >
+    class vector : private ft::vector_inline_buffer<T, InlineCapacity> {
         public:
 
             typedef T                                               value_type;
@@ -26,8 +85,11 @@ namespace ft {
 
             typedef typename ft::reverse_iterator<iterator>         reverse_iterator;
             typedef typename ft::reverse_iterator<const_iterator>   const_reverse_iterator;
+            typedef GrowthPolicy                                    growth_policy_type;
 
         FT_PRIVATE:
+            typedef typename ft::relocatable_storage_for<allocator_type>::type  relocatable_storage_type;
+
             size_type       capacity_;
             size_type       size_;
             allocator_type  allocator_;
@@ -37,14 +99,14 @@ namespace ft {
             // [コンストラクタ]
             // デフォルト
             vector()
-                : capacity_(0), size_(0), allocator_(allocator_type()), storage_(NULL) {}
+                : capacity_(InlineCapacity), size_(0), allocator_(allocator_type()), storage_(inline_storage_()) {}
             // アロケータ指定
             explicit vector(const allocator_type& alloc)
-                : capacity_(0), size_(0), allocator_(alloc), storage_(NULL) {}
+                : capacity_(InlineCapacity), size_(0), allocator_(alloc), storage_(inline_storage_()) {}
 
             // 要素数
             explicit vector(size_type count)
-                : capacity_(0), size_(0), allocator_(allocator_type()), storage_(NULL) {
+                : capacity_(InlineCapacity), size_(0), allocator_(allocator_type()), storage_(inline_storage_()) {
                 resize(count);
             }
 
@@ -53,7 +115,7 @@ namespace ft {
                 size_type count,
                 const_reference value,
                 const allocator_type& alloc = allocator_type()
-            ): capacity_(0), size_(0), allocator_(alloc), storage_(NULL) {
+            ): capacity_(InlineCapacity), size_(0), allocator_(alloc), storage_(inline_storage_()) {
                 resize(count, value);
             }
 
@@ -63,28 +125,64 @@ namespace ft {
                 InputIt first, InputIt last,
                 const allocator_type& alloc = allocator_type(),
                 typename ft::disable_if< ft::is_integral<InputIt>::value >::type* = NULL
-            ): capacity_(0), size_(0), allocator_(alloc), storage_(NULL) {
+            ): capacity_(InlineCapacity), size_(0), allocator_(alloc), storage_(inline_storage_()) {
                 // InputIt のイテレータタグの識別はinsertがやる
                 // 第４引数はdisable_ifのためのものなので、ノータッチ
                 insert(end(), first, last);
             }
             // コピーコンストラクタ
+            // (内部の領域は other から引き継がないので, 基底クラスは新しく構築する)
             vector(const vector& other)
-                : capacity_(0), size_(0), allocator_(other.allocator_), storage_(NULL) {
+                : ft::vector_inline_buffer<T, InlineCapacity>(),
+                  capacity_(InlineCapacity), size_(0), allocator_(other.allocator_), storage_(inline_storage_()) {
                 *this = other;
             }
 
+# ifdef FT_CXX11
+            // ムーブコンストラクタ
+            // other の領域をそのまま引き取る。other は空になる。
+            // other が内部の領域を使っているときは, 要素を1つずつムーブする。
+            vector(vector&& other)
+                noexcept(InlineCapacity == 0 || std::is_nothrow_move_constructible<T>::value)
+                : ft::vector_inline_buffer<T, InlineCapacity>(),
+                  capacity_(other.capacity_), size_(other.size_),
+                  allocator_(other.allocator_), storage_(other.storage_) {
+                if (other.is_inline_()) {
+                    capacity_ = InlineCapacity;
+                    size_ = 0;
+                    storage_ = inline_storage_();
+                    relocate_within_capacity_(other.begin(), other.end());
+                    other.clear();
+                    return;
+                }
+                other.capacity_ = InlineCapacity;
+                other.size_ = 0;
+                other.storage_ = other.inline_storage_();
+            }
+# endif
+
             // [デストラクタ]
             ~vector() {
-                obliterate_<ft::is_pseudo_trivially_destructible<value_type>::value>();
+                obliterate_<ft::is_trivially_destructible<value_type>::value>();
             }
 
             // [代入]
-            vector<T, Allocator>& operator=(const vector<T, Allocator> &rhs) {
+            // 容量が足りていれば, 今の領域に直接コピーする(新しい領域は確保しない)。
+            vector& operator=(const vector &rhs) {
                 if (this == &rhs) { return *this; }
                 this->assign(rhs.begin(), rhs.end());
                 return *this;
             }
+# ifdef FT_CXX11
+            // ムーブ代入
+            // rhs の領域を引き取り, this の元の要素は破棄する。rhs は空になる。
+            vector& operator=(vector&& rhs) noexcept {
+                if (this == &rhs) { return *this; }
+                vector    moved(std::move(rhs));
+                swap(moved);
+                return *this;
+            }
+# endif
 
             // [begin]
             // コンテナの最初の要素を指すイテレータを返します。
@@ -110,14 +208,14 @@ namespace ft {
             // 逆順の vector の最初の要素を指す逆イテレータを返します。 これは非逆順の vector の最後の要素に対応します。
             // vector が空の場合、返されるイテレータは rend() と等しくなります。 
             reverse_iterator        rbegin() { return reverse_iterator(end()); }
-            const_reverse_iterator  rbegin() const { return reverse_iterator(end()); }
+            const_reverse_iterator  rbegin() const { return const_reverse_iterator(end()); }
 
             // [rend]
             // 逆順の vector の最後の要素の次の要素を指す逆イテレータを返します。
             // これは非逆順の vector の最初の要素の前の要素に対応します。
             // この要素はプレースホルダとして振る舞い、アクセスを試みると未定義動作になります。
             reverse_iterator        rend() { return reverse_iterator(begin()); }
-            const_reverse_iterator  rend() const { return reverse_iterator(begin()); }
+            const_reverse_iterator  rend() const { return const_reverse_iterator(begin()); }
 
             // [size]
             // コンテナ内の要素の数、すなわち std::distance(begin(), end()) を返します。 
@@ -150,7 +248,7 @@ namespace ft {
                     // If n is less than or equal to the size of the container,
                     // the function never throws exceptions (no-throw guarantee).
                     destroy_from_<
-                        ft::is_pseudo_trivially_destructible<value_type>::value
+                        ft::is_trivially_destructible<value_type>::value
                     >(iterator(storage_ + count), end());
                     size_ = count;
                 } else if (current_size < count) {
@@ -165,7 +263,7 @@ namespace ft {
                     // If n is less than or equal to the size of the container,
                     // the function never throws exceptions (no-throw guarantee).
                     destroy_from_<
-                        ft::is_pseudo_trivially_destructible<value_type>::value
+                        ft::is_trivially_destructible<value_type>::value
                     >(iterator(storage_ + count), end());
                     size_ = count;
                 } else if (current_size < count) {
@@ -182,15 +280,30 @@ namespace ft {
                     } else {
                         // 再確保が必要
                         // -> Copyableなら強い保証、そうでないなら基本保証
-                        vector<value_type, allocator_type> cloned(allocator_);
-                        cloned.reserve(recommended_capacity_(count));
-                        cloned.insert(cloned.end(), begin(), end());
-                        cloned.insert(cloned.end(), count - cloned.size(), value);
-                        swap(cloned);
+                        realloc_append_(recommended_capacity_(count), count - current_size, value);
                     }
                 }
             }
 
+            // [resize_uninitialized]
+            // resize(count) と同じだが, 増えた要素を初期化しない(値は不定)。
+            // read() やデコーダでこれから上書きする領域を用意するためのもの。
+            // 巨大な領域でも初期化のためにメモリ全体をなめずに済む
+            // (mmap で確保された領域なら, 書き込むまでページも割り当てられない)。
+            // 要素の型がトリビアルにデフォルト構築できるときだけ使える。
+            void resize_uninitialized(size_type count) {
+                typedef char    value_type_must_be_trivially_default_constructible[
+                    ft::is_trivially_default_constructible<value_type>::value ? 1 : -1
+                ];
+                (void)sizeof(value_type_must_be_trivially_default_constructible);
+                if (count <= size_) {
+                    truncate_(count);
+                    return;
+                }
+                reserve(recommended_capacity_(count));
+                size_ = count;
+            }
+
             // [capacity]
             // コンテナが現在確保している空間に格納できる要素の数を返します。 
             size_type    capacity() const {
@@ -220,17 +333,15 @@ namespace ft {
                 if (max_size() < new_cap) {
                     throw std::length_error("allocator<T>::allocate(size_t n) 'n' exceeds maximum supported size");
                 }
-                if (!storage_) {
-                    // ストレージがない場合の確保
-                    // size_ == 0 のはず。
-                    storage_ = allocator_.allocate(new_cap);
-                    capacity_ = new_cap;
+                if (!storage_ || (is_inline_() && size_ == 0)) {
+                    // ストレージがない(または空の内部の領域しかない)場合の確保
+                    allocate_storage_<ft::is_vector_storage_relocatable<value_type, allocator_type>::value>(new_cap);
+                } else if (is_inline_()) {
+                    // 内部の領域からヒープに移る -> 要素を1つずつ移す
+                    reallocate_storage_<false>(new_cap);
                 } else {
                     // 再確保
-                    vector<value_type, allocator_type>  reserved(allocator_);
-                    reserved.reserve(new_cap);
-                    reserved.append_within_capacity_(begin(), end());
-                    swap(reserved);
+                    reallocate_storage_<ft::is_vector_storage_relocatable<value_type, allocator_type>::value>(new_cap);
                 }
             }
 
@@ -291,30 +402,74 @@ namespace ft {
             // [assign]
             // !! INVALIDATE all signifiers !!
             // ※コンテナの要素へのイテレータ、ポインタ、参照はすべて無効化されます。 終端イテレータも無効化されます。 
+            // 容量が足りていれば領域は確保し直さず, 既存の要素には代入し,
+            // 増える分だけ構築・減る分だけ破壊する。
             // (1) 内容を「valueのコピーcount個」に置き換える
             void    assign(size_type count, const_reference value) {
                 if (is_reallocation_needed_(count)) {
-                    vector<value_type, allocator_type>  new_one(count, value, allocator_);
-                    swap(new_one);
-                } else {
-                    clear();
-                    insert(begin(), count, value);
+                    vector  new_one(count, value, allocator_);
+                    take_storage_(new_one);
+                    return;
+                }
+                if (is_own_element_(value)) {
+                    // 代入・破壊で value が変わってしまわないように, 先にコピーしておく
+                    value_type  copied(value);
+                    assign(count, copied);
+                    return;
                 }
+                const size_type i = count < size_ ? count : size_;
+                assign_fill_<ft::is_vector_fill_trivial<value_type, allocator_type>::value>(storage_, i, value);
+                truncate_(i);
+                construct_fill_<ft::is_vector_fill_trivial<value_type, allocator_type>::value>(storage_ + size_, count - size_, value);
+                size_ = count;
             }
             // (2) 内容をレンジイテレータが指すものに置き換える
             // first and/or lastがthis内を指している場合はundefined
-            // disable_if は (1) と誤認されないためのもの
+            // enable_if は (1) と誤認されないためのもの
+            // 入力イテレータ: 個数がわからないので, 既存の要素に代入しながら読み, 余ったら末尾に追加する。
             template< class InputIt >
             void    assign(
                 InputIt first, InputIt last,
-                typename ft::disable_if< ft::is_integral<InputIt>::value >::type* = NULL
+                typename ft::enable_if<
+                    !ft::is_integral<InputIt>::value
+                    &&
+                    ft::is_input_iterator<InputIt>::value
+                    &&
+                    !ft::is_forward_iterator<InputIt>::value
+                >::type* = NULL
             ) {
-                vector<value_type, allocator_type>  new_one(first, last, allocator_);
-                if (is_reallocation_needed_(new_one.size())) {
-                    swap(new_one);
-                } else {
-                    clear();
-                    insert(begin(), new_one.begin(), new_one.end());
+                size_type   i = 0;
+                for (; i < size_ && first != last; ++i, ++first) {
+                    storage_[i] = *first;
+                }
+                truncate_(i);
+                for (; first != last; ++first) {
+                    push_back(*first);
+                }
+            }
+            // 前方向イテレータ: std::distance で個数を数えてから代入・構築する。
+            template< class ForwardIt >
+            void    assign(
+                ForwardIt first, ForwardIt last,
+                typename ft::enable_if<
+                    !ft::is_integral<ForwardIt>::value
+                    &&
+                    ft::is_forward_iterator<ForwardIt>::value
+                >::type* = NULL
+            ) {
+                size_type   count = std::distance(first, last);
+                if (is_reallocation_needed_(count)) {
+                    vector  new_one(first, last, allocator_);
+                    take_storage_(new_one);
+                    return;
+                }
+                size_type   i = 0;
+                for (; i < count && i < size_; ++i, ++first) {
+                    storage_[i] = *first;
+                }
+                truncate_(i);
+                for (; first != last; ++first) {
+                    push_back_within_capacity_(*first);
                 }
             }
 
@@ -330,20 +485,72 @@ namespace ft {
                 size_type   rec_cap = recommended_capacity_(size_ + 1);
                 if (rec_cap > capacity()) {
                     // 再確保発生
-                    // コピーしてpush_backしてswap
+                    // 新しい領域に value をコピーしてから既存の要素を移してswap
                     // 1回あたりO(size)かかるが、size回pushしてlog2(size)回しか起こらないので、
                     // 全体としては定数くらいになってくれるはず。
-                    vector<value_type, allocator_type> cloned(allocator_);
-                    cloned.reserve(rec_cap);
-                    cloned.append_within_capacity_(begin(), end());
-                    cloned.push_back_within_capacity_(value);
-                    swap(cloned);
+                    realloc_append_(rec_cap, 1, value);
                 } else {
                     // 再確保不要
                     push_back_within_capacity_(value);
                 }
             }
 
+# ifdef FT_CXX11
+            // (2) value をムーブして追加します。
+            void push_back(value_type&& value) {
+                emplace_back(std::move(value));
+            }
+
+            // [emplace_back]
+            // args から構築した要素を終端に追加します。
+            // 再確保する場合は, 新しい要素を先に構築してから既存の要素を移すので,
+            // args が既存の要素を指していてもよい。
+            // <例外安全性: STRONG> (要素のムーブが例外を投げうる場合はコピーで移すので)
+            template <class... Args>
+            void emplace_back(Args&&... args) {
+                if (size_ < capacity_) {
+                    allocator_.construct(&storage_[size_], std::forward<Args>(args)...);
+                    size_ += 1;
+                    return;
+                }
+                if (ft::is_vector_storage_relocatable<value_type, allocator_type>::value) {
+                    // 領域ごと伸ばすので, args が既存の要素を指していてもいいように先に構築しておく。
+                    value_type  value(std::forward<Args>(args)...);
+                    reserve(recommended_capacity_(size_ + 1));
+                    allocator_.construct(&storage_[size_], std::move(value));
+                    size_ += 1;
+                    return;
+                }
+                vector cloned(allocator_);
+                cloned.reserve(recommended_capacity_(size_ + 1));
+                cloned.allocator_.construct(&cloned.storage_[size_], std::forward<Args>(args)...);
+                try {
+                    cloned.relocate_within_capacity_(begin(), end());
+                } catch (...) {
+                    cloned.allocator_.destroy(&cloned.storage_[size_]);
+                    throw;
+                }
+                cloned.size_ += 1;
+                take_storage_(cloned);
+            }
+
+            // [emplace]
+            // pos の直前に, args から構築した要素を挿入します。
+            // returns: 挿入された要素を指すイテレータ。
+            template <class... Args>
+            iterator    emplace(const_iterator pos, Args&&... args) {
+                size_type   n = distance_(begin(), pos);
+                if (n == size_) {
+                    emplace_back(std::forward<Args>(args)...);
+                } else {
+                    // 既存の要素をずらす前に構築する(args が既存の要素を指していてもよいように)
+                    value_type  value(std::forward<Args>(args)...);
+                    insert(begin() + n, std::move(value));
+                }
+                return begin() + n;
+            }
+# endif
+
             // [pop_back]
             // コンテナの最後の要素を削除します。
             // 空のコンテナに対する pop_back の呼び出しは未定義です。
@@ -365,38 +572,65 @@ namespace ft {
                 insert(pos, 1, value);
                 return begin() + n;
             }
+# ifdef FT_CXX11
+            // pos の前に value をムーブして挿入します。
+            // returns: 挿入された value を指すイテレータ。
+            iterator    insert(iterator pos, value_type&& value) {
+                size_type   n = distance_(begin(), pos);
+                if (n == size_) {
+                    emplace_back(std::move(value));
+                } else if (size_ < capacity_) {
+                    mass_moveright_within_capacity_(pos, 1);
+                    storage_[n] = std::move(value);
+                } else {
+                    vector new_one(allocator_);
+                    new_one.reserve(recommended_capacity_(size_ + 1));
+                    new_one.relocate_within_capacity_(begin(), pos);
+                    new_one.allocator_.construct(&new_one.storage_[n], std::move(value));
+                    new_one.size_ += 1;
+                    new_one.relocate_within_capacity_(pos, end());
+                    take_storage_(new_one);
+                }
+                return begin() + n;
+            }
+# endif
             // os の前に value のコピーを count 個挿入します。
             void        insert(iterator pos, size_type count, const value_type& value) {
+                // value がこの vector の要素だと, ずらす・移すときに上書き(ムーブ)されてしまうので,
+                // 先にコピーしておく。
+                if (count > 0 && is_own_element_(value)) {
+                    value_type  copied(value);
+                    insert(pos, count, copied);
+                    return;
+                }
                 size_type   recommended_cap = recommended_capacity_(size() + count);
                 bool        needed_realloc = recommended_cap > capacity();
                 bool        do_append = pos == end();
                 if (!needed_realloc) {
                     if (do_append) {
                         // 再確保不要 & 末尾に追加
-                        for (size_type i = 0; i < count; ++i) {
-                            push_back_within_capacity_(value);
-                        }
+                        construct_fill_<ft::is_vector_fill_trivial<value_type, allocator_type>::value>(storage_ + size_, count, value);
+                        size_ += count;
                     } else {
                         // 再確保不要 & 末尾でない
                         size_type   p = distance_(begin(), pos);
                         size_type   old_size = size();
                         // 既存要素の移動
                         mass_moveright_within_capacity_(pos, count);
-                        // 新規要素の代入
-                        for (size_type i = 0; i < count; ++i) {
-                            substitute_to_(i + p, value, old_size);
-                        }
+                        // 新規要素の代入(もとの末尾より前は代入, 以降はコピー構築)
+                        size_type   border = p + count < old_size ? p + count : old_size;
+                        assign_fill_<ft::is_vector_fill_trivial<value_type, allocator_type>::value>(storage_ + p, border - p, value);
+                        construct_fill_<ft::is_vector_fill_trivial<value_type, allocator_type>::value>(storage_ + border, p + count - border, value);
                     }
                 } else {
                     // 再確保が必要
-                    vector<value_type, allocator_type> new_one(allocator_);
+                    vector new_one(allocator_);
                     new_one.reserve(recommended_cap);
-                    new_one.append_within_capacity_(begin(), pos);
-                    for (size_type i = 0; i < count; ++i) {
-                        new_one.push_back_within_capacity_(value);
-                    }
-                    new_one.append_within_capacity_(pos, end());
-                    swap(new_one);
+                    new_one.relocate_within_capacity_(begin(), pos);
+                    new_one.construct_fill_<ft::is_vector_fill_trivial<value_type, allocator_type>::value>(new_one.storage_ + new_one.size_, count, value);
+                    new_one.size_ += count;
+                    new_one.relocate_within_capacity_(pos, end());
+                    take_storage_(new_one);
                 }
             }
             // pos の前に範囲 [first, last) から要素を挿入します。 
@@ -413,7 +647,7 @@ namespace ft {
                 >::type* = NULL
             ) {
                 // サイズを知るために一旦新しいvectorで受ける
-                vector<value_type, allocator_type>  receiver(allocator_);
+                vector  receiver(allocator_);
                 for (; first != last; ++first) {
                     receiver.push_back(*first);
                 }
@@ -459,14 +693,14 @@ namespace ft {
                     }
                 } else {
                     // 再確保が必要
-                    vector<value_type, allocator_type> new_one(allocator_);
+                    vector new_one(allocator_);
                     new_one.reserve(recommended_cap);
-                    new_one.append_within_capacity_(begin(), pos);
+                    new_one.relocate_within_capacity_(begin(), pos);
                     for (size_type i = 0; i < count; ++i, ++first) {
                         new_one.push_back_within_capacity_(*first);
                     }
-                    new_one.append_within_capacity_(pos, end());
-                    swap(new_one);
+                    new_one.relocate_within_capacity_(pos, end());
+                    take_storage_(new_one);
                 }
             }
 
@@ -501,7 +735,13 @@ namespace ft {
             // [swap]
             // コンテナの内容を other の内容と交換します。 個々の要素に対するいかなるムーブ、コピー、swap 操作も発生しません。
             // すべてのイテレータおよび参照は有効なまま残されます。 終端イテレータは無効化されます。
+            // ただし内部の領域(InlineCapacity)を使っている側があるときは, その要素は1つずつ移され,
+            // その要素を指すイテレータ・参照は無効化される。
             void swap( vector& other ) {
+                if (is_inline_() || other.is_inline_()) {
+                    swap_inline_(other);
+                    return;
+                }
                 // allocator_ 以外はプリミティブ型なので、最初にallocator_をスワップする。
                 // -> 少なくともSTRONG, 多分no-throw
                 ft::swap(allocator_, other.allocator_);
@@ -526,6 +766,81 @@ namespace ft {
 
         FT_PRIVATE:
 
+            // [内部の領域]
+            // InlineCapacity == 0 なら NULL
+            pointer inline_storage_() {
+                return this->inline_buffer_();
+            }
+
+            // 今, 内部の領域を使っているかどうか
+            bool    is_inline_() const {
+                return InlineCapacity > 0
+                    && storage_ == const_cast<vector*>(this)->inline_storage_();
+            }
+
+            // 少なくとも一方が内部の領域を使っているときの swap
+            // 内部の領域にある要素は, 相手の内部の領域に移す(領域の大きさは同じ)。
+            void    swap_inline_(vector& other) {
+                if (is_inline_() && other.is_inline_()) {
+                    // 両方とも内部: 共通の長さの分は要素ごとに swap し, 残りは短い方に移す
+                    vector&     longer = size_ < other.size_ ? other : *this;
+                    vector&     shorter = size_ < other.size_ ? *this : other;
+                    size_type   i = 0;
+                    for (; i < shorter.size_; ++i) {
+                        ft::swap(storage_[i], other.storage_[i]);
+                    }
+                    const size_type common = shorter.size_;
+                    for (; i < longer.size_; ++i) {
+                        shorter.allocator_.construct(&shorter.storage_[i], FT_MOVE_IF_NOEXCEPT(longer.storage_[i]));
+                        shorter.size_ += 1;
+                    }
+                    longer.truncate_(common);
+                    ft::swap(allocator_, other.allocator_);
+                    return;
+                }
+                vector&     inl = is_inline_() ? *this : other;
+                vector&     heap = is_inline_() ? other : *this;
+                pointer     dest = heap.inline_storage_();
+                size_type   i = 0;
+                try {
+                    for (; i < inl.size_; ++i) {
+                        heap.allocator_.construct(&dest[i], FT_MOVE_IF_NOEXCEPT(inl.storage_[i]));
+                    }
+                } catch (...) {
+                    for (; i > 0; --i) {
+                        heap.allocator_.destroy(&dest[i - 1]);
+                    }
+                    throw;
+                }
+                const size_type inl_size = inl.size_;
+                inl.truncate_(0);
+                inl.storage_ = heap.storage_;
+                inl.size_ = heap.size_;
+                inl.capacity_ = heap.capacity_;
+                heap.storage_ = dest;
+                heap.size_ = inl_size;
+                heap.capacity_ = InlineCapacity;
+                ft::swap(allocator_, other.allocator_);
+            }
+
+            // 再確保の仕上げ: other (新しい領域に要素を移し終えたもの)の領域を引き取る。
+            // this の元の要素と領域は other と一緒に捨てられる。
+            // 内部の領域を使っているときは, swap すると要素を other に移す手間がかかるので, ここで破壊する。
+            void    take_storage_(vector& other) {
+                if (!is_inline_()) {
+                    swap(other);
+                    return;
+                }
+                truncate_(0);
+                ft::swap(allocator_, other.allocator_);
+                storage_ = other.storage_;
+                size_ = other.size_;
+                capacity_ = other.capacity_;
+                other.storage_ = other.inline_storage_();
+                other.size_ = 0;
+                other.capacity_ = InlineCapacity;
+            }
+
             difference_type distance_(const_iterator from, const_iterator to) const {
                 // if (is_interval_empty_(from, to)) { return 0; }
                 // if (to == end()) {
@@ -535,34 +850,29 @@ namespace ft {
             }
 
             // サイズを「n以上に増やす」ために推奨されるcapacityの値を返す
+            // 足りないときは GrowthPolicy で新しい容量を決める(その容量に再確保するものとして数える)。
             size_type    recommended_capacity_(size_type n) const {
                 size_type    c = capacity();
                 if (n <= c) { return c; }
                 size_type    ms = max_size();
-                if (c == 0 && n == 1) {
-                    c = 1;
-                } else {
-                    if (c <= n / 2) {
-                        c = n;
-                        if (ms < c) {
-                            // もう拡張できない
-                            throw std::length_error("too long");
-                        }
-                    } else {
-                        if (ms / 2 <= c) {
-                            // もう拡張できない
-                            throw std::length_error("too long");
-                        }
-                        c *= 2;
-                    }
+                if (ms < n) {
+                    // もう拡張できない
+                    throw std::length_error("too long");
                 }
+                c = GrowthPolicy::next_capacity(c, n, sizeof(value_type));
+                if (c < n) {
+                    c = n;
+                } else if (ms < c) {
+                    c = ms;
+                }
+                ft::vector_growth_stats<GrowthPolicy>::record(n, c, sizeof(value_type));
                 return c;
             }
 
             // [Predicates]
             // サイズをnにしたい場合、再確保が必要かどうかを返す。
             bool is_reallocation_needed_(size_type n) const {
-                return recommended_capacity_(n) > capacity();
+                return n > capacity();
             }
 
             // 区間 [from, to) が空かどうかを返す
@@ -582,6 +892,66 @@ namespace ft {
                 size_ = i;
             }
 
+            // 再確保で, 古い領域の [from, to) の要素を新しい領域(this)の末尾に移す。
+            // capacityは十分にあるものとする。
+            // C++11 モードでは, ムーブが例外を投げないならムーブする。
+            // 投げうるならコピーするので, 途中で失敗しても古い領域の要素は元のまま(強い保証)。
+            // 1つ構築するごとにサイズを増やすので, 失敗しても構築済みのものは this が破壊する。
+            void relocate_within_capacity_(iterator from, iterator to) {
+                for (iterator it = from; it != to; ++it) {
+                    allocator_.construct(&storage_[size_], FT_MOVE_IF_NOEXCEPT(*it));
+                    size_ += 1;
+                }
+            }
+
+            // 容量 new_cap の領域を確保し, [size, size + n) に value のコピーを構築してから,
+            // 既存の要素を移してswapする。
+            // 新しい要素を先に構築するので, value が既存の要素を指していてもよい。
+            // <例外安全性: STRONG>
+            void realloc_append_(size_type new_cap, size_type n, const value_type& value) {
+                if (ft::is_vector_storage_relocatable<value_type, allocator_type>::value) {
+                    // 領域ごと伸ばすので, 既存の要素は動かさなくてよい。
+                    // ただし value が既存の要素だと一緒に動いてしまうので, 先にコピーしておく。
+                    if (is_own_element_(value)) {
+                        value_type  copied(value);
+                        realloc_append_(new_cap, n, copied);
+                        return;
+                    }
+                    reserve(new_cap);
+                    construct_fill_<ft::is_vector_fill_trivial<value_type, allocator_type>::value>(storage_ + size_, n, value);
+                    size_ += n;
+                    return;
+                }
+                vector cloned(allocator_);
+                cloned.reserve(new_cap);
+                cloned.construct_fill_<ft::is_vector_fill_trivial<value_type, allocator_type>::value>(cloned.storage_ + size_, n, value);
+                try {
+                    cloned.relocate_within_capacity_(begin(), end());
+                } catch (...) {
+                    for (size_type i = n; i > 0; --i) {
+                        cloned.allocator_.destroy(&cloned.storage_[size_ + i - 1]);
+                    }
+                    throw;
+                }
+                cloned.size_ += n;
+                take_storage_(cloned);
+            }
+
+            // value がこの vector の要素かどうか
+            bool is_own_element_(const value_type& value) const {
+                std::less<const value_type*>    less;
+                return !less(&value, storage_) && less(&value, storage_ + size_);
+            }
+
+            // サイズを n 以下に縮める(末尾の要素を破壊する)。n が今のサイズ以上なら何もしない。
+            void    truncate_(size_type n) {
+                if (n >= size_) { return; }
+                destroy_from_<
+                    ft::is_trivially_destructible<value_type>::value
+                >(iterator(storage_ + n), end());
+                size_ = n;
+            }
+
             // 再確保不要な前提でpush_backを行う。
             void    push_back_within_capacity_(const_reference value) {
                 // ASSERTION: capacity() >= size() + 1
@@ -633,9 +1003,9 @@ namespace ft {
                     if (pos_from_head + move_distance <= old_size) {
                         border_used = old_size - move_distance;
                     }
-                    // 未使用領域へのコピー -> コピー構築を行う
+                    // 未使用領域へのコピー -> コピー構築を行う(C++11 モードではムーブ構築)
                     for (size_type i = border_used; i < old_size; ++i) {
-                        allocator_.construct(&storage_[i + move_distance], storage_[i]);
+                        allocator_.construct(&storage_[i + move_distance], FT_MOVE(storage_[i]));
                     }
                     // 使用済み領域へのコピー -> 代入
                     // std::copy_backward(pos, begin() + border_used, begin() + border_used + d);
@@ -663,7 +1033,7 @@ namespace ft {
             ) {
                 std::memmove(dest, src, n * sizeof(value_type));
             }
-            // trivialにコピー代入できないとき
+            // trivialにコピー代入できないとき(C++11 モードではムーブ代入)
             template <>
             void    copy_forward__<false>(
                 value_type* dest,
@@ -671,7 +1041,7 @@ namespace ft {
                 size_type n
             ) {
                 for (size_type i = 0; i < n; ++i) {
-                    *(dest + i) = *(src + i);
+                    *(dest + i) = FT_MOVE(*(src + i));
                 }
             }
 
@@ -696,9 +1066,47 @@ namespace ft {
                 size_type n
             ) {
                 for (size_type i = n; 0 < i--;) {
-                    *(dest + i) = *(src + i);
+                    *(dest + i) = FT_MOVE(*(src + i));
+                }
+            }
+
+            // [dest, dest + n) に value のコピーを構築する。
+            // 途中で例外が投げられたら, 構築した分を破壊してから投げ直す(サイズは変えない)。
+            template <bool B>
+            void    construct_fill_(pointer dest, size_type n, const value_type& value);
+            template <>
+            void    construct_fill_<false>(pointer dest, size_type n, const value_type& value) {
+                size_type   i = 0;
+                try {
+                    for (; i < n; ++i) {
+                        allocator_.construct(&dest[i], value);
+                    }
+                } catch (...) {
+                    for (; i > 0; --i) {
+                        allocator_.destroy(&dest[i - 1]);
+                    }
+                    throw;
+                }
+            }
+            // 算術型 -> memset / memcpy でまとめて埋める
+            template <>
+            void    construct_fill_<true>(pointer dest, size_type n, const value_type& value) {
+                ft::fill_n_trivial_(dest, n, value);
+            }
+
+            // 構築済みの [dest, dest + n) に value を代入する。
+            template <bool B>
+            void    assign_fill_(pointer dest, size_type n, const value_type& value);
+            template <>
+            void    assign_fill_<false>(pointer dest, size_type n, const value_type& value) {
+                for (size_type i = 0; i < n; ++i) {
+                    dest[i] = value;
                 }
             }
+            template <>
+            void    assign_fill_<true>(pointer dest, size_type n, const value_type& value) {
+                ft::fill_n_trivial_(dest, n, value);
+            }
 
             // インデックス pos に value を入れる.
             // ただし、入れ方が異なる:
@@ -738,6 +1146,54 @@ namespace ft {
             template <>
             void    destroy_from_<true>(iterator, iterator) {}
 
+            // [記憶域の確保・解放]
+            // 領域ごと伸ばせる場合(B = true)は relocatable_storage から, そうでなければアロケータから確保する。
+            // 容量 n の領域を確保する(storage_ がない前提)
+            template <bool B>
+            void    allocate_storage_(size_type n);
+            template <>
+            void    allocate_storage_<false>(size_type n) {
+                storage_ = allocator_.allocate(n);
+                capacity_ = n;
+            }
+            template <>
+            void    allocate_storage_<true>(size_type n) {
+                storage_ = static_cast<pointer>(relocatable_storage_type::allocate(n * sizeof(value_type)));
+                capacity_ = n;
+            }
+
+            // 容量を n に増やす(storage_ がある前提)。
+            // <例外安全性: STRONG>
+            template <bool B>
+            void    reallocate_storage_(size_type n);
+            // 新しい領域を確保して要素を1つずつ移す
+            template <>
+            void    reallocate_storage_<false>(size_type n) {
+                vector  reserved(allocator_);
+                reserved.reserve(n);
+                reserved.relocate_within_capacity_(begin(), end());
+                take_storage_(reserved);
+            }
+            // 領域ごと realloc / mremap で伸ばす。要素のコピーもデストラクタも呼ばない。
+            template <>
+            void    reallocate_storage_<true>(size_type n) {
+                storage_ = static_cast<pointer>(relocatable_storage_type::reallocate(
+                    storage_, capacity_ * sizeof(value_type), n * sizeof(value_type)
+                ));
+                capacity_ = n;
+            }
+
+            template <bool B>
+            void    deallocate_storage_();
+            template <>
+            void    deallocate_storage_<false>() {
+                allocator_.deallocate(storage_, capacity_);
+            }
+            template <>
+            void    deallocate_storage_<true>() {
+                relocatable_storage_type::deallocate(storage_, capacity_ * sizeof(value_type));
+            }
+
             // 初期状態(storage_なし, capacity == size == 0)に戻す
             template <bool B>
             void    obliterate_();
@@ -746,7 +1202,8 @@ namespace ft {
             void    obliterate_<false>() {
                 if (storage_) {
                     clear();
-                    allocator_.deallocate(storage_, capacity());
+                    if (is_inline_()) { return; }
+                    deallocate_storage_<ft::is_vector_storage_relocatable<value_type, allocator_type>::value>();
                     // storage_ = NULL;
                     // size_ = 0;
                     // capacity_ = 0;
@@ -755,8 +1212,8 @@ namespace ft {
             // trivialに破壊できるとき
             template <>
             void    obliterate_<true>() {
-                if (storage_) {
-                    allocator_.deallocate(storage_, capacity());
+                if (storage_ && !is_inline_()) {
+                    deallocate_storage_<ft::is_vector_storage_relocatable<value_type, allocator_type>::value>();
                     // storage_ = NULL;
                     // size_ = 0;
                     // capacity_ = 0;
@@ -766,54 +1223,54 @@ namespace ft {
 
     // [比較演算子]
     // lhs と rhs の内容が等しいかどうか調べます。 つまり、それらが同じ個数の要素を持ち、 lhs 内のそれぞれの要素が rhs 内の同じ位置の要素と等しいかどうか比較します。
-    template< class T, class Alloc >
+    template< class T, class Alloc, class Growth, std::size_t N >
     inline bool operator==(
-        const ft::vector<T, Alloc>& lhs,
-        const ft::vector<T, Alloc>& rhs
+        const ft::vector<T, Alloc, Growth, N>& lhs,
+        const ft::vector<T, Alloc, Growth, N>& rhs
     ) {
-        return equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        return ft::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
-    template< class T, class Alloc >
+    template< class T, class Alloc, class Growth, std::size_t N >
     inline bool operator!=(
-        const ft::vector<T, Alloc>& lhs,
-        const ft::vector<T, Alloc>& rhs
+        const ft::vector<T, Alloc, Growth, N>& lhs,
+        const ft::vector<T, Alloc, Growth, N>& rhs
     ) {
         return !(lhs == rhs);
     }
 
     // lhs と rhs の内容を辞書的に比較します。 比較は std::lexicographical_compare と同等の関数によって行われます。 
     // lhs の内容が rhs の内容より辞書的に小さい場合は true、そうでなければ false。
-    template< class T, class Alloc >
+    template< class T, class Alloc, class Growth, std::size_t N >
     inline bool operator<(
-        const ft::vector<T, Alloc>& lhs,
-        const ft::vector<T, Alloc>& rhs
+        const ft::vector<T, Alloc, Growth, N>& lhs,
+        const ft::vector<T, Alloc, Growth, N>& rhs
     ) {
         // lhs の内容が rhs の内容より辞書的に小さいまたは等しい場合は true、そうでなければ false。
-        return lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
-    template< class T, class Alloc >
+    template< class T, class Alloc, class Growth, std::size_t N >
     inline bool operator<=(
-        const ft::vector<T, Alloc>& lhs,
-        const ft::vector<T, Alloc>& rhs
+        const ft::vector<T, Alloc, Growth, N>& lhs,
+        const ft::vector<T, Alloc, Growth, N>& rhs
     ) {
         return !(lhs > rhs);
     }
 
-    template< class T, class Alloc >
+    template< class T, class Alloc, class Growth, std::size_t N >
     inline bool operator>(
-        const ft::vector<T, Alloc>& lhs,
-        const ft::vector<T, Alloc>& rhs
+        const ft::vector<T, Alloc, Growth, N>& lhs,
+        const ft::vector<T, Alloc, Growth, N>& rhs
     ) {
         // lhs の内容が rhs の内容より辞書的に大きいまたは等しい場合は true、そうでなければ false。
         return rhs < lhs;
     }
 
-    template< class T, class Alloc >
+    template< class T, class Alloc, class Growth, std::size_t N >
     inline bool operator>=(
-        const ft::vector<T, Alloc>& lhs,
-        const ft::vector<T, Alloc>& rhs
+        const ft::vector<T, Alloc, Growth, N>& lhs,
+        const ft::vector<T, Alloc, Growth, N>& rhs
     ) {
         return !(lhs < rhs);
     }
@@ -922,6 +1379,11 @@ namespace ft {
         return x + n;
     }
 
+    // std::allocator の vector は, ポインタと大きさを持つだけなのでそのまま移せる。
+    // (内部の領域を持つものは, 自分の中を指すので移せない)
+    template <class T, class Growth>
+    struct is_trivially_relocatable< ft::vector<T, std::allocator<T>, Growth, 0> > : true_type {};
+
     // template <class T, class Alloc>
     // inline void swap( ft::vector<T, Alloc>& lhs, ft::vector<T, Alloc>& rhs ) {
     //     lhs.swap(rhs);
@@ -930,8 +1392,8 @@ namespace ft {
 
 // まあ一応ね
 namespace std {
-    template <class T, class Alloc>
-    inline void swap( ft::vector<T, Alloc>& lhs, ft::vector<T, Alloc>& rhs ) {
+    template <class T, class Alloc, class Growth, std::size_t N>
+    inline void swap( ft::vector<T, Alloc, Growth, N>& lhs, ft::vector<T, Alloc, Growth, N>& rhs ) {
         lhs.swap(rhs);
     }
 }
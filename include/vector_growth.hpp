@@ -0,0 +1,116 @@
+#ifndef VECTOR_GROWTH_HPP
+# define VECTOR_GROWTH_HPP
+
+# include <cstddef>
+
+// ft::vector の伸ばし方(成長方針)
+// ft::vector の3つ目のテンプレート引数に渡す。
+// 方針は次の静的メンバ関数を持つクラス:
+//   static std::size_t next_capacity(std::size_t capacity, std::size_t n, std::size_t elem_size);
+//   容量 capacity の vector に n 個(n > capacity)入れたいときの新しい容量を返す。
+//   elem_size は要素1つのバイト数。n 未満を返したときは n に, max_size() を超えたら max_size() に直される。
+
+namespace ft {
+
+    // [vector_growth_double]
+    // 2倍に伸ばす(デフォルト)。一度に2倍以上必要なときは, ちょうど n にする。
+    struct vector_growth_double {
+        static std::size_t  next_capacity(std::size_t capacity, std::size_t n, std::size_t) {
+            if (capacity == 0 && n == 1) { return 1; }
+            if (capacity <= n / 2) { return n; }
+            return capacity * 2;
+        }
+    };
+
+    // [vector_growth_one_and_half]
+    // 1.5倍に伸ばす。余る容量は最大で 1/3 になり, 2倍よりメモリの無駄が少ない。
+    // (再確保の回数は増える)
+    struct vector_growth_one_and_half {
+        static std::size_t  next_capacity(std::size_t capacity, std::size_t n, std::size_t) {
+            std::size_t c = capacity + capacity / 2;
+            return c < n ? n : c;
+        }
+    };
+
+    // [vector_growth_size_class]
+    // 伸ばした後の領域のバイト数を, アロケータやページの大きさの区切りに切り上げる。
+    // 切り上げた分はどうせ確保されてしまう(けど使われない)領域なので, 容量に含めてしまう。
+    // - ページより小さい: 2倍に伸ばし, 2の冪(malloc のサイズクラス)に切り上げる
+    // - ヒュージページより小さい: 2倍に伸ばし, ページ(4KiB)の倍数に切り上げる
+    // - それ以上: 1.5倍に伸ばし, ヒュージページ(2MiB)の倍数に切り上げる
+    //   (大きな領域を2倍にすると, 最大で半分が無駄になるため)
+    struct vector_growth_size_class {
+        static std::size_t  next_capacity(std::size_t capacity, std::size_t n, std::size_t elem_size) {
+            const std::size_t   page_size = 4096;
+            const std::size_t   huge_page_size = 2 * 1024 * 1024;
+            const std::size_t   max_bytes = std::size_t(-1);
+            if (elem_size == 0) { elem_size = 1; }
+            std::size_t c = capacity;
+            if (c > max_bytes / elem_size || c * elem_size < huge_page_size) {
+                c = c <= n / 2 ? n : c * 2;
+            } else {
+                c = c + c / 2;
+                if (c < n) { c = n; }
+            }
+            if (c > (max_bytes - huge_page_size) / elem_size) {
+                // 切り上げるとあふれる
+                return c;
+            }
+            std::size_t bytes = c * elem_size;
+            if (bytes < page_size) {
+                std::size_t rounded = 16;
+                while (rounded < bytes) { rounded *= 2; }
+                bytes = rounded;
+            } else if (bytes < huge_page_size) {
+                bytes = (bytes + page_size - 1) / page_size * page_size;
+            } else {
+                bytes = (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+            }
+            return bytes / elem_size;
+        }
+    };
+
+    // [vector_growth_stats]
+    // 再確保の回数と, 再確保で生まれた余りの容量(capacity - 必要な個数)のバイト数を数える。
+    // FT_VECTOR_GROWTH_STATS を定義したときだけ数える(スレッドセーフではないので)。
+    // 方針ごとに別々に数える。
+    template <class GrowthPolicy>
+    class vector_growth_stats {
+        public:
+            // 容量を増やした回数(最初の確保も含む)
+            static std::size_t& reallocations() {
+                static std::size_t  count = 0;
+                return count;
+            }
+            // 容量を増やしたときに確保したバイト数の合計
+            static std::size_t& reserved_bytes() {
+                static std::size_t  bytes = 0;
+                return bytes;
+            }
+            // そのうち, その時点で必要だった分を超える(無駄になりうる)バイト数の合計
+            static std::size_t& slack_bytes() {
+                static std::size_t  bytes = 0;
+                return bytes;
+            }
+
+            static void record(std::size_t n, std::size_t new_capacity, std::size_t elem_size) {
+# ifdef FT_VECTOR_GROWTH_STATS
+                reallocations() += 1;
+                reserved_bytes() += new_capacity * elem_size;
+                slack_bytes() += (new_capacity - n) * elem_size;
+# else
+                (void)n;
+                (void)new_capacity;
+                (void)elem_size;
+# endif
+            }
+
+            static void reset() {
+                reallocations() = 0;
+                reserved_bytes() = 0;
+                slack_bytes() = 0;
+            }
+    };
+}
+
+#endif
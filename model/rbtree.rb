@@ -712,6 +712,132 @@ class BinTree
 
     node.delete_self
   end
+
+  # 分割
+  # key 以上のキーを持つノードを新しい木に移して返す。
+  # self には key 未満のキーを持つノードが残る。
+  def split(key)
+    l, r = split_subtree(detach_root, key)
+    attach_root(l)
+    other = BinTree.new
+    other.attach_root(r)
+    other
+  end
+
+  # 連結
+  # other のノードをすべて self に移す。other は空になる。
+  # self と other のキーの範囲は重なってはいけない。
+  def join(other)
+    return if !other.root.is_normal_node
+    if !root.is_normal_node
+      attach_root(other.detach_root)
+      return
+    end
+    if root.max.key < other.root.min.key
+      # self < other
+      # -> other の最小ノードを抜き出して, 2つの木をつなぐノードにする
+      key = other.root.min.key
+      other.delete(key)
+      l = detach_root
+      r = other.detach_root
+    elsif other.root.max.key < root.min.key
+      # other < self
+      key = root.min.key
+      delete(key)
+      l = other.detach_root
+      r = detach_root
+    else
+      fail "key ranges overlap"
+    end
+    attach_root(join_subtrees(l, Node.new(key, nil, :R), r))
+  end
+
+  # ルートを切り離して返し, 木を空にする
+  def detach_root
+    top = root
+    top.parent = nil
+    @end.left = @end.spawn_nil
+    top
+  end
+
+  def attach_root(node)
+    @end.left = node
+    node.parent = @end
+  end
+
+  # 部分木 l, ノード mid, 部分木 r をこの順に並ぶ1つの赤黒木にまとめて, その根を返す。
+  # l, r は親から切り離されていて, 根が黒であること。
+  # 作業中は self の end ノードを借りるので, self は空であること。
+  def join_subtrees(l, mid, r)
+    hl = l.black_height
+    hr = r.black_height
+    mid.color = :R
+    if hl >= hr
+      # l の右端を下り, 黒高さが hr の黒ノード y を探す。
+      # y の位置に mid を置き, y と r をその子にする。
+      attach_root(l)
+      pa = @end
+      y = l
+      hy = hl
+      while y.is_normal_node && (hy > hr || y.color == :R)
+        hy -= 1 if y.color == :B
+        pa = y
+        y = y.right
+      end
+      if pa == @end
+        pa.left = mid
+      else
+        pa.right = mid
+      end
+      mid.parent = pa
+      mid.left = y
+      mid.right = r
+    else
+      # 左右反対
+      attach_root(r)
+      pa = @end
+      y = r
+      hy = hr
+      while y.is_normal_node && (hy > hl || y.color == :R)
+        hy -= 1 if y.color == :B
+        pa = y
+        y = y.left
+      end
+      pa.left = mid
+      mid.parent = pa
+      mid.left = l
+      mid.right = y
+    end
+    mid.left.parent = mid
+    mid.right.parent = mid
+    # mid は赤なので, 挿入と同じリバランスで赤が連続しないようにする
+    rebalance_red(mid)
+    detach_root
+  end
+
+  # 親から切り離された部分木 node (根は黒) を,
+  # key 未満の部分木と key 以上の部分木に分ける
+  def split_subtree(node, key)
+    if !node.is_normal_node
+      return [Node.new(nil, nil, :B, :nil), Node.new(nil, nil, :B, :nil)]
+    end
+    left = cut_subtree(node.left)
+    right = cut_subtree(node.right)
+    if node.key < key
+      rl, r = split_subtree(right, key)
+      [join_subtrees(left, node, rl), r]
+    else
+      l, lr = split_subtree(left, key)
+      [l, join_subtrees(lr, node, right)]
+    end
+  end
+
+  # 部分木の根を親から切り離し, 黒く塗る
+  def cut_subtree(node)
+    node.parent = nil
+    node.color = :B if node.is_normal_node
+    node
+  end
 end
 
 
@@ -995,5 +1121,42 @@ def test_delete
 end
 
 
+def test_split_join
+  100.times {
+    n = rand(0..300)
+    keys = (1..n).to_a.shuffle
+    tree = BinTree.new
+    keys.each{ |k| tree.add(k) }
+    all_constraint(tree)
+    k = rand(0..(n + 1))
+    upper = tree.split(k)
+    all_constraint(tree)
+    all_constraint(upper)
+    fail "split: lower" if keys_of(tree) != (1...k).to_a.select{ |x| x <= n }
+    fail "split: upper" if keys_of(upper) != (k..n).to_a.select{ |x| x >= 1 }
+    if rand(2) == 0
+      tree.join(upper)
+    else
+      upper.join(tree)
+      tree, upper = upper, tree
+    end
+    all_constraint(tree)
+    all_constraint(upper)
+    fail "join" if keys_of(tree) != (1..n).to_a || keys_of(upper) != []
+  }
+  puts "split/join ok"
+end
+
+def keys_of(tree)
+  tit = tree.it_begin
+  arr = []
+  while tit.node != tree.it_end.node do
+    arr << tit.node.key
+    tit = tit.next
+  end
+  arr
+end
+
 #test_add
+test_split_join
 test_delete
@@ -0,0 +1,81 @@
+#ifndef COUNTING_ALLOCATOR_HPP
+# define COUNTING_ALLOCATOR_HPP
+
+# include "ft_common.hpp"
+# include <memory>
+# include <cstddef>
+
+namespace ft {
+    // 確保中のバイト数と, 確保の回数を数えるアロケータ
+    // rebind 先の型も含めて, すべてのインスタンスで1つのカウンタを共有する。
+    // (メモリフットプリントの計測用)
+    template <class T>
+    class counting_allocator: public std::allocator<T> {
+        public:
+            typedef std::allocator<T>                   base;
+            typedef typename base::pointer              pointer;
+            typedef typename base::size_type            size_type;
+
+            template <class U>
+            struct rebind { typedef counting_allocator<U> other; };
+
+            counting_allocator() FT_NOEXCEPT {}
+            counting_allocator(const counting_allocator& other) FT_NOEXCEPT
+                : base(other) {}
+            template <class U>
+            counting_allocator(const counting_allocator<U>& other) FT_NOEXCEPT
+                : base(other) {}
+            counting_allocator& operator=(const counting_allocator& other) FT_NOEXCEPT {
+                base::operator=(other);
+                return *this;
+            }
+            ~counting_allocator() {}
+
+            pointer allocate(size_type n, const void* hint = 0) {
+                pointer p = base::allocate(n, hint);
+                bytes_in_use() += n * sizeof(T);
+                allocations() += 1;
+                return p;
+            }
+
+            void    deallocate(pointer p, size_type n) {
+                bytes_in_use() -= n * sizeof(T);
+                base::deallocate(p, n);
+            }
+
+            // 現在確保中のバイト数
+            static std::size_t& bytes_in_use() {
+                return counting_allocator<char>::counter_();
+            }
+
+            // これまでに allocate を呼んだ回数
+            static std::size_t& allocations() {
+                return counting_allocator<char>::allocation_counter_();
+            }
+
+        private:
+            template <class> friend class counting_allocator;
+
+            static std::size_t& counter_() {
+                static std::size_t  bytes = 0;
+                return bytes;
+            }
+
+            static std::size_t& allocation_counter_() {
+                static std::size_t  count = 0;
+                return count;
+            }
+    };
+
+    template <class T, class U>
+    inline bool operator==(const counting_allocator<T>&, const counting_allocator<U>&) {
+        return true;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const counting_allocator<T>&, const counting_allocator<U>&) {
+        return false;
+    }
+}
+
+#endif
@@ -27,6 +27,12 @@ namespace ft {
             std::stringstream&  get_tail();
 
             static void insert_comment(const std::string& comment);
+            // 今の RSS(物理メモリに載っているバイト数)をコメントとして記録する
+            static void insert_rss(const std::string& label);
+            // 今の RSS のバイト数。調べられない環境では 0
+            static std::size_t  resident_bytes();
+            // 今の RSS を "12 MiB" の形で。調べられない環境では "n/a"
+            static std::string  resident_string();
             static void push_bread(const std::string& bread);
             static void pop_bread();
             static void list();
@@ -6,6 +6,9 @@
 # include <cstdlib>
 # include "ft_common.hpp"
 # include "vector.hpp"
+# include "small_vector.hpp"
+# include "mmap_allocator.hpp"
+# include "mapped_vector.hpp"
 # include "noncopyable.hpp"
 # include <vector>
 # include <deque>
@@ -27,6 +30,10 @@
 #  include "tree.hpp"
 #  include "map.hpp"
 #  include "set.hpp"
+#  include "flat_map.hpp"
+#  include "flat_set.hpp"
+#  include "index_map.hpp"
+#  include "index_set.hpp"
 #  define StackContainer ft::vector
 #  define NS ft
 # endif
@@ -34,13 +41,25 @@
 # define VectorClass NS::vector
 # define StackClass  NS::stack
 # define PairClass   NS::pair
-# define MapClass    NS::map
-# define SetClass    NS::set
+// FT_FLAT_CONTAINERS なら, map, set のテストを flat_map, flat_set に対して行う。
+# if defined(FT_FLAT_CONTAINERS) && !defined(USE_STL)
+#  define MapClass   ft::flat_map
+#  define SetClass   ft::flat_set
+// FT_INDEX_CONTAINERS なら, map, set のテストを index_map, index_set に対して行う。
+# elif defined(FT_INDEX_CONTAINERS) && !defined(USE_STL)
+#  define MapClass   ft::index_map
+#  define SetClass   ft::index_set
+# else
+#  define MapClass   NS::map
+#  define SetClass   NS::set
+# endif
 # define DSOUT() debug_out(__FILE__, __LINE__)
 # define DOUT()  debug_err(__FILE__, __LINE__)
 
 # include "sprint.hpp"
 # include "IntWrapper.hpp"
+# include "counting_allocator.hpp"
+# include "node_pool.hpp"
 
 template <class T>
 struct simple_holder {
@@ -58,6 +77,23 @@ struct simple_holder {
     }
 };
 
+// is_transparent を持つ std::string のコンパレータ
+// ft::map, ft::set では const char* のまま検索できる(一時的な std::string を作らない)。
+// STL(C++98)では const char* が std::string に変換されてから比較される。
+struct transparent_string_less {
+    typedef void    is_transparent;
+
+    bool    operator()(const std::string& lhs, const std::string& rhs) const {
+        return lhs < rhs;
+    }
+    bool    operator()(const std::string& lhs, const char* rhs) const {
+        return lhs.compare(rhs) < 0;
+    }
+    bool    operator()(const char* lhs, const std::string& rhs) const {
+        return rhs.compare(lhs) > 0;
+    }
+};
+
 template<class T>
 T                   random_value_generator();
 template<>
@@ -107,13 +143,13 @@ std::ostream& operator<<(
 template <class Key, class KeyComparator, class KeyAllocator>
 std::ostream& operator<<(
     std::ostream& stream,
-    const NS::set<Key, KeyComparator, KeyAllocator>& value
+    const SetClass<Key, KeyComparator, KeyAllocator>& value
 );
 
 template <class Key, class Value, class KeyComparator, class PairAllocator>
 std::ostream& operator<<(
     std::ostream& stream,
-    const NS::map<Key, Value, KeyComparator, PairAllocator>& value
+    const MapClass<Key, Value, KeyComparator, PairAllocator>& value
 );
 
 template <class First, class Second>
@@ -159,9 +195,9 @@ std::ostream& operator<<(
 template <class Key, class KeyComparator, class KeyAllocator>
 std::ostream& operator<<(
     std::ostream& stream,
-    const NS::set<Key, KeyComparator, KeyAllocator>& value
+    const SetClass<Key, KeyComparator, KeyAllocator>& value
 ) {
-    typedef NS::set<Key, KeyComparator, KeyAllocator>   c_type;
+    typedef SetClass<Key, KeyComparator, KeyAllocator>   c_type;
     stream << "(";
     for (typename c_type::const_iterator it = value.begin(); it != value.end(); ++it) {
         if (it != value.begin()) {
@@ -177,9 +213,9 @@ std::ostream& operator<<(
 template <class Key, class Value, class KeyComparator, class PairAllocator>
 std::ostream& operator<<(
     std::ostream& stream,
-    const NS::map<Key, Value, KeyComparator, PairAllocator>& value
+    const MapClass<Key, Value, KeyComparator, PairAllocator>& value
 ) {
-    typedef NS::map<Key, Value, KeyComparator, PairAllocator>   c_type;
+    typedef MapClass<Key, Value, KeyComparator, PairAllocator>   c_type;
     stream << "{";
     for (typename c_type::const_iterator it = value.begin(); it != value.end(); ++it) {
         if (it != value.begin()) {
@@ -0,0 +1,62 @@
+// 公開ヘッダが単独で(ほかのヘッダより先に include されても)コンパイルできるかを確かめる。
+// make headers が, ヘッダごとに -D FT_HEADER='"flat_map.hpp"' のように指定してコンパイルする。
+// include しただけでは使われないメンバ関数の本体は実体化されないので,
+// include されたヘッダ(のインクルードガード)に応じてクラスを明示的に実体化し,
+// split や erase(first, last) などの本体もそのヘッダだけでコンパイルできることを確かめる。
+#include FT_HEADER
+
+#ifdef PAIR_HPP
+template struct ft::pair<int, int>;
+#endif
+#ifdef VECTOR_HPP
+template class ft::vector<int>;
+#endif
+#ifdef SMALL_VECTOR_HPP
+template class ft::small_vector<int, 4>;
+#endif
+#ifdef MMAP_ALLOCATOR_HPP
+template class ft::mmap_allocator<int>;
+#endif
+#ifdef MAPPED_VECTOR_HPP
+template class ft::mapped_vector<int>;
+#endif
+#ifdef NODE_POOL_HPP
+template class ft::node_pool<int>;
+#endif
+#ifdef MAP_HPP
+template class ft::map<int, int>;
+#endif
+#ifdef SET_HPP
+template class ft::set<int>;
+#endif
+#ifdef FLAT_MAP_HPP
+template class ft::flat_map<int, int>;
+#endif
+#ifdef FLAT_SET_HPP
+template class ft::flat_set<int>;
+#endif
+#ifdef INDEX_MAP_HPP
+template class ft::index_map<int, int>;
+#endif
+#ifdef INDEX_SET_HPP
+template class ft::index_set<int>;
+#endif
+#ifdef BTREE_MAP_HPP
+template class ft::btree_map<int, int>;
+#endif
+#ifdef BTREE_SET_HPP
+template class ft::btree_set<int>;
+#endif
+#ifdef UNORDERED_MAP_HPP
+template class ft::unordered_map<int, int>;
+#endif
+#ifdef UNORDERED_SET_HPP
+template class ft::unordered_set<int>;
+#endif
+#ifdef STACK_HPP
+template class ft::stack<int>;
+#endif
+
+int main() {
+    return 0;
+}
@@ -0,0 +1,643 @@
+#include <iostream>
+#include <string>
+#include <list>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+#include "test_common.hpp"
+#include "btree_map.hpp"
+#include "btree_set.hpp"
+
+// ft::btree_map, ft::btree_set のテスト。
+// - USE_STL なら std::map, std::set と出力を比べる(make bd)。
+// - FT_BTREE_BASELINE なら ft::map, ft::set を使う。
+//   btree とスプリントの時間を比べるのに使う(make btree_vs_map)。
+#if defined(USE_STL)
+# define BtreeMapClass std::map
+# define BtreeSetClass std::set
+#elif defined(FT_BTREE_BASELINE)
+# define BtreeMapClass ft::map
+# define BtreeSetClass ft::set
+#else
+# define BtreeMapClass ft::btree_map
+# define BtreeSetClass ft::btree_set
+#endif
+
+// ノードに値が3〜4個しか載らない btree
+// (少ない要素数で, 分割・併合・根の入れ替えが何段も起きる形を作る)
+#if defined(USE_STL)
+typedef std::set<int>                                       tiny_set_type;
+typedef std::map<int, int>                                  small_map_type;
+#elif defined(FT_BTREE_BASELINE)
+typedef ft::set<int>                                        tiny_set_type;
+typedef ft::map<int, int>                                   small_map_type;
+#else
+typedef ft::btree_set<int, std::less<int>, std::allocator<int>, 16>
+                                                            tiny_set_type;
+typedef ft::btree_map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, 48>
+                                                            small_map_type;
+#endif
+
+// 内部構造が正しいか
+// (btree 以外では常に true)
+template <class Container>
+bool    is_valid(const Container& c) {
+#if defined(USE_STL) || defined(FT_BTREE_BASELINE)
+    (void)c;
+    return true;
+#else
+    return c.debug_valid();
+#endif
+}
+
+template <class Map>
+void    print_map(const Map& m) {
+    std::cout << "{";
+    for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it) {
+        if (it != m.begin()) {
+            std::cout << ", ";
+        }
+        std::cout << "(" << it->first << " => " << it->second << ")";
+    }
+    std::cout << "}" << std::endl;
+}
+
+template <class Set>
+void    print_set(const Set& s) {
+    std::cout << "(";
+    for (typename Set::const_iterator it = s.begin(); it != s.end(); ++it) {
+        if (it != s.begin()) {
+            std::cout << ", ";
+        }
+        std::cout << *it;
+    }
+    std::cout << ")" << std::endl;
+}
+
+// 各機能を1つずつ潰していくテスト。
+namespace fill {
+    typedef BtreeMapClass<int, int>     map_type;
+    typedef map_type::iterator          iterator;
+    typedef map_type::const_iterator    const_iterator;
+    typedef BtreeSetClass<int>          set_type;
+
+    void    constructors(int n) {
+        SPRINT("constructors") << "(" << n << ")";
+        map_type    m;
+        DSOUT() << m.empty() << ", " << m.size() << ", " << (m.begin() == m.end()) << std::endl;
+        BtreeMapClass<int, int, std::greater<int> > g((std::greater<int>()));
+        VectorClass< PairClass<int, int> >  v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(NS::make_pair(rand() % (n * 2), i));
+            g.insert(v.back());
+        }
+        map_type    r((v.begin()), v.end());
+        DSOUT() << r.size() << ", " << g.size() << ", " << is_valid(r) << is_valid(g) << std::endl;
+        print_map(r);
+        print_map(g);
+        VectorClass< PairClass<int, int> >  sorted;
+        for (int i = 0; i < n; ++i) {
+            sorted.push_back(NS::make_pair(i * 3, i));
+        }
+#ifdef USE_STL
+        map_type    s((sorted.begin()), sorted.end());
+#else
+        map_type    s(ft::sorted_unique, sorted.begin(), sorted.end());
+#endif
+        DSOUT() << s.size() << ", " << is_valid(s) << std::endl;
+        print_map(s);
+        map_type    c((r));
+        DSOUT() << (c == r) << ", " << is_valid(c) << std::endl;
+        c = s;
+        DSOUT() << (c == s) << ", " << (c == r) << ", " << is_valid(c) << std::endl;
+        const map_type& self = c;
+        c = self;
+        DSOUT() << (c == s) << std::endl;
+    }
+
+    void    insert_value(int n) {
+        SPRINT("insert_value") << "(" << n << ")";
+        small_map_type  m;
+        for (int i = 0; i < n; ++i) {
+            int key = rand() % (n * 2);
+            PairClass<small_map_type::iterator, bool> result = m.insert(NS::make_pair(key, i));
+            DSOUT() << result.second << ", " << result.first->first << ", " << result.first->second << std::endl;
+        }
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+        // 昇順・降順の挿入(ノードを偏って分割する)
+        small_map_type  up;
+        small_map_type  down;
+        for (int i = 0; i < n; ++i) {
+            up.insert(NS::make_pair(i, i));
+            down.insert(NS::make_pair(n - i, i));
+        }
+        DSOUT() << up.size() << ", " << is_valid(up) << ", " << down.size() << ", " << is_valid(down) << std::endl;
+        print_map(up);
+        print_map(down);
+    }
+
+    void    insert_value_with_hint(int n) {
+        SPRINT("insert_value_with_hint") << "(" << n << ")";
+        small_map_type  m;
+        // 挿入ごとにイテレータは無効になるので, ヒントは毎回取り直す。
+        for (int i = 0; i < n; ++i) {
+            DSOUT() << *(m.insert(m.end(), NS::make_pair(i * 4, i))) << std::endl;
+        }
+        for (int i = 0; i < n; ++i) {
+            DSOUT() << *(m.insert(m.begin(), NS::make_pair(-i * 4 - 4, i))) << std::endl;
+        }
+        for (int i = 0; i < n; ++i) {
+            int key = rand() % (n * 8) - n * 4;
+            // 正しいヒント, 同じキー, 離れたヒント
+            DSOUT() << *(m.insert(m.lower_bound(key), NS::make_pair(key, -1))) << std::endl;
+            DSOUT() << *(m.insert(m.find(key), NS::make_pair(key, -2))) << std::endl;
+            small_map_type::iterator    far = m.begin();
+            std::advance(far, rand() % m.size());
+            DSOUT() << *(m.insert(far, NS::make_pair(key + 1, -3))) << std::endl;
+        }
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+    }
+
+    void    insert_value_with_range(int n) {
+        SPRINT("insert_value_with_range") << "(" << n << ")";
+        std::list< NS::pair<int, int> > l;
+        for (int i = 0; i < n; ++i) {
+            l.push_back(NS::make_pair(rand() % (n * 2), i));
+        }
+        map_type    m;
+        m.insert(l.begin(), l.end());
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+        VectorClass< PairClass<int, int> >  w;
+        for (int i = 0; i < n; ++i) {
+            w.push_back(NS::make_pair(i * 2, i));
+        }
+#ifdef USE_STL
+        m.insert(w.begin(), w.end());
+#else
+        m.insert(ft::sorted_unique, w.begin(), w.end());
+#endif
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+    }
+
+    void    erase_by_key(int n) {
+        SPRINT("erase_by_key") << "(" << n << ")";
+        small_map_type  m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(rand() % n, i));
+        }
+        for (int i = 0; i < n; ++i) {
+            int key = rand() % n;
+            DSOUT() << key << " -> " << m.erase(key) << std::endl;
+            if (!is_valid(m)) {
+                DSOUT() << "invalid after erase(" << key << ")" << std::endl;
+            }
+        }
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+        // すべて消す
+        while (!m.empty()) {
+            m.erase(m.begin()->first);
+        }
+        DSOUT() << m.size() << ", " << (m.begin() == m.end()) << ", " << is_valid(m) << std::endl;
+        m[1] = 1;
+        print_map(m);
+    }
+
+    // erase(position) の返り値は次の要素
+    // (C++98 の std::map::erase と ft::map::erase は void なので, 消す前に次を求める)
+    void    erase_by_position(int n) {
+        SPRINT("erase_by_position") << "(" << n << ")";
+        small_map_type  m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(i, i));
+        }
+        for (int i = 0; i < n && !m.empty(); ++i) {
+            small_map_type::iterator    it = m.begin();
+            std::advance(it, rand() % m.size());
+#if defined(USE_STL) || defined(FT_BTREE_BASELINE)
+            small_map_type::iterator    next = it;
+            ++next;
+            int next_key = next == m.end() ? -1 : next->first;
+            m.erase(it);
+#else
+            small_map_type::iterator    next = m.erase(it);
+            int next_key = next == m.end() ? -1 : next->first;
+#endif
+            DSOUT() << next_key << ", " << m.size() << ", " << is_valid(m) << std::endl;
+        }
+        print_map(m);
+        // 先頭と末尾から交互に消す
+        while (!m.empty()) {
+            if (m.size() % 2) {
+                m.erase(m.begin());
+            } else {
+                m.erase(--m.end());
+            }
+        }
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+    }
+
+    void    erase_by_range(int n) {
+        SPRINT("erase_by_range") << "(" << n << ")";
+        small_map_type  m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(i, i));
+        }
+        m.erase(m.lower_bound(n / 4), m.lower_bound(n / 2));
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+        m.erase(m.begin(), m.lower_bound(n / 8));
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        m.erase(m.lower_bound(n - n / 8), m.end());
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+        m.erase(m.begin(), m.end());
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+    }
+
+    void    lookup(int n) {
+        SPRINT("lookup") << "(" << n << ")";
+        small_map_type  m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(rand() % (n * 3), i));
+        }
+        const small_map_type&   cm = m;
+        for (int key = -1; key <= n * 3; ++key) {
+            small_map_type::iterator        f = m.find(key);
+            small_map_type::const_iterator  lb = cm.lower_bound(key);
+            small_map_type::const_iterator  ub = cm.upper_bound(key);
+            NS::pair<small_map_type::iterator, small_map_type::iterator>    r = m.equal_range(key);
+            DSOUT() << key << ": "
+                << (f == m.end() ? -1 : f->second) << ", "
+                << cm.count(key) << ", "
+                << (lb == cm.end() ? -1 : lb->first) << ", "
+                << (ub == cm.end() ? -1 : ub->first) << ", "
+                << std::distance(r.first, r.second) << std::endl;
+        }
+    }
+
+    // ヒントつき lower_bound, find と find_sorted
+    // (STLではヒントを使わない)
+    void    lookup_with_hint(int n) {
+        SPRINT("lookup_with_hint") << "(" << n << ")";
+        small_map_type  m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(rand() % (n * 2), i));
+        }
+        small_map_type::iterator    hint = m.begin();
+        for (int i = 0; i < n * 2; ++i) {
+            int key = rand() % (n * 2 + 2) - 1;
+#ifdef USE_STL
+            small_map_type::iterator    lb = m.lower_bound(key);
+            small_map_type::iterator    f = m.find(key);
+#else
+            small_map_type::iterator    lb = m.lower_bound(hint, key);
+            small_map_type::iterator    f = m.find(hint, key);
+#endif
+            DSOUT() << (lb == m.end() ? -1 : lb->first) << ", " << (f == m.end()) << std::endl;
+            hint = lb;
+        }
+        std::vector<int>    keys;
+        for (int i = 0; i < n; ++i) {
+            keys.push_back(rand() % (n * 2 + 2) - 1);
+        }
+        std::sort(keys.begin(), keys.end());
+        std::vector<small_map_type::iterator>   found;
+#ifdef USE_STL
+        for (std::vector<int>::iterator it = keys.begin(); it != keys.end(); ++it) {
+            found.push_back(m.find(*it));
+        }
+#else
+        m.find_sorted(keys.begin(), keys.end(), std::back_inserter(found));
+#endif
+        for (std::size_t i = 0; i < found.size(); ++i) {
+            DSOUT() << keys[i] << " -> " << (found[i] == m.end() ? -1 : found[i]->second) << std::endl;
+        }
+    }
+
+    void    iteration(int n) {
+        SPRINT("iteration") << "(" << n << ")";
+        small_map_type  m;
+        for (int i = 0; i < n; ++i) {
+            m[rand() % (n * 2)] = i;
+        }
+        for (small_map_type::reverse_iterator it = m.rbegin(); it != m.rend(); ++it) {
+            DSOUT() << it->first << std::endl;
+        }
+        small_map_type::iterator    it = m.end();
+        while (it != m.begin()) {
+            --it;
+            it->second += 1;
+        }
+        small_map_type::const_iterator  cit = m.begin();
+        for (int i = 0; i < n / 2 && cit != m.end(); ++i) {
+            DSOUT() << *(cit++) << std::endl;
+            DSOUT() << (cit == m.end() ? -1 : cit->first) << std::endl;
+        }
+        print_map(m);
+    }
+
+    void    swap_clear_compare(int n) {
+        SPRINT("swap_clear_compare") << "(" << n << ")";
+        map_type    a;
+        map_type    b;
+        for (int i = 0; i < n; ++i) {
+            a[i] = i;
+            b[i * 2] = i;
+        }
+        DSOUT() << (a == b) << (a != b) << (a < b) << (a <= b) << (a > b) << (a >= b) << std::endl;
+        a.swap(b);
+        DSOUT() << a.size() << ", " << b.size() << ", " << is_valid(a) << is_valid(b) << std::endl;
+        std::swap(a, b);
+        DSOUT() << (a < b) << ", " << a[n / 2] << ", " << b.count(n) << std::endl;
+        a.clear();
+        DSOUT() << a.size() << ", " << (a.begin() == a.end()) << ", " << is_valid(a) << std::endl;
+        a = b;
+        DSOUT() << (a == b) << std::endl;
+        a[-1] = -1;
+        DSOUT() << (a == b) << (a < b) << std::endl;
+    }
+
+    void    set_basic(int n) {
+        SPRINT("set_basic") << "(" << n << ")";
+        set_type    s;
+        for (int i = 0; i < n; ++i) {
+            s.insert(rand() % (n * 2));
+        }
+        DSOUT() << s.size() << ", " << is_valid(s) << std::endl;
+        print_set(s);
+        for (int i = 0; i < n; ++i) {
+            int key = rand() % (n * 2);
+            set_type::const_iterator    lb = s.lower_bound(key);
+            DSOUT() << s.count(key) << ", " << (lb == s.end() ? -1 : *lb) << std::endl;
+            s.erase(key);
+        }
+        DSOUT() << s.size() << ", " << is_valid(s) << std::endl;
+        print_set(s);
+        set_type    t(s);
+        DSOUT() << (s == t) << ", " << is_valid(t) << std::endl;
+    }
+
+    // 挿入と削除をランダムに繰り返し, 構造が壊れないことを確かめる。
+    // (構造の検査は O(n) なので, check 回に1回)
+    void    random_operations(int n, int m, int check) {
+        SPRINT("random_operations") << "(" << n << ", " << m << ")";
+        tiny_set_type   s;
+        int             invalid = 0;
+        for (int i = 0; i < m; ++i) {
+            int key = rand() % n;
+            if (rand() % 3) {
+                s.insert(key);
+            } else {
+                s.erase(key);
+            }
+            if (i % check == 0 && !is_valid(s)) {
+                ++invalid;
+            }
+        }
+        DSOUT() << s.size() << ", " << invalid << std::endl;
+        print_set(s);
+        while (!s.empty()) {
+            tiny_set_type::const_iterator   it = s.begin();
+            std::advance(it, rand() % s.size());
+            s.erase(it);
+            if (s.size() % check == 0 && !is_valid(s)) {
+                ++invalid;
+            }
+        }
+        DSOUT() << s.size() << ", " << invalid << std::endl;
+    }
+
+    void    test() {
+        constructors(0);
+        constructors(1);
+        constructors(100);
+        insert_value(0);
+        insert_value(1);
+        insert_value(100);
+        insert_value(1000);
+        insert_value_with_hint(1);
+        insert_value_with_hint(100);
+        insert_value_with_range(0);
+        insert_value_with_range(1000);
+        erase_by_key(1);
+        erase_by_key(100);
+        erase_by_key(1000);
+        erase_by_position(1);
+        erase_by_position(100);
+        erase_by_position(1000);
+        erase_by_range(10);
+        erase_by_range(1000);
+        lookup(0);
+        lookup(1);
+        lookup(100);
+        lookup_with_hint(1);
+        lookup_with_hint(300);
+        iteration(1);
+        iteration(100);
+        swap_clear_compare(0);
+        swap_clear_compare(100);
+        set_basic(0);
+        set_basic(100);
+        set_basic(1000);
+        random_operations(10, 1000, 1);
+        random_operations(100, 10000, 1);
+        random_operations(1000, 100000, 100);
+    }
+}
+
+namespace logic {
+    // - is_transparent を持つコンパレータなら, key_type 以外の型で検索・削除できること
+    void    transparent_lookup() {
+        SPRINT("transparent_lookup");
+        typedef BtreeMapClass<std::string, int, transparent_string_less>   map_type;
+        const char* words[] = { "apple", "banana", "cherry", "durian", "elderberry" };
+        map_type    m;
+        for (int i = 0; i < 5; ++i) {
+            m.insert(NS::make_pair(words[i], i));
+        }
+        const map_type& cm = m;
+        DSOUT() << m.count("banana") << ", " << cm.count("blueberry") << std::endl;
+        DSOUT() << *(m.find("cherry")) << std::endl;
+        DSOUT() << (cm.find("coconut") == cm.end()) << std::endl;
+        DSOUT() << *(m.lower_bound("c")) << ", " << *(cm.upper_bound("cherry")) << std::endl;
+        NS::pair<map_type::iterator, map_type::iterator>  r = m.equal_range("durian");
+        DSOUT() << *(r.first) << ", " << *(r.second) << std::endl;
+        DSOUT() << m.erase("apple") << ", " << m.erase("apple") << std::endl;
+        print_map(m);
+    }
+
+    // - 文字列のような, 内部にポインタを持つ値がノード間を移動しても壊れないこと
+    void    string_values(int n) {
+        SPRINT("string_values") << "(" << n << ")";
+        BtreeMapClass<std::string, std::string>   m;
+        for (int i = 0; i < n; ++i) {
+            std::string k = random_value_generator<std::string>();
+            m[k] = k + k;
+        }
+        for (int i = 0; i < n / 2; ++i) {
+            m.erase(random_value_generator<std::string>());
+        }
+        int broken = 0;
+        for (BtreeMapClass<std::string, std::string>::iterator it = m.begin(); it != m.end(); ++it) {
+            if (it->second != it->first + it->first) {
+                ++broken;
+            }
+        }
+        DSOUT() << m.size() << ", " << broken << ", " << is_valid(m) << std::endl;
+        print_map(m);
+    }
+
+    // - node_pool を使えること(要素をすべて消しても, 最初のスラブは残る)
+    void    node_pool(int n) {
+        SPRINT("node_pool") << "(" << n << ")";
+        typedef BtreeMapClass<
+            int, int, std::less<int>, ft::node_pool< PairClass<const int, int> >
+        > map_type;
+        std::size_t base = ft::node_pool<int>::slab_bytes_in_use();
+        {
+            map_type    m;
+            for (int i = 0; i < n; ++i) {
+                m.insert(NS::make_pair(rand() % (n * 2), i));
+            }
+            for (int i = 0; i < n; ++i) {
+                m.erase(rand() % (n * 2));
+            }
+            map_type    mm(m);
+            DSOUT() << (m == mm) << ", " << is_valid(mm) << std::endl;
+            print_map(m);
+            m.clear();
+            mm.clear();
+            // 残ったスラブで足りるので, 空と1個を行き来してもスラブは増えない
+            std::size_t kept = ft::node_pool<int>::slab_bytes_in_use();
+            for (int i = 0; i < 1000; ++i) {
+                m.insert(NS::make_pair(i, i));
+                m.erase(i);
+            }
+            DSOUT() << (n == 0 || ft::node_pool<int>::slab_bytes_in_use() == kept) << std::endl;
+        }
+        DSOUT() << (ft::node_pool<int>::slab_bytes_in_use() == base) << std::endl;
+    }
+
+    void    test() {
+        transparent_lookup();
+        string_values(10);
+        string_values(1000);
+        node_pool(0);
+        node_pool(100);
+        node_pool(10000);
+    }
+}
+
+namespace memory {
+    // map<int, int> の要素あたりのメモリ使用量(アロケータ経由のバイト数のみ)
+    // 実装によって異なるので標準エラーに出す。
+    void    footprint(int n) {
+        typedef BtreeMapClass<
+            int, int, std::less<int>, ft::counting_allocator< PairClass<const int, int> >
+        > map_type;
+        std::size_t base = ft::counting_allocator<int>::bytes_in_use();
+        map_type    random;
+        map_type    sorted;
+        for (int i = 0; i < n; ++i) {
+            random.insert(NS::make_pair(rand(), i));
+            sorted.insert(sorted.end(), NS::make_pair(i, i));
+        }
+        std::size_t used = ft::counting_allocator<int>::bytes_in_use() - base;
+        DSOUT() << random.size() << ", " << sorted.size() << std::endl;
+        DOUT() << "footprint(" << n << "): "
+            << (double)used / (random.size() + sorted.size()) << " bytes/element" << std::endl;
+    }
+
+    void    test() {
+        footprint(1000);
+        footprint(1000000);
+    }
+}
+
+// btree と ft::map (make btree_vs_map) / std::map (make bd) を比べるスプリント
+// 要素数 n のmapに対して, 挿入・検索・走査・削除の時間を測る。
+namespace performance {
+    typedef BtreeMapClass<int, int> map_type;
+
+    void    suite(int n) {
+        std::vector<int>    keys;
+        std::vector<int>    probes;
+        for (int i = 0; i < n; ++i) {
+            keys.push_back(rand());
+        }
+        // 半分は存在するキー, 半分はランダムなキー
+        for (int i = 0; i < n; ++i) {
+            probes.push_back(i % 2 ? keys[rand() % n] : rand());
+        }
+        map_type    m;
+        {
+            SPRINT("performance::insert") << "(" << n << ")";
+            for (int i = 0; i < n; ++i) {
+                m.insert(NS::make_pair(keys[i], i));
+            }
+        }
+        long    hits = 0;
+        {
+            SPRINT("performance::lookup") << "(" << n << ")";
+            for (int i = 0; i < n; ++i) {
+                if (m.find(probes[i]) != m.end()) {
+                    ++hits;
+                }
+            }
+        }
+        long    sum = 0;
+        {
+            SPRINT("performance::scan") << "(" << n << ")";
+            for (map_type::const_iterator it = m.begin(); it != m.end(); ++it) {
+                sum += it->second;
+            }
+        }
+        std::random_shuffle(keys.begin(), keys.end());
+        {
+            SPRINT("performance::erase") << "(" << n << ")";
+            for (int i = 0; i < n; ++i) {
+                m.erase(keys[i]);
+            }
+        }
+        DSOUT() << hits << ", " << sum << ", " << m.size() << std::endl;
+    }
+
+    // 昇順のキーを末尾に追加していく
+    void    sorted_insert(int n) {
+        map_type    m;
+        {
+            SPRINT("performance::sorted_insert") << "(" << n << ")";
+            for (int i = 0; i < n; ++i) {
+                m.insert(m.end(), NS::make_pair(i, i));
+            }
+        }
+        DSOUT() << m.size() << std::endl;
+    }
+
+    // 10^3 から 10^max_exp 要素まで
+    void    test(int max_exp) {
+        int n = 1000;
+        for (int e = 3; e <= max_exp; ++e, n *= 10) {
+            suite(n);
+            sorted_insert(n);
+        }
+    }
+}
+
+// 引数はスプリントの最大要素数の指数(既定は6 -> 10^6 要素)
+// 10^8 要素では ft::map / std::map に数GBのメモリが要る。
+int main(int argc, char** argv)
+{
+    int max_exp = argc > 1 ? std::atoi(argv[1]) : 6;
+    fill::test();
+    logic::test();
+    memory::test();
+    performance::test(max_exp);
+    ft::sprint::list();
+}
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <string>
 #include <list>
+#include <algorithm>
+#include <iterator>
 #include "test_common.hpp"
 
 // 各機能を1つずつ潰していくテスト。
@@ -69,6 +71,42 @@ namespace fill {
         DSOUT() << (m.begin() == m.end()) << std::endl;
     }
 
+    // ソート済み・重複なし範囲からのコンストラクタ
+    // (STLにはないので, 通常の範囲コンストラクタと結果を比べる)
+    void    constructor_sorted_unique(int n) {
+        SPRINT("constructor_sorted_unique") << "(" << n << ")";
+        VectorClass< PairClass<int, int> >  v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(NS::make_pair(i * 3, rand()));
+        }
+# ifdef USE_STL
+        map_type    m((v.begin()), v.end());
+# else
+        map_type    m(ft::sorted_unique, v.begin(), v.end());
+# endif
+        DSOUT() << m.size() << std::endl;
+        DSOUT() << m << std::endl;
+        // 組み立てた後も普通に挿入・削除できる
+        for (int i = 0; i < n; ++i) {
+            m[i * 3 + 1] = i;
+            m.erase(i * 6);
+        }
+        DSOUT() << m.size() << std::endl;
+        DSOUT() << m << std::endl;
+        // 空でないmapへのソート済み範囲挿入は通常の挿入と同じ結果になる
+        VectorClass< PairClass<int, int> >  w;
+        for (int i = 0; i < n; ++i) {
+            w.push_back(NS::make_pair(i * 2, i));
+        }
+# ifdef USE_STL
+        m.insert(w.begin(), w.end());
+# else
+        m.insert(ft::sorted_unique, w.begin(), w.end());
+# endif
+        DSOUT() << m.size() << std::endl;
+        DSOUT() << m << std::endl;
+    }
+
     // コピーコンストラクタ
     void    constructor_copy(int n) {
         SPRINT("constructor_copy") << "(" << n << ")";
@@ -259,6 +297,110 @@ namespace fill {
         DSOUT() << *(m.begin()) << std::endl;
     }
 
+    // 分割・連結
+    // (STLにはないので, 範囲コンストラクタ・erase・insert で同じことをする)
+    void    split_join(int n) {
+        SPRINT("split_join") << "(" << n << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m[rand() % (n * 4)] = rand();
+        }
+        int keys[] = { -1, 0, n, n * 2, n * 4 };
+        for (std::size_t i = 0; i < sizeof(keys) / sizeof(*keys); ++i) {
+            map_type    upper;
+# ifdef USE_STL
+            upper = map_type(m.lower_bound(keys[i]), m.end());
+            m.erase(m.lower_bound(keys[i]), m.end());
+# else
+            m.split(keys[i], upper);
+# endif
+            DSOUT() << m.size() << ", " << upper.size() << std::endl;
+            DSOUT() << m << std::endl;
+            DSOUT() << upper << std::endl;
+            if (!upper.empty()) {
+                DSOUT() << *(upper.begin()) << std::endl;
+            }
+# ifdef USE_STL
+            m.insert(upper.begin(), upper.end());
+            upper.clear();
+# else
+            m.join(upper);
+# endif
+            DSOUT() << m.size() << ", " << upper.size() << std::endl;
+            DSOUT() << m << std::endl;
+        }
+        // 右に連結, 左に連結, 範囲が重なる連結
+        for (int k = 0; k < 3; ++k) {
+            map_type    mm;
+            for (int i = 0; i < n; ++i) {
+                if (k == 0) {
+                    mm[n * 4 + i] = i;
+                } else if (k == 1) {
+                    mm.insert(NS::make_pair(-1 - i, i));
+                } else {
+                    mm[i] = i;
+                }
+            }
+# ifdef USE_STL
+            m.insert(mm.begin(), mm.end());
+            mm.clear();
+# else
+            m.join(mm);
+# endif
+            DSOUT() << m.size() << ", " << mm.size() << std::endl;
+            DSOUT() << m << std::endl;
+        }
+    }
+
+    // 順序統計
+    // (STLにはないので, std::distance と std::advance で同じことをする)
+    void    order_statistics(int n) {
+        SPRINT("order_statistics") << "(" << n << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m[rand() % (n * 4)] = rand();
+        }
+        for (int k = 0; k < 3; ++k) {
+            for (int i = -1; i <= n * 4; i += n / 8 + 1) {
+# ifdef USE_STL
+                long    r = std::distance(m.begin(), m.lower_bound(i));
+# else
+                long    r = m.rank(i);
+# endif
+                DSOUT() << r << std::endl;
+            }
+            for (int i = 0; i <= (int)m.size(); i += n / 8 + 1) {
+                const_iterator  it = m.begin();
+# ifdef USE_STL
+                std::advance(it, i);
+# else
+                it = m.nth(i);
+# endif
+                if (it != m.end()) {
+                    DSOUT() << *it << std::endl;
+                }
+                const_iterator  b = m.begin();
+                const_iterator  e = m.end();
+# ifdef USE_STL
+                long    d1 = std::distance(b, it);
+                long    d2 = std::distance(it, e);
+# else
+                long    d1 = m.distance(b, it);
+                long    d2 = m.distance(it, e);
+# endif
+                DSOUT() << d1 << ", " << d2 << std::endl;
+            }
+            // 挿入・削除の後も数えられる
+            for (int i = 0; i < n; ++i) {
+                if (rand() % 2) {
+                    m[rand() % (n * 4)] = i;
+                } else {
+                    m.erase(rand() % (n * 4));
+                }
+            }
+        }
+    }
+
     void    insert_value(int n) {
         SPRINT("insert_value") << "(" << n << ")";
         map_type    m;
@@ -290,6 +432,54 @@ namespace fill {
         DSOUT() << m.size() << std::endl;
         DSOUT() << (m.begin() == m.end()) << std::endl;
         DSOUT() << *(m.begin()) << std::endl;
+        // ヒントと同じキー -> 挿入されない
+        it = m.begin();
+        for (int i = 0; i < n / 2 && it != m.end(); ++i, ++it) {
+            map_type::iterator  r = m.insert(it, NS::make_pair(it->first, -1));
+            DSOUT() << (r == it) << ", " << *r << std::endl;
+        }
+        // 離れたヒント
+        for (int i = 0; i < n; ++i) {
+            map_type::iterator  hint = m.begin();
+            std::advance(hint, rand() % m.size());
+            DSOUT() << *(m.insert(hint, NS::make_pair(rand() % 1000, i))) << std::endl;
+        }
+        DSOUT() << m.size() << std::endl;
+        DSOUT() << m << std::endl;
+    }
+
+    // ヒントつき lower_bound, find
+    // (STLではヒントを使わない)
+    void    lookup_with_hint(int n) {
+        SPRINT("lookup_with_hint") << "(" << n << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(rand() % (n * 2), i));
+        }
+        const map_type& cm = m;
+        iterator        hint = m.begin();
+        const_iterator  chint = cm.end();
+        for (int i = 0; i < n * 2; ++i) {
+            int key = rand() % (n * 2 + 2) - 1;
+# ifdef USE_STL
+            iterator        lb = m.lower_bound(key);
+            iterator        f = m.find(key);
+            const_iterator  clb = cm.lower_bound(key);
+            const_iterator  cf = cm.find(key);
+# else
+            iterator        lb = m.lower_bound(hint, key);
+            iterator        f = m.find(hint, key);
+            const_iterator  clb = cm.lower_bound(chint, key);
+            const_iterator  cf = cm.find(chint, key);
+# endif
+            DSOUT() << (lb == m.end() ? -1 : lb->first) << ", " << (f == m.end()) << std::endl;
+            DSOUT() << (clb == cm.end() ? -1 : clb->first) << ", " << (cf == cm.end()) << std::endl;
+            if (rand() % 2) {
+                hint = lb;
+            } else {
+                chint = clb;
+            }
+        }
     }
 
     void    insert_value_with_range(int n) {
@@ -381,6 +571,91 @@ namespace fill {
         DSOUT() << (m.begin() == m.end()) << std::endl;
     }
 
+    // ソート済みのキー列での一括検索
+    // (STLでは1つずつ find)
+    void    find_sorted(int n, int k) {
+        SPRINT("find_sorted") << "(" << n << ", " << k << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(rand() % (n * 2), i));
+        }
+        std::vector<int>    keys;
+        for (int i = 0; i < k; ++i) {
+            keys.push_back(rand() % (n * 2 + 2) - 1);
+        }
+        std::sort(keys.begin(), keys.end());
+        std::vector<iterator>   found;
+# ifdef USE_STL
+        for (std::vector<int>::iterator it = keys.begin(); it != keys.end(); ++it) {
+            found.push_back(m.find(*it));
+        }
+# else
+        m.find_sorted(keys.begin(), keys.end(), std::back_inserter(found));
+# endif
+        DSOUT() << found.size() << std::endl;
+        for (std::vector<iterator>::size_type i = 0; i < found.size(); ++i) {
+            if (found[i] == m.end()) {
+                DSOUT() << keys[i] << ": end" << std::endl;
+            } else {
+                DSOUT() << keys[i] << ": " << *(found[i]) << std::endl;
+            }
+        }
+        // const な map からも同じ位置が得られること
+        const map_type&             cm = m;
+        std::vector<const_iterator> cfound;
+# ifdef USE_STL
+        for (std::vector<int>::iterator it = keys.begin(); it != keys.end(); ++it) {
+            cfound.push_back(cm.find(*it));
+        }
+# else
+        cm.find_sorted(keys.begin(), keys.end(), std::back_inserter(cfound));
+# endif
+        DSOUT() << (cfound.size() == found.size()
+            && std::equal(cfound.begin(), cfound.end(), found.begin())) << std::endl;
+    }
+
+    // 順不同のキー列でのグループ検索
+    // (STLでは1つずつ find)
+    void    find_batch(int n, int k) {
+        SPRINT("find_batch") << "(" << n << ", " << k << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(rand() % (n * 2), i));
+        }
+        std::vector<int>    keys;
+        for (int i = 0; i < k; ++i) {
+            keys.push_back(rand() % (n * 2 + 2) - 1);
+        }
+        std::vector<iterator>   found;
+# ifdef USE_STL
+        for (std::vector<int>::iterator it = keys.begin(); it != keys.end(); ++it) {
+            found.push_back(m.find(*it));
+        }
+# else
+        m.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+# endif
+        DSOUT() << found.size() << std::endl;
+        for (std::vector<iterator>::size_type i = 0; i < found.size(); ++i) {
+            if (found[i] == m.end()) {
+                DSOUT() << keys[i] << ": end" << std::endl;
+            } else {
+                DSOUT() << keys[i] << ": " << *(found[i]) << std::endl;
+            }
+        }
+        // const な map からも同じ位置が得られること
+        const map_type&             cm = m;
+        std::vector<const_iterator> cfound;
+# ifdef USE_STL
+        for (std::vector<int>::iterator it = keys.begin(); it != keys.end(); ++it) {
+            cfound.push_back(cm.find(*it));
+        }
+# else
+        cm.find_batch(keys.begin(), keys.end(), std::back_inserter(cfound));
+# endif
+        DSOUT() << (cfound.size() == found.size()
+            && std::equal(cfound.begin(), cfound.end(), found.begin())) << std::endl;
+    }
+
     void    find_constant(int n) {
         SPRINT("find_constant") << "(" << n << ")";
         map_type    m;
@@ -546,6 +821,9 @@ namespace fill {
         constructor_comparator(100);
         constructor_comparator_allocator(100);
         constructor_iterator(100);
+        constructor_sorted_unique(0);
+        constructor_sorted_unique(1);
+        constructor_sorted_unique(100);
         constructor_copy(100);
         oprator_assignation(100);
         begin_end();
@@ -555,6 +833,8 @@ namespace fill {
         begin_end_variable();
         clear(100);
         swap(100);
+        split_join(100);
+        order_statistics(100);
         insert_value(100);
         insert_value_with_hint(100);
         insert_value_with_range(100);
@@ -562,6 +842,17 @@ namespace fill {
         erase_by_key(100);
         erase_by_range(100);
         find_variable(100);
+        lookup_with_hint(0);
+        lookup_with_hint(1);
+        lookup_with_hint(100);
+        find_sorted(0, 10);
+        find_sorted(100, 0);
+        find_sorted(100, 10);
+        find_sorted(100, 100);
+        find_sorted(100, 1000);
+        find_batch(0, 10);
+        find_batch(100, 7);
+        find_batch(100, 100);
         find_constant(100);
         equal_range(100);
         lower_bound(100);
@@ -599,6 +890,58 @@ namespace logic {
         DSOUT() << m.size() << std::endl;
     }
 
+    // 順序は同じで, 識別用の状態だけを持つコンパレータ
+    struct tagged_compare {
+        int tag;
+        tagged_compare(int t = 0): tag(t) {}
+        bool    operator()(int lhs, int rhs) const {
+            return lhs < rhs;
+        }
+    };
+
+    // - 空のコンテナに連結しても, 双方が自分のコンパレータを保つこと
+    void    join_keeps_comparator() {
+        SPRINT("join_keeps_comparator");
+        typedef MapClass<int, Value, tagged_compare>    map_type;
+        map_type    m((tagged_compare(1)));
+        map_type    other((tagged_compare(2)));
+        for (int i = 0; i < 10; ++i) {
+            other[i] = i;
+        }
+# ifdef USE_STL
+        m.insert(other.begin(), other.end());
+        other.clear();
+# else
+        m.join(other);
+# endif
+        DSOUT() << m.size() << ", " << other.size() << std::endl;
+        DSOUT() << m.key_comp().tag << ", " << other.key_comp().tag << std::endl;
+    }
+
+    // - is_transparent を持つコンパレータなら, key_type 以外の型で検索・削除できること
+    void    transparent_lookup() {
+        SPRINT("transparent_lookup");
+        typedef MapClass<Key, Value, transparent_string_less>   map_type;
+        const char* words[] = { "apple", "banana", "cherry", "durian", "elderberry" };
+        map_type    m;
+        for (int i = 0; i < 5; ++i) {
+            m.insert(NS::make_pair(words[i], i));
+        }
+        const map_type& cm = m;
+        DSOUT() << m.count("banana") << ", " << cm.count("blueberry") << std::endl;
+        DSOUT() << *(m.find("cherry")) << std::endl;
+        DSOUT() << (cm.find("coconut") == cm.end()) << std::endl;
+        DSOUT() << *(m.lower_bound("c")) << ", " << *(cm.upper_bound("cherry")) << std::endl;
+        DSOUT() << *(cm.lower_bound("durian")) << ", " << (m.upper_bound("f") == m.end()) << std::endl;
+        NS::pair<map_type::iterator, map_type::iterator>  r = m.equal_range("durian");
+        DSOUT() << *(r.first) << ", " << *(r.second) << std::endl;
+        NS::pair<map_type::const_iterator, map_type::const_iterator>  cr = cm.equal_range("date");
+        DSOUT() << (cr.first == cr.second) << ", " << *(cr.first) << std::endl;
+        DSOUT() << m.erase("apple") << ", " << m.erase("apple") << std::endl;
+        m.erase(m.find("banana"));
+        DSOUT() << m << std::endl;
+    }
+
     // - 内部にポインタを持つオブジェクトを持てること
     // - clear後にinsertしても状態が整合すること
     void    destroy_and_create() {
@@ -796,8 +1139,32 @@ namespace logic {
         DSOUT() << s.size() << std::endl;
     }
 
+    // コピーの途中で要素のコピーが失敗しても、リークせず元のmapが壊れないこと
+    void    strong_copy() {
+        SPRINT("strong_copy");
+        typedef MapClass<int, ft::IntWrapper>   map_type;
+        map_type    m;
+        for (int i = 0; i < 10; ++i) {
+            m.insert(NS::make_pair(i, ft::IntWrapper(i * 10)));
+        }
+        try {
+            ft::IntWrapper::set_limit(5);
+            map_type    mm((m));
+            DSOUT() << mm.size() << std::endl;
+        } catch(std::runtime_error& e) {
+            DSOUT() << "exception: " << e.what() << std::endl;
+        }
+        ft::IntWrapper::set_limit(-1);
+        DSOUT() << m.size() << std::endl;
+        DSOUT() << m << std::endl;
+        map_type    mm((m));
+        DSOUT() << mm << std::endl;
+    }
+
     void    test() {
         specify_comparator();
+        join_keeps_comparator();
+        transparent_lookup();
         destroy_and_create();
         map_on_map();
         map_on_set();
@@ -809,6 +1176,7 @@ namespace logic {
         pointer_is_val();
         const_is_key();
         const_is_val();
+        strong_copy();
     }
 }
 
@@ -862,6 +1230,250 @@ namespace performance {
         }
     }
 
+    // ソート済みの列からの構築
+    // (STLでは通常の範囲コンストラクタ)
+    void    sorted_construction(int n) {
+        VectorClass< PairClass<int, int> >  v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(NS::make_pair(i, rand()));
+        }
+        {
+            SPRINT("performance::sorted_construction") << "(" << n << ")";
+# ifdef USE_STL
+            MapClass<int, int>  ss((v.begin()), v.end());
+# else
+            MapClass<int, int>  ss(ft::sorted_unique, v.begin(), v.end());
+# endif
+        }
+    }
+
+    // 真ん中で分割して連結し直す
+    // (STLでは範囲コンストラクタ・erase・insert)
+    void    split_join(int n, int m) {
+        MapClass<int, int>   s;
+        for (int i = 0; i < n; ++i) {
+            s.insert(NS::make_pair(rand(), rand()));
+        }
+        {
+            SPRINT("performance::split_join") << "(" << n << ", " << m << ")";
+            for (int i = 0; i < m; ++i) {
+                MapClass<int, int>   upper;
+                int key = rand();
+# ifdef USE_STL
+                upper.insert(s.lower_bound(key), s.end());
+                s.erase(s.lower_bound(key), s.end());
+                s.insert(upper.begin(), upper.end());
+# else
+                s.split(key, upper);
+                s.join(upper);
+# endif
+            }
+            DSOUT() << s.size() << std::endl;
+        }
+    }
+
+    // 順位と添字による検索
+    // (STLでは std::distance と std::advance)
+    void    rank_and_nth(int n, int m) {
+        MapClass<int, int>   s;
+        for (int i = 0; i < n; ++i) {
+            s.insert(NS::make_pair(rand(), rand()));
+        }
+        {
+            SPRINT("performance::rank_and_nth") << "(" << n << ", " << m << ")";
+            long    sum = 0;
+            for (int i = 0; i < m; ++i) {
+# ifdef USE_STL
+                sum += std::distance(s.begin(), s.lower_bound(rand()));
+                MapClass<int, int>::iterator    it = s.begin();
+                std::advance(it, rand() % s.size());
+                sum += it->second % 2;
+# else
+                sum += s.rank(rand());
+                sum += s.nth(rand() % s.size())->second % 2;
+# endif
+            }
+            DSOUT() << (sum > 0) << std::endl;
+        }
+    }
+
+    // 長い文字列キーを const char* で検索する
+    // (ft では transparent なコンパレータにより一時的な std::string を作らない)
+    void    transparent_find(int n, int m) {
+        typedef MapClass<std::string, int, transparent_string_less> map_type;
+        std::vector<std::string>    keys;
+        map_type    s;
+        for (int i = 0; i < n; ++i) {
+            std::string key(48, 'k');
+            for (int j = 0; j < 8; ++j) {
+                key[40 + j] = 'a' + rand() % 26;
+            }
+            keys.push_back(key);
+            s.insert(NS::make_pair(key, i));
+        }
+        long    sum = 0;
+        {
+            SPRINT("performance::transparent_find") << "(" << n << ", " << m << ")";
+            for (int i = 0; i < m; ++i) {
+                const char* key = keys[rand() % n].c_str();
+                map_type::const_iterator    it = s.find(key);
+                if (it != s.end()) {
+                    sum += it->second;
+                }
+                sum += s.count(key);
+            }
+        }
+        DSOUT() << (sum > 0) << std::endl;
+    }
+
+    // カーソルのように, 前回の位置から少し先のキーを探していく
+    // (STLではヒントなしの lower_bound)
+    void    cursor_lookup(int n, int m) {
+        MapClass<int, int>  s;
+        for (int i = 0; i < n; ++i) {
+            s.insert(NS::make_pair(i * 2, i));
+        }
+        long    sum = 0;
+        {
+            SPRINT("performance::cursor_lookup") << "(" << n << ", " << m << ")";
+            MapClass<int, int>::iterator    cursor = s.begin();
+            int                             key = 0;
+            for (int i = 0; i < m; ++i) {
+                key = (key + rand() % 16) % (n * 2);
+# ifdef USE_STL
+                cursor = s.lower_bound(key);
+# else
+                cursor = s.lower_bound(cursor, key);
+# endif
+                if (cursor != s.end()) {
+                    sum += cursor->second;
+                }
+            }
+        }
+        DSOUT() << (sum > 0) << std::endl;
+    }
+
+    // 近いが隣接しないヒントでの挿入
+    void    near_hint_insertion(int n, int m) {
+        MapClass<int, int>  s;
+        for (int i = 0; i < n; ++i) {
+            s.insert(NS::make_pair(i * 16, i));
+        }
+        {
+            SPRINT("performance::near_hint_insertion") << "(" << n << ", " << m << ")";
+            MapClass<int, int>::iterator    hint = s.begin();
+            for (int i = 0; i < m; ++i) {
+                int key = (i * 16 + 1 + rand() % 64) % (n * 16);
+                hint = s.insert(hint, NS::make_pair(key, i));
+            }
+        }
+        DSOUT() << s.size() << std::endl;
+    }
+
+    // n 要素の map から, ソート済みの k 個のキーを探す
+    // k / n (バッチの密度) を変えて比べる。
+    // (STLでは1つずつ find)
+    void    find_sorted(int n, int k) {
+        MapClass<int, int>  s;
+        for (int i = 0; i < n; ++i) {
+            s.insert(NS::make_pair(i * 2, i));
+        }
+        std::vector<int>    keys;
+        for (int i = 0; i < k; ++i) {
+            keys.push_back(rand() % (n * 2));
+        }
+        std::sort(keys.begin(), keys.end());
+        std::vector< MapClass<int, int>::iterator > found;
+        found.reserve(k);
+        {
+            SPRINT("performance::find_sorted") << "(" << n << ", " << k << ")";
+# ifdef USE_STL
+            for (std::vector<int>::iterator it = keys.begin(); it != keys.end(); ++it) {
+                found.push_back(s.find(*it));
+            }
+# else
+            s.find_sorted(keys.begin(), keys.end(), std::back_inserter(found));
+# endif
+        }
+        DSOUT() << found.size() << std::endl;
+    }
+
+    // LLC に載らない大きさの map で, 順不同のキーをグループ検索する
+    // グループの幅ごとのスループットを比べる。
+    // (STLでは1つずつ find)
+    template <std::size_t Width>
+    void    find_batch(const MapClass<int, int>& s, const std::vector<int>& keys) {
+        typedef MapClass<int, int>::const_iterator  const_iterator;
+        std::vector<const_iterator> found;
+        found.reserve(keys.size());
+        {
+            SPRINT("performance::find_batch width") << "(" << Width << ", " << keys.size() << ")";
+# ifdef USE_STL
+            for (std::vector<int>::const_iterator it = keys.begin(); it != keys.end(); ++it) {
+                found.push_back(s.find(*it));
+            }
+# else
+            s.find_batch<Width>(keys.begin(), keys.end(), std::back_inserter(found));
+# endif
+        }
+        DSOUT() << found.size() << std::endl;
+    }
+
+    void    find_batch(int n, int k) {
+        std::vector< PairClass<int, int> >  v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(NS::make_pair(i * 2, i));
+        }
+# ifdef USE_STL
+        MapClass<int, int>  s((v.begin()), v.end());
+# else
+        MapClass<int, int>  s(ft::sorted_unique, v.begin(), v.end());
+# endif
+        std::vector<int>    keys;
+        for (int i = 0; i < k; ++i) {
+            keys.push_back(rand() % (n * 2));
+        }
+        find_batch<1>(s, keys);
+        find_batch<2>(s, keys);
+        find_batch<4>(s, keys);
+        find_batch<8>(s, keys);
+        find_batch<16>(s, keys);
+        find_batch<32>(s, keys);
+    }
+
+    // 挿入と削除を繰り返す(ノードの確保・解放が多い処理)
+    template <class Allocator>
+    void    churn(const char* name, int n, int m) {
+        typedef MapClass<int, int, std::less<int>, Allocator>   map_type;
+        map_type    s;
+        for (int i = 0; i < n; ++i) {
+            s.insert(NS::make_pair(rand() % (n * 2), i));
+        }
+        {
+            SPRINT(name) << "(" << n << ", " << m << ")";
+            for (int i = 0; i < m; ++i) {
+                int key = rand() % (n * 2);
+                if (s.erase(key) == 0) {
+                    s.insert(NS::make_pair(key, i));
+                }
+            }
+            s.clear();
+            for (int i = 0; i < n; ++i) {
+                s.insert(NS::make_pair(i, i));
+            }
+        }
+        DSOUT() << s.size() << std::endl;
+    }
+
+    void    churn(int n, int m) {
+        churn< std::allocator< PairClass<const int, int> > >(
+            "performance::churn std::allocator", n, m
+        );
+        churn< ft::node_pool< PairClass<const int, int> > >(
+            "performance::churn node_pool", n, m
+        );
+    }
+
     // でかい(=compareに時間がかかる)キーを使った処理
     void    heavy_key(int n, int m) {
         typedef MapClass< VectorClass< int >, int > map_type;
@@ -902,6 +1514,46 @@ namespace performance {
     }
 
     void    test() {
+# ifdef FT_FLAT_CONTAINERS
+        // flat_map では途中への挿入・削除が O(n) なので,
+        // ランダムな位置に1つずつ入れる・消すものは規模を抑える。
+        insertion(1000, 1000);
+        insertion(10000, 1000);
+        hint_aided_insertion(1000, 1000);
+        hint_aided_insertion(10000, 1000);
+        hint_aided_insertion(100000, 1000);
+        hint_aided_insertion(1000000, 1000);
+        copy(1000);
+        copy(10000);
+        ranged_insertion(1000);
+        ranged_insertion(10000);
+        sorted_construction(1000);
+        sorted_construction(10000);
+        sorted_construction(100000);
+        sorted_construction(1000000);
+        split_join(1000, 100);
+        split_join(10000, 100);
+        rank_and_nth(1000, 100);
+        rank_and_nth(10000, 100);
+        cursor_lookup(1000000, 1000000);
+        near_hint_insertion(100000, 1000);
+        find_sorted(1000000, 100);
+        find_sorted(1000000, 1000);
+        find_sorted(1000000, 10000);
+        find_sorted(1000000, 100000);
+        find_sorted(1000000, 1000000);
+        find_batch(2000000, 200000);
+        transparent_find(1000, 100000);
+        transparent_find(10000, 100000);
+        churn(1000, 100000);
+        churn(10000, 100000);
+        heavy_key(100, 10);
+        heavy_key(1000, 10);
+        heavy_key(100, 100);
+        heavy_key(1000, 100);
+        heavy_key(100, 1000);
+        heavy_key(1000, 1000);
+# else
         insertion(1000, 1000);
         insertion(10000, 1000);
         insertion(100000, 1000);
@@ -918,6 +1570,29 @@ namespace performance {
         ranged_insertion(10000);
         ranged_insertion(100000);
         ranged_insertion(1000000);
+        sorted_construction(1000);
+        sorted_construction(10000);
+        sorted_construction(100000);
+        sorted_construction(1000000);
+        split_join(1000, 100);
+        split_join(10000, 100);
+        split_join(100000, 100);
+        rank_and_nth(1000, 100);
+        rank_and_nth(10000, 100);
+        rank_and_nth(100000, 100);
+        cursor_lookup(1000000, 1000000);
+        near_hint_insertion(1000000, 100000);
+        find_sorted(1000000, 100);
+        find_sorted(1000000, 1000);
+        find_sorted(1000000, 10000);
+        find_sorted(1000000, 100000);
+        find_sorted(1000000, 1000000);
+        find_batch(2000000, 200000);
+        transparent_find(1000, 100000);
+        transparent_find(100000, 100000);
+        churn(1000, 100000);
+        churn(10000, 100000);
+        churn(100000, 100000);
         heavy_key(100, 10);
         heavy_key(1000, 10);
         heavy_key(10000, 10);
@@ -927,13 +1602,157 @@ namespace performance {
         heavy_key(100, 1000);
         heavy_key(1000, 1000);
         heavy_key(10000, 1000);
+# endif
+    }
+}
+
+namespace memory {
+    // ft::map<int, int> の要素あたりのメモリ使用量を測る。
+    // アロケータ経由で確保されたバイト数のみを数える(mallocのオーバーヘッドは含まない)。
+    // 結果は実装によって異なるので標準エラーに出す。
+    // (FT_COMPACT_TREE_NODE の有無で比べる -> make map_footprint)
+    void    footprint(int n) {
+        typedef MapClass<
+            int, int, std::less<int>, ft::counting_allocator< PairClass<const int, int> >
+        > map_type;
+        std::size_t base = ft::counting_allocator<int>::bytes_in_use();
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(i, i));
+        }
+        std::size_t used = ft::counting_allocator<int>::bytes_in_use() - base;
+        DSOUT() << m.size() << std::endl;
+        DOUT() << "footprint(" << n << "): "
+            << (double)used / n << " bytes/element" << std::endl;
+    }
+
+    // ft::node_pool を使った map
+    // 要素をすべて消すと, 最初のスラブだけ残してスラブが解放されること,
+    // 空と1個を行き来してもスラブを確保し直さないこと,
+    // map がなくなるとすべて解放されることを確かめる。
+    void    node_pool(int n) {
+        SPRINT("node_pool") << "(" << n << ")";
+        typedef MapClass<
+            int, int, std::less<int>, ft::node_pool< PairClass<const int, int> >
+        > map_type;
+        std::size_t base = ft::node_pool<int>::slab_bytes_in_use();
+        {
+            map_type    m;
+            std::size_t first_slab = 0;
+            for (int i = 0; i < n; ++i) {
+                m.insert(NS::make_pair(rand() % (n * 2), i));
+                if (i == 0) {
+                    first_slab = ft::node_pool<int>::slab_bytes_in_use() - base;
+                }
+            }
+            for (int i = 0; i < n; ++i) {
+                m.erase(rand() % (n * 2));
+            }
+            map_type    mm(m);
+            DSOUT() << (m == mm) << std::endl;
+            for (map_type::iterator it = m.begin(); it != m.end(); ++it) {
+                DSOUT() << it->first << ", " << it->second << std::endl;
+            }
+            DSOUT() << (n == 0 || ft::node_pool<int>::slab_bytes_in_use() > base) << std::endl;
+            m.clear();
+            mm.clear();
+            std::size_t kept = ft::node_pool<int>::slab_bytes_in_use() - base;
+            DSOUT() << (kept <= first_slab) << std::endl;
+            for (int i = 0; i < 1000; ++i) {
+                m.insert(NS::make_pair(i, i));
+                m.erase(i);
+            }
+            DSOUT() << (n == 0 || ft::node_pool<int>::slab_bytes_in_use() - base == kept) << std::endl;
+            for (int i = 0; i < n; ++i) {
+                m.insert(NS::make_pair(i, i));
+            }
+            DSOUT() << m.size() << std::endl;
+        }
+        DSOUT() << (ft::node_pool<int>::slab_bytes_in_use() == base) << std::endl;
+    }
+
+    void    test() {
+        footprint(1000);
+        footprint(1000000);
+# if !defined(FT_FLAT_CONTAINERS) && !defined(FT_INDEX_CONTAINERS)
+        // flat_map, index_map は要素を配列にまとめて確保するので, ノード用のプールは使われない。
+        node_pool(0);
+        node_pool(1);
+        node_pool(100);
+        node_pool(10000);
+# endif
+    }
+}
+
+#if defined(FT_CXX11) && !defined(FT_FLAT_CONTAINERS) && !defined(FT_INDEX_CONTAINERS)
+// C++11 モードでのみ: ムーブと emplace
+namespace cxx11 {
+    void    move() {
+        SPRINT("cxx11::move");
+        typedef MapClass<int, std::string> map_type;
+        map_type    m1;
+        for (int i = 0; i < 10; ++i) {
+            m1.insert(NS::make_pair(i, std::string(30, 'a' + i)));
+        }
+        map_type    m2(std::move(m1));
+        DSOUT() << m1.empty() << " " << m2.size() << std::endl;
+        map_type    m3;
+        m3[100] = "x";
+        m3 = std::move(m2);
+        DSOUT() << m2.empty() << " " << m3 << std::endl;
+        std::string k(20, 'k');
+        MapClass<std::string, int>  ms;
+        ms[std::move(k)] = 1;
+        ms[std::string(20, 'k')] += 1;
+        DSOUT() << ms << std::endl;
+    }
+
+    void    emplace() {
+        SPRINT("cxx11::emplace");
+        typedef MapClass<int, std::string> map_type;
+        map_type    m;
+        for (int i = 0; i < 20; ++i) {
+            NS::pair<map_type::iterator, bool> r = m.emplace((i * 7) % 20, std::string(i + 1, 'a' + i));
+            DSOUT() << r.first->first << " " << r.second << std::endl;
+        }
+        // 既にあるキーは挿入されない
+        NS::pair<map_type::iterator, bool> r = m.emplace(3, "dup");
+        DSOUT() << r.first->second << " " << r.second << std::endl;
+        map_type::iterator it = m.emplace_hint(m.end(), 100, "end");
+        DSOUT() << it->first << " " << it->second << std::endl;
+        it = m.emplace_hint(m.begin(), 5, "dup");
+        DSOUT() << it->first << " " << it->second << std::endl;
+        DSOUT() << m << std::endl;
+    }
+
+    void    mass_emplace_hint(int n) {
+        MapClass<int, std::string> m;
+        {
+            SPRINT("cxx11::mass_emplace_hint") << "(" << n << ")";
+            for (int i = 0; i < n; ++i) {
+                m.emplace_hint(m.end(), i, std::string(100, 'a' + i % 26));
+            }
+        }
+        DSOUT() << m.size() << " " << m[n / 2] << std::endl;
+    }
+
+    void    test() {
+        move();
+        emplace();
+        mass_emplace_hint(1000);
+        mass_emplace_hint(100000);
     }
 }
+#endif
 
 int main()
 {
     fill::test();
     logic::test();
+#if defined(FT_CXX11) && !defined(FT_FLAT_CONTAINERS) && !defined(FT_INDEX_CONTAINERS)
+    cxx11::test();
+#endif
+    memory::test();
     performance::test();
     ft::sprint::list();
 }
@@ -240,6 +240,61 @@ namespace is_pseudo_trivially_destructible {
 #undef IS_TRIVIAL
 }
 
+namespace is_trivially_relocatable {
+// std に対応するものはないので, ft のものだけを見る.
+#define TEST(type_a) (DSOUT() << "is is_trivially_relocatable?: " << (ft::is_trivially_relocatable<type_a>::value ? "yes" : "NO") << (": " #type_a) << std::endl)
+    struct pod {
+        int     idx;
+        char    buff[64];
+    };
+    void    is_trivially_relocatable() {
+        TEST(int);
+        TEST(int*);
+        TEST(const int);
+        TEST(char);
+        TEST(double);
+        TEST(pod);
+        TEST(simple_holder<int>);
+        TEST(std::string);
+        TEST(std::string*);
+        typedef ft::pair<int, double> pair_type;
+        TEST(pair_type);
+        typedef ft::pair<int, std::string> pair_str_type;
+        TEST(pair_str_type);
+        TEST(ft::vector<int>);
+        TEST(ft::vector<std::string>);
+        TEST(ft::set<int>);
+    }
+#undef TEST
+}
+
+namespace is_trivially_destructible {
+// std::is_trivially_destructible などは C++11 なので, ft のものだけを見る.
+#define TEST(pred, type_a) (DSOUT() << "is " #pred "?: " << (ft::pred<type_a>::value ? "yes" : "NO") << (": " #type_a) << std::endl)
+    struct pod {
+        int     idx;
+        char    buff[64];
+    };
+    struct with_ctor {
+        int     idx;
+        with_ctor(): idx(0) {}
+    };
+    void    is_trivially_destructible() {
+        TEST(is_trivially_destructible, int);
+        TEST(is_trivially_destructible, int*);
+        TEST(is_trivially_destructible, pod);
+        TEST(is_trivially_destructible, with_ctor);
+        TEST(is_trivially_destructible, std::string);
+        TEST(is_trivially_destructible, ft::vector<int>);
+        TEST(is_trivially_default_constructible, int);
+        TEST(is_trivially_default_constructible, double*);
+        TEST(is_trivially_default_constructible, pod);
+        TEST(is_trivially_default_constructible, with_ctor);
+        TEST(is_trivially_default_constructible, std::string);
+    }
+#undef TEST
+}
+
 namespace iterator_category {
     template <class Iter>
     void subtest() {
@@ -282,6 +337,8 @@ int main() {
     is_pseudo_trivially_constructible::is_pseudo_trivially_constructible();
     is_pseudo_trivially_assignable::is_pseudo_trivially_assignable();
     is_pseudo_trivially_destructible::is_pseudo_trivially_destructible();
+    is_trivially_relocatable::is_trivially_relocatable();
+    is_trivially_destructible::is_trivially_destructible();
     iterator_category::test();
 
     {
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <string>
 #include <list>
+#include <algorithm>
+#include <iterator>
 #include "test_common.hpp"
 
 // 各機能を1つずつ潰していくテスト。
@@ -82,6 +84,30 @@ namespace fill {
         DSOUT() << (m.begin() == m.end()) << std::endl;
     }
 
+    // ソート済み・重複なし範囲からのコンストラクタ
+    // (STLにはないので, 通常の範囲コンストラクタと結果を比べる)
+    void    constructor_sorted_unique(int n) {
+        SPRINT("constructor_sorted_unique") << "(" << n << ")";
+        VectorClass<int>  v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(i * 3);
+        }
+# ifdef USE_STL
+        set_type    m((v.begin()), v.end());
+# else
+        set_type    m(ft::sorted_unique, v.begin(), v.end());
+# endif
+        DSOUT() << m.size() << std::endl;
+        DSOUT() << m << std::endl;
+        // 組み立てた後も普通に挿入・削除できる
+        for (int i = 0; i < n; ++i) {
+            m.insert(i * 3 + 1);
+            m.erase(i * 6);
+        }
+        DSOUT() << m.size() << std::endl;
+        DSOUT() << m << std::endl;
+    }
+
     // コピーコンストラクタ
     void    constructor_copy(int n) {
         SPRINT("constructor_copy") << "(" << n << ")";
@@ -272,6 +298,110 @@ namespace fill {
         DSOUT() << *(m.begin()) << std::endl;
     }
 
+    // 分割・連結
+    // (STLにはないので, 範囲コンストラクタ・erase・insert で同じことをする)
+    void    split_join(int n) {
+        SPRINT("split_join") << "(" << n << ")";
+        set_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(rand() % (n * 4));
+        }
+        int keys[] = { -1, 0, n, n * 2, n * 4 };
+        for (std::size_t i = 0; i < sizeof(keys) / sizeof(*keys); ++i) {
+            set_type    upper;
+# ifdef USE_STL
+            upper = set_type(m.lower_bound(keys[i]), m.end());
+            m.erase(m.lower_bound(keys[i]), m.end());
+# else
+            m.split(keys[i], upper);
+# endif
+            DSOUT() << m.size() << ", " << upper.size() << std::endl;
+            DSOUT() << m << std::endl;
+            DSOUT() << upper << std::endl;
+            if (!upper.empty()) {
+                DSOUT() << *(upper.begin()) << std::endl;
+            }
+# ifdef USE_STL
+            m.insert(upper.begin(), upper.end());
+            upper.clear();
+# else
+            m.join(upper);
+# endif
+            DSOUT() << m.size() << ", " << upper.size() << std::endl;
+            DSOUT() << m << std::endl;
+        }
+        // 右に連結, 左に連結, 範囲が重なる連結
+        for (int k = 0; k < 3; ++k) {
+            set_type    mm;
+            for (int i = 0; i < n; ++i) {
+                if (k == 0) {
+                    mm.insert(n * 4 + i);
+                } else if (k == 1) {
+                    mm.insert(-1 - i);
+                } else {
+                    mm.insert(i);
+                }
+            }
+# ifdef USE_STL
+            m.insert(mm.begin(), mm.end());
+            mm.clear();
+# else
+            m.join(mm);
+# endif
+            DSOUT() << m.size() << ", " << mm.size() << std::endl;
+            DSOUT() << m << std::endl;
+        }
+    }
+
+    // 順序統計
+    // (STLにはないので, std::distance と std::advance で同じことをする)
+    void    order_statistics(int n) {
+        SPRINT("order_statistics") << "(" << n << ")";
+        set_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(rand() % (n * 4));
+        }
+        for (int k = 0; k < 3; ++k) {
+            for (int i = -1; i <= n * 4; i += n / 8 + 1) {
+# ifdef USE_STL
+                long    r = std::distance(m.begin(), m.lower_bound(i));
+# else
+                long    r = m.rank(i);
+# endif
+                DSOUT() << r << std::endl;
+            }
+            for (int i = 0; i <= (int)m.size(); i += n / 8 + 1) {
+                const_iterator  it = m.begin();
+# ifdef USE_STL
+                std::advance(it, i);
+# else
+                it = m.nth(i);
+# endif
+                if (it != m.end()) {
+                    DSOUT() << *it << std::endl;
+                }
+                const_iterator  b = m.begin();
+                const_iterator  e = m.end();
+# ifdef USE_STL
+                long    d1 = std::distance(b, it);
+                long    d2 = std::distance(it, e);
+# else
+                long    d1 = m.distance(b, it);
+                long    d2 = m.distance(it, e);
+# endif
+                DSOUT() << d1 << ", " << d2 << std::endl;
+            }
+            // 挿入・削除の後も数えられる
+            for (int i = 0; i < n; ++i) {
+                if (rand() % 2) {
+                    m.insert(rand() % (n * 4));
+                } else {
+                    m.erase(rand() % (n * 4));
+                }
+            }
+        }
+    }
+
     void    insert_value(int n) {
         SPRINT("insert_value") << "(" << n << ")";
         set_type    m;
@@ -386,6 +516,61 @@ namespace fill {
         // *(m.begin()) = 1;
     }
 
+    // ソート済みのキー列での一括検索
+    // (STLでは1つずつ find)
+    void    find_sorted(int n, int k) {
+        SPRINT("find_sorted") << "(" << n << ", " << k << ")";
+        set_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(rand() % (n * 2));
+        }
+        std::vector<int>    keys;
+        for (int i = 0; i < k; ++i) {
+            keys.push_back(rand() % (n * 2 + 2) - 1);
+        }
+        std::sort(keys.begin(), keys.end());
+        std::vector<const_iterator> found;
+# ifdef USE_STL
+        for (std::vector<int>::iterator it = keys.begin(); it != keys.end(); ++it) {
+            found.push_back(m.find(*it));
+        }
+# else
+        m.find_sorted(keys.begin(), keys.end(), std::back_inserter(found));
+# endif
+        DSOUT() << found.size() << std::endl;
+        for (std::vector<const_iterator>::size_type i = 0; i < found.size(); ++i) {
+            DSOUT() << keys[i] << ": " << (found[i] != m.end()) << std::endl;
+        }
+    }
+
+    // 順不同のキー列でのグループ検索
+    // (STLでは1つずつ find)
+    void    find_batch(int n, int k) {
+        SPRINT("find_batch") << "(" << n << ", " << k << ")";
+        set_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(rand() % (n * 2));
+        }
+        std::vector<int>    keys;
+        for (int i = 0; i < k; ++i) {
+            keys.push_back(rand() % (n * 2 + 2) - 1);
+        }
+        // const な set から探す
+        const set_type&             cm = m;
+        std::vector<const_iterator> found;
+# ifdef USE_STL
+        for (std::vector<int>::iterator it = keys.begin(); it != keys.end(); ++it) {
+            found.push_back(cm.find(*it));
+        }
+# else
+        cm.find_batch<4>(keys.begin(), keys.end(), std::back_inserter(found));
+# endif
+        DSOUT() << found.size() << std::endl;
+        for (std::vector<const_iterator>::size_type i = 0; i < found.size(); ++i) {
+            DSOUT() << keys[i] << ": " << (found[i] != m.end()) << std::endl;
+        }
+    }
+
     void    find_constant(int n) {
         SPRINT("find_constant") << "(" << n << ")";
         set_type    m;
@@ -557,6 +742,9 @@ namespace fill {
         constructor_comparator(1000);
         constructor_comparator_allocator(1000);
         constructor_iterator(1000);
+        constructor_sorted_unique(0);
+        constructor_sorted_unique(1);
+        constructor_sorted_unique(1000);
         constructor_copy(1000);
         oprator_assignation(1000);
         begin_end();
@@ -566,6 +754,8 @@ namespace fill {
         begin_end_variable();
         clear(1000);
         swap(1000);
+        split_join(1000);
+        order_statistics(1000);
         insert_value(1000);
         insert_value_with_hint(1000);
         insert_value_with_range(1000);
@@ -573,6 +763,12 @@ namespace fill {
         erase_by_key(1000);
         erase_by_range(1000);
         find_variable(1000);
+        find_sorted(0, 10);
+        find_sorted(1000, 10);
+        find_sorted(1000, 1000);
+        find_sorted(1000, 10000);
+        find_batch(0, 10);
+        find_batch(1000, 1001);
         find_constant(1000);
         equal_range(1000);
         lower_bound(1000);
@@ -610,6 +806,23 @@ namespace logic {
         DSOUT() << m.size() << std::endl;
     }
 
+    // - is_transparent を持つコンパレータなら, key_type 以外の型で検索・削除できること
+    void    transparent_lookup() {
+        SPRINT("transparent_lookup");
+        typedef SetClass<Key, transparent_string_less>  set_type;
+        const char* words[] = { "apple", "banana", "cherry", "durian", "elderberry" };
+        set_type    s(words, words + 5);
+        const set_type& cs = s;
+        DSOUT() << s.count("banana") << ", " << cs.count("blueberry") << std::endl;
+        DSOUT() << *(s.find("cherry")) << std::endl;
+        DSOUT() << (cs.find("coconut") == cs.end()) << std::endl;
+        DSOUT() << *(s.lower_bound("c")) << ", " << *(cs.upper_bound("cherry")) << std::endl;
+        NS::pair<set_type::const_iterator, set_type::const_iterator>  r = cs.equal_range("durian");
+        DSOUT() << *(r.first) << ", " << *(r.second) << std::endl;
+        DSOUT() << s.erase("apple") << ", " << s.erase("apple") << std::endl;
+        DSOUT() << s << std::endl;
+    }
+
     // - 内部にポインタを持つオブジェクトを持てること
     // - clear後にinsertしても状態が整合すること
     void    destroy_and_create() {
@@ -742,6 +955,7 @@ namespace logic {
 
     void    test() {
         specify_comparator();
+        transparent_lookup();
         destroy_and_create();
         set_on_set();
         vector_on_set();
@@ -841,6 +1055,26 @@ namespace performance {
     }
 
     void    test() {
+# ifdef FT_FLAT_CONTAINERS
+        // flat_set では途中への挿入・削除が O(n) なので,
+        // ランダムな位置に1つずつ入れる・消すものは規模を抑える。
+        insertion(1000, 1000);
+        insertion(10000, 1000);
+        hint_aided_insertion(1000, 1000);
+        hint_aided_insertion(10000, 1000);
+        hint_aided_insertion(100000, 1000);
+        hint_aided_insertion(1000000, 1000);
+        copy(1000);
+        copy(10000);
+        ranged_insertion(1000);
+        ranged_insertion(10000);
+        heavy_key(100, 10);
+        heavy_key(1000, 10);
+        heavy_key(100, 100);
+        heavy_key(1000, 100);
+        heavy_key(100, 1000);
+        heavy_key(1000, 1000);
+# else
         insertion(1000, 1000);
         insertion(10000, 1000);
         insertion(100000, 1000);
@@ -866,13 +1100,46 @@ namespace performance {
         heavy_key(100, 1000);
         heavy_key(1000, 1000);
         heavy_key(10000, 1000);
+# endif
+    }
+}
+
+#if defined(FT_CXX11) && !defined(FT_FLAT_CONTAINERS) && !defined(FT_INDEX_CONTAINERS)
+// C++11 モードでのみ: ムーブと emplace
+namespace cxx11 {
+    void    move_and_emplace() {
+        SPRINT("cxx11::move_and_emplace");
+        typedef SetClass<std::string> set_type;
+        set_type    s1;
+        for (int i = 0; i < 10; ++i) {
+            NS::pair<set_type::iterator, bool> r = s1.emplace(i % 7 + 1, 'a' + i % 7);
+            DSOUT() << *r.first << " " << r.second << std::endl;
+        }
+        std::string str(5, 'q');
+        s1.insert(std::move(str));
+        set_type::iterator it = s1.emplace_hint(s1.end(), 3, 'z');
+        DSOUT() << *it << std::endl;
+        set_type    s2(std::move(s1));
+        DSOUT() << s1.empty() << " " << s2 << std::endl;
+        set_type    s3;
+        s3.emplace("x");
+        s3 = std::move(s2);
+        DSOUT() << s2.empty() << " " << s3 << std::endl;
+    }
+
+    void    test() {
+        move_and_emplace();
     }
 }
+#endif
 
 int main()
 {
     fill::test();
     logic::test();
+#if defined(FT_CXX11) && !defined(FT_FLAT_CONTAINERS) && !defined(FT_INDEX_CONTAINERS)
+    cxx11::test();
+#endif
     performance::test();
     ft::sprint::list();
 }
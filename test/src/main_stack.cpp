@@ -70,6 +70,28 @@ void    mass_assign(unsigned long n) {
     }
 }
 
+// すぐ捨てられる小さな stack (再帰の代わりに使う作業用の stack など)
+template <class T, class Container>
+void    short_lived(unsigned long n, unsigned long k) {
+    srand(n);
+    T           v = random_value_generator<T>();
+    std::size_t popped = 0;
+    {
+        SPRINT("short_lived") << "(" << n << ", " << k << ")";
+        for (unsigned long i = 0; i < n; ++i) {
+            StackClass<T, Container> s;
+            for (unsigned long j = 0; j < k; ++j) {
+                s.push(v);
+            }
+            while (!s.empty()) {
+                s.pop();
+                popped += 1;
+            }
+        }
+    }
+    std::cout << popped << std::endl;
+}
+
 template <class T>
 void    performance(const std::string& t) {
     ft::sprint::insert_comment("default container");
@@ -77,6 +99,7 @@ void    performance(const std::string& t) {
     mass_push_and_pop<T, StackContainer<T> >(300000);
     mass_copy<T, StackContainer<T> >(300000);
     mass_assign<T, StackContainer<T> >(300000);
+    short_lived<T, StackContainer<T> >(100000, 8);
     ft::sprint::pop_bread();
 }
 
@@ -87,6 +110,7 @@ void    performance(const std::string& t, const std::string& container) {
     mass_push_and_pop<T, Container>(300000);
     mass_copy<T, Container>(300000);
     mass_assign<T, Container>(300000);
+    short_lived<T, Container>(100000, 8);
     ft::sprint::pop_bread();
 }
 
@@ -97,6 +121,7 @@ void    run_mass_test(const std::string& main_title) {
     ft::sprint::insert_comment(">> " + main_title);
     performance<T>(main_title);
     performance<TP(T, ft::vector)>(main_title, "ft::vector");
+    performance<T, ft::small_vector<T, 16> >(main_title, "ft::small_vector<16>");
     performance<TP(T, std::vector)>(main_title, "std::vector");
     performance<TP(T, std::deque)>(main_title, "std::deque");
     performance<TP(T, std::list)>(main_title, "std::list");
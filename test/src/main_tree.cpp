@@ -34,7 +34,7 @@ void    insert_and_erase_random(int n) {
             DOUT() << "shortest b-height: " << tree.debug_longest_black_height() << std::endl;
         }
         DOUT() << "erase: " << ns[i] << std::endl;
-        tree.erase(ns[i]);
+        tree.erase_by_key(ns[i]);
     }
     DOUT() << "size: " << tree.size() << std::endl;
     // for (TreeClass<int>::iterator it = tree.begin(); it != tree.end();) {
@@ -68,28 +68,26 @@ void    insertion_with_hint(int n, int key) {
 
     DOUT() << "#1" << std::endl;
     hint = tree.lower_bound(key);
-    DOUT() << *hint << std::endl;
+    DOUT() << *(hint->value()) << std::endl;
     tree.insert(hint, key);
     print_iterative_container_elements(tree);
     DOUT() << tree.size() << std::endl;
 
     DOUT() << "#2" << std::endl;
     hint = tree.begin();
-    DOUT() << *hint << std::endl;
+    DOUT() << *(hint->value()) << std::endl;
     tree.insert(hint, n + 1);
     print_iterative_container_elements(tree);
     DOUT() << tree.size() << std::endl;
 
     DOUT() << "#3" << std::endl;
     hint = tree.end();
-    DOUT() << *hint << std::endl;
     tree.insert(hint, -1000);
     print_iterative_container_elements(tree);
     DOUT() << tree.size() << std::endl;
 
     DOUT() << "#4" << std::endl;
     hint = tree.end();
-    DOUT() << *hint << std::endl;
     tree.insert(hint, -1);
     print_iterative_container_elements(tree);
     DOUT() << tree.size() << std::endl;
@@ -132,6 +130,245 @@ void    traverse_by_iterator(int n) {
     }
 }
 
+// select, rank, distance が先頭から数えた添字と一致することを確かめる
+// (部分木のノード数が正しく保たれていることの確認)
+template <class Tree>
+bool    check_order_statistics(Tree& tree) {
+    typename Tree::size_type    n = tree.size();
+    typename Tree::size_type    step = n / 16 + 1;
+    typename Tree::iterator     it = tree.begin();
+    for (typename Tree::size_type i = 0; i < n; ++i, ++it) {
+        if (i % step != 0) { continue; }
+        if (tree.select(i) != it
+            || tree.rank(*(it->value())) != i
+            || tree.distance(tree.begin(), it) != (typename Tree::difference_type)i
+            || tree.distance(it, tree.end()) != (typename Tree::difference_type)(n - i)) {
+            return false;
+        }
+    }
+    return tree.select(n) == tree.end();
+}
+
+// end の1つ前(キャッシュされた最大ノード)が, begin から辿った最後のノードと一致すること
+template <class Tree>
+bool    check_ends(Tree& tree) {
+    if (tree.empty()) {
+        return tree.begin() == tree.end();
+    }
+    typename Tree::iterator last = tree.begin();
+    typename Tree::iterator it = last;
+    for (++it; it != tree.end(); ++it) {
+        last = it;
+    }
+    typename Tree::iterator prev = tree.end();
+    --prev;
+    return prev == last;
+}
+
+template <class Tree>
+void    check_red_black(const std::string& name, Tree& tree) {
+    typename Tree::size_type lh = tree.debug_longest_height();
+    typename Tree::size_type sh = tree.debug_shortest_height();
+    typename Tree::size_type lb = tree.debug_longest_black_height();
+    typename Tree::size_type sb = tree.debug_shortest_black_height();
+    std::cout << name << ": size: " << tree.size()
+        << ", black-height: " << (sb == lb ? "ok" : "NG")
+        << ", height: " << (lh <= sh * 2 ? "ok" : "NG")
+        << ", red-red: " << (tree.debug_no_red_red() ? "ok" : "NG")
+        << ", order: " << (check_order_statistics(tree) ? "ok" : "NG")
+        << ", ends: " << (check_ends(tree) ? "ok" : "NG")
+        << std::endl;
+}
+
+// ソート済み範囲から一括構築した木が赤黒木になっていることを確かめる
+void    bulk_build(int n) {
+    VectorClass<int> v;
+    for (int i = 0; i < n; ++i) {
+        v.push_back(i * 2);
+    }
+    TreeClass<int>  tree;
+    tree.insert(ft::sorted_unique, v.begin(), v.end());
+    std::cout << "bulk_build(" << n << ")" << std::endl;
+    check_red_black("built", tree);
+    bool    same = tree.size() == v.size();
+    TreeClass<int>::iterator    it = tree.begin();
+    for (int i = 0; same && i < n; ++i, ++it) {
+        same = *(it->value()) == v[i];
+    }
+    std::cout << "elements: " << (same ? "ok" : "NG") << std::endl;
+    // 組み立てた木に対する挿入・削除がリバランスを壊さないこと
+    for (int i = 0; i < n; ++i) {
+        tree.insert(i * 2 + 1);
+    }
+    check_red_black("inserted", tree);
+    for (int i = 0; i < n; i += 2) {
+        tree.erase_by_key(i * 2);
+    }
+    check_red_black("erased", tree);
+}
+
+// 分割・連結した木が赤黒木になっていることを確かめる
+// (model/rbtree.rb の test_split_join と同じことをする)
+void    split_join(int n) {
+    VectorClass<int> ns;
+    for (int i = 1; i <= n; ++i) {
+        ns.push_back(i);
+    }
+    for (int i = 0; i < n; ++i) {
+        ft::swap(ns[i], ns[rand() % n]);
+    }
+    std::cout << "split_join(" << n << ")" << std::endl;
+    for (int k = 0; k <= n + 1; k += (n / 16) + 1) {
+        TreeClass<int>  tree;
+        for (int i = 0; i < n; ++i) {
+            tree.insert(ns[i]);
+        }
+        TreeClass<int>  upper;
+        upper.insert(-1);
+        tree.split(k, upper);
+        check_red_black("lower", tree);
+        check_red_black("upper", upper);
+        bool    ok = true;
+        int     expected = 1;
+        for (TreeClass<int>::iterator it = tree.begin(); it != tree.end(); ++it, ++expected) {
+            ok = ok && *(it->value()) == expected;
+        }
+        for (TreeClass<int>::iterator it = upper.begin(); it != upper.end(); ++it, ++expected) {
+            ok = ok && *(it->value()) == expected;
+        }
+        ok = ok && expected == n + 1;
+        std::cout << "split at " << k << ": " << (ok ? "ok" : "NG") << std::endl;
+        if (k % 2 == 0) {
+            tree.join(upper);
+        } else {
+            upper.join(tree);
+            tree.swap(upper);
+        }
+        check_red_black("joined", tree);
+        std::cout << "other: " << upper.size() << std::endl;
+    }
+}
+
+// 末尾への追加・末尾の削除を繰り返しても, 最大ノードのキャッシュが正しいこと
+void    append_and_pop(int n) {
+    std::cout << "append_and_pop(" << n << ")" << std::endl;
+    TreeClass<int>  tree;
+    for (int i = 0; i < n; ++i) {
+        tree.insert(tree.end(), i);
+    }
+    check_red_black("appended", tree);
+    for (int i = 0; i < n / 2; ++i) {
+        TreeClass<int>::iterator    last = tree.end();
+        --last;
+        tree.erase(last);
+    }
+    check_red_black("popped", tree);
+    for (int i = 0; i < n; ++i) {
+        TreeClass<int>::iterator    last = tree.end();
+        if (i % 3 == 0 && !tree.empty()) {
+            --last;
+            tree.erase(last);
+        } else {
+            tree.insert(last, n + i);
+        }
+    }
+    check_red_black("mixed", tree);
+    TreeClass<int>  other;
+    other.insert(-1);
+    tree.swap(other);
+    check_red_black("swapped", tree);
+    check_red_black("other", other);
+    tree.clear();
+    check_red_black("cleared", tree);
+    tree.insert(tree.end(), 1);
+    check_red_black("reinserted", tree);
+    other = tree;
+    check_red_black("assigned", other);
+}
+
+// ソート済みのキー列での一括検索が, 1つずつ find したのと同じ結果になること
+void    find_sorted(int n, int k) {
+    TreeClass<int>  tree;
+    for (int i = 0; i < n; ++i) {
+        tree.insert(rand() % (n * 2 + 1));
+    }
+    std::vector<int>    keys;
+    for (int i = 0; i < k; ++i) {
+        keys.push_back(rand() % (n * 2 + 3) - 1);
+    }
+    std::sort(keys.begin(), keys.end());
+    std::vector<TreeClass<int>::iterator>   found;
+    tree.find_sorted(keys.begin(), keys.end(), std::back_inserter(found));
+    bool    ok = found.size() == keys.size();
+    for (std::vector<int>::size_type i = 0; ok && i < keys.size(); ++i) {
+        ok = found[i] == tree.find(keys[i]);
+    }
+    // フィンガーサーチ単体: 任意の finger <= lower_bound(key) から同じ結果になること
+    TreeClass<int>::iterator    finger = tree.begin();
+    for (std::vector<int>::size_type i = 0; ok && i < keys.size(); ++i) {
+        TreeClass<int>::iterator    lb = tree.lower_bound(keys[i]);
+        ok = tree.lower_bound(finger, keys[i]) == lb;
+        if (rand() % 2 && lb != tree.end()) {
+            finger = lb;
+        }
+    }
+    std::cout << "find_sorted(" << n << ", " << k << "): " << (ok ? "ok" : "NG") << std::endl;
+}
+
+// 任意のヒントからの検索・挿入が, ヒントなしと同じ結果になること
+void    hinted_lookup(int n) {
+    TreeClass<int>  tree;
+    for (int i = 0; i < n; ++i) {
+        tree.insert(rand() % (n * 2 + 1));
+    }
+    std::vector<TreeClass<int>::iterator>   hints;
+    for (TreeClass<int>::iterator it = tree.begin(); it != tree.end(); ++it) {
+        hints.push_back(it);
+    }
+    hints.push_back(tree.end());
+    bool    ok = true;
+    for (int i = 0; ok && i < n * 4 + 4; ++i) {
+        int                         key = rand() % (n * 2 + 3) - 1;
+        TreeClass<int>::iterator    hint = hints[rand() % hints.size()];
+        ok = tree.lower_bound(hint, key) == tree.lower_bound(key)
+            && tree.find(hint, key) == tree.find(key);
+    }
+    std::cout << "hinted_lookup(" << n << "): " << (ok ? "ok" : "NG") << std::endl;
+    // 隣接しないヒントでの挿入
+    for (int i = 0; i < n; ++i) {
+        TreeClass<int>::iterator    hint = tree.begin();
+        for (int j = rand() % 8; j > 0 && hint != tree.end(); --j) {
+            ++hint;
+        }
+        int                         key = rand() % (n * 4 + 1);
+        TreeClass<int>::iterator    it = tree.insert(hint, key);
+        ok = ok && *(it->value()) == key;
+    }
+    ok = ok && tree.size() == (TreeClass<int>::size_type)tree.distance(tree.begin(), tree.end());
+    std::cout << "hinted_insertion(" << n << "): " << (ok ? "ok" : "NG") << std::endl;
+    check_red_black("hinted", tree);
+}
+
+// 順不同のキー列でのグループ検索が, 1つずつ find したのと同じ結果になること
+template <std::size_t Width>
+void    find_batch(int n, int k) {
+    TreeClass<int>  tree;
+    for (int i = 0; i < n; ++i) {
+        tree.insert(rand() % (n * 2 + 1));
+    }
+    std::vector<int>    keys;
+    for (int i = 0; i < k; ++i) {
+        keys.push_back(rand() % (n * 2 + 3) - 1);
+    }
+    std::vector<TreeClass<int>::iterator>   found;
+    tree.find_batch<Width>(keys.begin(), keys.end(), std::back_inserter(found));
+    bool    ok = found.size() == keys.size();
+    for (std::vector<int>::size_type i = 0; ok && i < keys.size(); ++i) {
+        ok = found[i] == tree.find(keys[i]);
+    }
+    std::cout << "find_batch<" << Width << ">(" << n << ", " << k << "): " << (ok ? "ok" : "NG") << std::endl;
+}
+
 void    compare_iterators()
 {
     // "constでないiterator"と"const_iterator"が比較できることを確かめる.
@@ -151,6 +388,38 @@ int main() {
     insert_and_erase_random(100);
     insertion_with_hint(1000, 27);
     traverse_by_iterator(10);
+    for (int n = 0; n <= 64; ++n) {
+        bulk_build(n);
+    }
+    bulk_build(1000);
+    bulk_build(1000000);
+    split_join(0);
+    split_join(1);
+    split_join(2);
+    split_join(10);
+    split_join(100);
+    split_join(1000);
+    split_join(100000);
+    append_and_pop(0);
+    append_and_pop(1);
+    append_and_pop(10);
+    append_and_pop(1000);
+    find_sorted(0, 10);
+    find_sorted(1, 10);
+    find_sorted(100, 10);
+    find_sorted(100, 1000);
+    find_sorted(100000, 100);
+    find_sorted(100000, 100000);
+    hinted_lookup(0);
+    hinted_lookup(1);
+    hinted_lookup(10);
+    hinted_lookup(1000);
+    find_batch<1>(100, 100);
+    find_batch<3>(0, 10);
+    find_batch<3>(100, 100);
+    find_batch<8>(1, 10);
+    find_batch<8>(1000, 1001);
+    find_batch<32>(100000, 10000);
 
     VectorClass<int> v(10);
     for (VectorClass<int>::size_type i = 0; i < v.size(); ++i) {
@@ -0,0 +1,693 @@
+#include <iostream>
+#include <string>
+#include <list>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+#include <stdexcept>
+#include <sys/time.h>
+#include "test_common.hpp"
+#include "unordered_map.hpp"
+#include "unordered_set.hpp"
+
+// ft::unordered_map, ft::unordered_set のテスト。
+// - C++98 に std::unordered_map はないので, USE_STL なら std::map, std::set と出力を比べる(make ud)。
+//   走査の順番は実装によって違うので, 出力するときはキーでソートする。
+// - FT_UNORDERED_BASELINE なら ft::map, ft::set を使う。
+//   ハッシュテーブルとスプリントの時間を比べるのに使う(make unordered_vs_map)。
+#if defined(USE_STL)
+# define UnorderedMapClass std::map
+# define UnorderedSetClass std::set
+#elif defined(FT_UNORDERED_BASELINE)
+# define UnorderedMapClass ft::map
+# define UnorderedSetClass ft::set
+#else
+# define UnorderedMapClass ft::unordered_map
+# define UnorderedSetClass ft::unordered_set
+#endif
+
+// ホーム位置が8通りしかないハッシュ関数
+// (少ない要素数で, 長いクラスタ・予備スロットの拡張が起きる形を作る)
+struct clustering_hash {
+    std::size_t operator()(int x) const {
+        return static_cast<std::size_t>(x % 8);
+    }
+};
+
+#if defined(USE_STL)
+typedef std::set<int>                                       collide_set_type;
+#elif defined(FT_UNORDERED_BASELINE)
+typedef ft::set<int>                                        collide_set_type;
+#else
+typedef ft::unordered_set<int, clustering_hash>             collide_set_type;
+#endif
+
+// 内部構造が正しいか
+// (ハッシュテーブル以外では常に true)
+template <class Container>
+bool    is_valid(const Container& c) {
+#if defined(USE_STL) || defined(FT_UNORDERED_BASELINE)
+    (void)c;
+    return true;
+#else
+    return c.debug_valid();
+#endif
+}
+
+// キーでソートして出力する。
+template <class Map>
+void    print_map(const Map& m) {
+    typedef std::pair<typename Map::key_type, typename Map::mapped_type>    item_type;
+    std::vector<item_type>  items;
+    for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it) {
+        items.push_back(item_type(it->first, it->second));
+    }
+    std::sort(items.begin(), items.end());
+    std::cout << "{";
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        if (i > 0) {
+            std::cout << ", ";
+        }
+        std::cout << "(" << items[i].first << " => " << items[i].second << ")";
+    }
+    std::cout << "}" << std::endl;
+}
+
+template <class Set>
+void    print_set(const Set& s) {
+    std::vector<typename Set::value_type>   items(s.begin(), s.end());
+    std::sort(items.begin(), items.end());
+    std::cout << "(";
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        if (i > 0) {
+            std::cout << ", ";
+        }
+        std::cout << items[i];
+    }
+    std::cout << ")" << std::endl;
+}
+
+// 各機能を1つずつ潰していくテスト。
+namespace fill {
+    typedef UnorderedMapClass<int, int> map_type;
+    typedef map_type::iterator          iterator;
+    typedef map_type::const_iterator    const_iterator;
+    typedef UnorderedSetClass<int>      set_type;
+
+    void    constructors(int n) {
+        SPRINT("constructors") << "(" << n << ")";
+        map_type    m;
+        DSOUT() << m.empty() << ", " << m.size() << ", " << (m.begin() == m.end()) << std::endl;
+        VectorClass< PairClass<int, int> >  v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(NS::make_pair(rand() % (n * 2), i));
+        }
+        map_type    r((v.begin()), v.end());
+        DSOUT() << r.size() << ", " << is_valid(r) << std::endl;
+        print_map(r);
+#if defined(USE_STL) || defined(FT_UNORDERED_BASELINE)
+        map_type    b;
+#else
+        map_type    b(n * 4);
+#endif
+        b.insert(v.begin(), v.end());
+        DSOUT() << (b == r) << ", " << is_valid(b) << std::endl;
+        map_type    c((r));
+        DSOUT() << (c == r) << ", " << is_valid(c) << std::endl;
+        c = m;
+        DSOUT() << (c == m) << ", " << (c == r) << ", " << is_valid(c) << std::endl;
+        c = r;
+        const map_type& self = c;
+        c = self;
+        DSOUT() << (c == r) << std::endl;
+    }
+
+    void    insert_value(int n) {
+        SPRINT("insert_value") << "(" << n << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            int key = rand() % (n * 2);
+            PairClass<iterator, bool>   result = m.insert(NS::make_pair(key, i));
+            DSOUT() << result.second << ", " << result.first->first << ", " << result.first->second << std::endl;
+        }
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+        // 連番・2のべきの倍数のキー(ハッシュ値の下位ビットが偏る)
+        map_type    seq;
+        map_type    pow;
+        for (int i = 0; i < n; ++i) {
+            seq.insert(NS::make_pair(i, i));
+            pow.insert(NS::make_pair(i * 1024, i));
+        }
+        DSOUT() << seq.size() << ", " << is_valid(seq) << ", " << pow.size() << ", " << is_valid(pow) << std::endl;
+        print_map(pow);
+    }
+
+    // ヒントは使われないが, 挿入された(または既存の)要素を返すこと
+    void    insert_value_with_hint(int n) {
+        SPRINT("insert_value_with_hint") << "(" << n << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            int key = rand() % n;
+            DSOUT() << *(m.insert(m.begin(), NS::make_pair(key, i))) << std::endl;
+            DSOUT() << *(m.insert(m.end(), NS::make_pair(key + n, i))) << std::endl;
+        }
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+    }
+
+    void    insert_value_with_range(int n) {
+        SPRINT("insert_value_with_range") << "(" << n << ")";
+        std::list< NS::pair<int, int> > l;
+        for (int i = 0; i < n; ++i) {
+            l.push_back(NS::make_pair(rand() % (n * 2), i));
+        }
+        map_type    m;
+        m.insert(l.begin(), l.end());
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+        m.insert(l.begin(), l.end());
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+    }
+
+    void    erase_by_key(int n) {
+        SPRINT("erase_by_key") << "(" << n << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(rand() % n, i));
+        }
+        for (int i = 0; i < n; ++i) {
+            int key = rand() % n;
+            DSOUT() << key << " -> " << m.erase(key) << std::endl;
+            if (!is_valid(m)) {
+                DSOUT() << "invalid after erase(" << key << ")" << std::endl;
+            }
+        }
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+        // すべて消す
+        while (!m.empty()) {
+            m.erase(m.begin()->first);
+        }
+        DSOUT() << m.size() << ", " << (m.begin() == m.end()) << ", " << is_valid(m) << std::endl;
+        m[1] = 1;
+        print_map(m);
+    }
+
+    // erase(position) の返り値で走査を続けて, どの要素もちょうど1回ずつ見ること
+    // (C++98 の std::map::erase と ft::map::erase は void なので, 後置インクリメントで進める)
+    void    erase_by_position(int n) {
+        SPRINT("erase_by_position") << "(" << n << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(rand() % (n * 4), i));
+        }
+        std::size_t size = m.size();
+        std::size_t visited = 0;
+        for (iterator it = m.begin(); it != m.end(); ++visited) {
+            if (it->first % 3 == 0) {
+#if defined(USE_STL) || defined(FT_UNORDERED_BASELINE)
+                m.erase(it++);
+#else
+                it = m.erase(it);
+#endif
+            } else {
+                ++it;
+            }
+        }
+        DSOUT() << (visited == size) << ", " << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+        while (!m.empty()) {
+            m.erase(m.begin());
+        }
+        DSOUT() << m.size() << ", " << (m.begin() == m.end()) << ", " << is_valid(m) << std::endl;
+    }
+
+    void    erase_by_range(int n) {
+        SPRINT("erase_by_range") << "(" << n << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(i, i));
+        }
+        // 1要素だけの範囲
+        for (int i = 0; i < n; i += 3) {
+            iterator    first = m.find(i);
+            iterator    last = first;
+            ++last;
+            m.erase(first, last);
+        }
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+        m.erase(m.begin(), m.begin());
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        m.erase(m.begin(), m.end());
+        DSOUT() << m.size() << ", " << (m.begin() == m.end()) << ", " << is_valid(m) << std::endl;
+    }
+
+    void    lookup(int n) {
+        SPRINT("lookup") << "(" << n << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m.insert(NS::make_pair(rand() % (n * 3), i));
+        }
+        const map_type& cm = m;
+        for (int key = -1; key <= n * 3; ++key) {
+            iterator                    f = m.find(key);
+            const_iterator              cf = cm.find(key);
+            NS::pair<iterator, iterator>    r = m.equal_range(key);
+            NS::pair<const_iterator, const_iterator>    cr = cm.equal_range(key);
+            DSOUT() << key << ": "
+                << (f == m.end() ? -1 : f->second) << ", "
+                << (cf == cm.end() ? -1 : cf->second) << ", "
+                << cm.count(key) << ", "
+                << std::distance(r.first, r.second) << ", "
+                << std::distance(cr.first, cr.second) << std::endl;
+        }
+    }
+
+    void    iteration(int n) {
+        SPRINT("iteration") << "(" << n << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m[rand() % (n * 2)] = i;
+        }
+        long    sum = 0;
+        for (iterator it = m.begin(); it != m.end(); ++it) {
+            it->second += 1;
+            sum += it->second;
+        }
+        const_iterator  cit = m.begin();
+        std::size_t     count = 0;
+        while (cit != m.end()) {
+            cit++;
+            ++count;
+        }
+        DSOUT() << sum << ", " << count << ", " << std::distance(m.begin(), m.end()) << std::endl;
+        print_map(m);
+    }
+
+    void    subscript(int n) {
+        SPRINT("subscript") << "(" << n << ")";
+        map_type    m;
+        for (int i = 0; i < n; ++i) {
+            m[rand() % n] += i;
+        }
+        DSOUT() << m.size() << ", " << is_valid(m) << std::endl;
+        print_map(m);
+        // at は範囲外で例外を投げる
+        // (C++98 の std::map には at がないので, 結果だけを合わせる)
+        std::string thrown = "out_of_range";
+#if !defined(USE_STL) && !defined(FT_UNORDERED_BASELINE)
+        const map_type& cm = m;
+        try {
+            cm.at(n);
+            thrown = "no exception";
+        } catch (std::out_of_range&) {
+        }
+#endif
+        DSOUT() << thrown << std::endl;
+    }
+
+    void    swap_clear_compare(int n) {
+        SPRINT("swap_clear_compare") << "(" << n << ")";
+        map_type    a;
+        map_type    b;
+        for (int i = 0; i < n; ++i) {
+            a[i] = i;
+            b[n - i - 1] = i;
+        }
+        DSOUT() << (a == b) << (a != b) << std::endl;
+        for (int i = 0; i < n; ++i) {
+            b[i] = i;
+        }
+        // 同じ要素を別の順番で入れても等しい
+        DSOUT() << (a == b) << (a != b) << std::endl;
+        b[n] = n;
+        a.swap(b);
+        DSOUT() << a.size() << ", " << b.size() << ", " << is_valid(a) << is_valid(b) << std::endl;
+        std::swap(a, b);
+        DSOUT() << a.size() << ", " << b.count(n) << std::endl;
+        a.clear();
+        DSOUT() << a.size() << ", " << (a.begin() == a.end()) << ", " << is_valid(a) << std::endl;
+        a[-1] = -1;
+        a = b;
+        DSOUT() << (a == b) << std::endl;
+        print_map(a);
+    }
+
+    // バケット数・負荷率(std::map にはないので, 満たすべき関係だけを出す)
+    void    buckets(int n) {
+        SPRINT("buckets") << "(" << n << ")";
+        map_type    m;
+        bool        ok = true;
+        for (int i = 0; i < n; ++i) {
+            m[i * 7] = i;
+#if !defined(USE_STL) && !defined(FT_UNORDERED_BASELINE)
+            ok = ok && m.load_factor() <= m.max_load_factor();
+#endif
+        }
+#if !defined(USE_STL) && !defined(FT_UNORDERED_BASELINE)
+        m.reserve(n * 4);
+        std::size_t reserved = m.bucket_count();
+        ok = ok && reserved * m.max_load_factor() >= n * 4 && is_valid(m);
+        for (int i = n; i < n * 4; ++i) {
+            m[i * 7] = i;
+        }
+        ok = ok && m.bucket_count() == reserved && is_valid(m);
+        m.rehash(0);
+        ok = ok && m.load_factor() <= m.max_load_factor() && is_valid(m);
+        m.max_load_factor(0.5f);
+        ok = ok && m.max_load_factor() == 0.5f && m.load_factor() <= 0.5f && is_valid(m);
+        m.max_load_factor(2.0f);
+        ok = ok && m.max_load_factor() < 1.0f && is_valid(m);
+        DOUT() << "buckets(" << n << "): " << m.size() << " / " << m.bucket_count() << std::endl;
+#else
+        for (int i = n; i < n * 4; ++i) {
+            m[i * 7] = i;
+        }
+#endif
+        DSOUT() << ok << ", " << m.size() << std::endl;
+        print_map(m);
+    }
+
+    // テーブルを大きくしている途中(古いテーブルが残っている間)の検索・削除・走査
+    void    incremental_rehash(int n) {
+        SPRINT("incremental_rehash") << "(" << n << ")";
+        map_type    m;
+        int         lost = 0;
+        int         invalid = 0;
+        int         rehashing = 0;
+        for (int i = 0; i < n; ++i) {
+            m[i] = i;
+            // 少し前に入れたキーを消して, また入れる
+            if (i % 5 == 4) {
+                m.erase(i - 3);
+                m[i - 3] = -i;
+            }
+            if (m.find(i / 2) == m.end()) {
+                ++lost;
+            }
+            if (static_cast<int>(std::distance(m.begin(), m.end())) != static_cast<int>(m.size())) {
+                ++lost;
+            }
+#if !defined(USE_STL) && !defined(FT_UNORDERED_BASELINE)
+            if (m.rehashing()) {
+                ++rehashing;
+            }
+#endif
+            if (!is_valid(m)) {
+                ++invalid;
+            }
+        }
+        DOUT() << "incremental_rehash(" << n << "): rehashing after " << rehashing << " inserts" << std::endl;
+        DSOUT() << m.size() << ", " << lost << ", " << invalid << std::endl;
+        print_map(m);
+        map_type    c(m);
+        DSOUT() << (c == m) << ", " << is_valid(c) << std::endl;
+    }
+
+    void    set_basic(int n) {
+        SPRINT("set_basic") << "(" << n << ")";
+        set_type    s;
+        for (int i = 0; i < n; ++i) {
+            s.insert(rand() % (n * 2));
+        }
+        DSOUT() << s.size() << ", " << is_valid(s) << std::endl;
+        print_set(s);
+        for (int i = 0; i < n; ++i) {
+            int key = rand() % (n * 2);
+            set_type::const_iterator    f = s.find(key);
+            DSOUT() << s.count(key) << ", " << (f == s.end() ? -1 : *f) << std::endl;
+            s.erase(key);
+        }
+        DSOUT() << s.size() << ", " << is_valid(s) << std::endl;
+        print_set(s);
+        set_type    t(s);
+        DSOUT() << (s == t) << ", " << is_valid(t) << std::endl;
+        t.insert(-1);
+        DSOUT() << (s == t) << (s != t) << std::endl;
+    }
+
+    // 挿入と削除をランダムに繰り返し, 構造が壊れないことを確かめる。
+    // (ホーム位置が偏るハッシュ関数で, 長いクラスタを作る)
+    // (構造の検査は O(n) なので, check 回に1回)
+    void    random_operations(int n, int m, int check) {
+        SPRINT("random_operations") << "(" << n << ", " << m << ")";
+        collide_set_type    s;
+        int                 invalid = 0;
+        for (int i = 0; i < m; ++i) {
+            int key = rand() % n;
+            if (rand() % 3) {
+                s.insert(key);
+            } else {
+                s.erase(key);
+            }
+            if (i % check == 0 && !is_valid(s)) {
+                ++invalid;
+            }
+        }
+        DSOUT() << s.size() << ", " << invalid << std::endl;
+        print_set(s);
+        while (!s.empty()) {
+            s.erase(s.begin());
+            if (s.size() % check == 0 && !is_valid(s)) {
+                ++invalid;
+            }
+        }
+        DSOUT() << s.size() << ", " << invalid << std::endl;
+    }
+
+    void    test() {
+        constructors(0);
+        constructors(1);
+        constructors(100);
+        insert_value(0);
+        insert_value(1);
+        insert_value(100);
+        insert_value(1000);
+        insert_value_with_hint(1);
+        insert_value_with_hint(100);
+        insert_value_with_range(0);
+        insert_value_with_range(1000);
+        erase_by_key(1);
+        erase_by_key(100);
+        erase_by_key(1000);
+        erase_by_position(1);
+        erase_by_position(100);
+        erase_by_position(1000);
+        erase_by_range(10);
+        erase_by_range(1000);
+        lookup(0);
+        lookup(1);
+        lookup(100);
+        iteration(1);
+        iteration(100);
+        subscript(100);
+        swap_clear_compare(0);
+        swap_clear_compare(100);
+        buckets(10);
+        buckets(1000);
+        incremental_rehash(100);
+        incremental_rehash(3000);
+        set_basic(0);
+        set_basic(100);
+        set_basic(1000);
+        random_operations(10, 1000, 1);
+        random_operations(100, 10000, 1);
+        random_operations(1000, 100000, 100);
+    }
+}
+
+namespace logic {
+    // - 文字列のような, 内部にポインタを持つ値がスロット間を移動しても壊れないこと
+    void    string_values(int n) {
+        SPRINT("string_values") << "(" << n << ")";
+        UnorderedMapClass<std::string, std::string>   m;
+        for (int i = 0; i < n; ++i) {
+            std::string k = random_value_generator<std::string>();
+            m[k] = k + k;
+        }
+        for (int i = 0; i < n / 2; ++i) {
+            m.erase(random_value_generator<std::string>());
+        }
+        int broken = 0;
+        for (UnorderedMapClass<std::string, std::string>::iterator it = m.begin(); it != m.end(); ++it) {
+            if (it->second != it->first + it->first) {
+                ++broken;
+            }
+        }
+        DSOUT() << m.size() << ", " << broken << ", " << is_valid(m) << std::endl;
+        print_map(m);
+    }
+
+    // - 同じホーム位置に多くのキーが集まっても(予備スロットを増やして)入ること
+    void    clustering(int n) {
+        SPRINT("clustering") << "(" << n << ")";
+        collide_set_type    s;
+        for (int i = 0; i < n; ++i) {
+            s.insert(i * 8);
+        }
+        int missing = 0;
+        for (int i = 0; i < n; ++i) {
+            missing += s.count(i * 8) == 0;
+            missing += s.count(i * 8 + 1) != 0;
+        }
+        DSOUT() << s.size() << ", " << missing << ", " << is_valid(s) << std::endl;
+        print_set(s);
+    }
+
+    // - node_pool を使えること(テーブルは1回の確保なので, 大きなテーブルはプールを通らない)
+    void    node_pool(int n) {
+        SPRINT("node_pool") << "(" << n << ")";
+        typedef UnorderedMapClass<int, int,
+#if !defined(USE_STL) && !defined(FT_UNORDERED_BASELINE)
+            ft::hash<int>, std::equal_to<int>,
+#else
+            std::less<int>,
+#endif
+            ft::node_pool< PairClass<const int, int> >
+        > map_type;
+        {
+            map_type    m;
+            for (int i = 0; i < n; ++i) {
+                m.insert(NS::make_pair(rand() % (n * 2), i));
+            }
+            for (int i = 0; i < n; ++i) {
+                m.erase(rand() % (n * 2));
+            }
+            map_type    mm(m);
+            DSOUT() << (m == mm) << ", " << is_valid(mm) << std::endl;
+            print_map(m);
+        }
+    }
+
+    void    test() {
+        string_values(10);
+        string_values(1000);
+        clustering(30);
+        clustering(200);
+        node_pool(0);
+        node_pool(100);
+        node_pool(10000);
+    }
+}
+
+namespace memory {
+    // map<int, int> の要素あたりのメモリ使用量(アロケータ経由のバイト数のみ)
+    // 実装によって異なるので標準エラーに出す。
+    void    footprint(int n) {
+        typedef UnorderedMapClass<int, int,
+#if !defined(USE_STL) && !defined(FT_UNORDERED_BASELINE)
+            ft::hash<int>, std::equal_to<int>,
+#else
+            std::less<int>,
+#endif
+            ft::counting_allocator< PairClass<const int, int> >
+        > map_type;
+        std::size_t base = ft::counting_allocator<int>::bytes_in_use();
+        std::size_t used;
+        std::size_t peak = 0;
+        {
+            map_type    m;
+            for (int i = 0; i < n; ++i) {
+                m.insert(NS::make_pair(rand(), i));
+                std::size_t now = ft::counting_allocator<int>::bytes_in_use() - base;
+                peak = now > peak ? now : peak;
+            }
+            used = ft::counting_allocator<int>::bytes_in_use() - base;
+            DSOUT() << m.size() << std::endl;
+            DOUT() << "footprint(" << n << "): "
+                << (double)used / m.size() << " bytes/element, peak "
+                << (double)peak / m.size() << " bytes/element" << std::endl;
+        }
+        DSOUT() << (ft::counting_allocator<int>::bytes_in_use() == base) << std::endl;
+    }
+
+    void    test() {
+        footprint(1000);
+        footprint(1000000);
+    }
+}
+
+// ハッシュテーブルと ft::map (make unordered_vs_map) / std::map (make ud) を比べるスプリント
+// 要素数 n のmapに対して, 挿入・検索・走査・削除の時間を測る。
+namespace performance {
+    typedef UnorderedMapClass<int, int> map_type;
+
+    unsigned long   now_usec() {
+        struct timeval  tv;
+        if (gettimeofday(&tv, NULL)) { return 0; }
+        return tv.tv_sec * 1000000UL + tv.tv_usec;
+    }
+
+    void    suite(int n) {
+        std::vector<int>    keys;
+        std::vector<int>    probes;
+        for (int i = 0; i < n; ++i) {
+            keys.push_back(rand());
+        }
+        // 半分は存在するキー, 半分はランダムなキー
+        for (int i = 0; i < n; ++i) {
+            probes.push_back(i % 2 ? keys[rand() % n] : rand());
+        }
+        map_type        m;
+        // 1回の挿入にかかった最大の時間
+        // (テーブルを一度に作り直す実装では, 作り直しのたびに山ができる)
+        unsigned long   worst = 0;
+        {
+            SPRINT("performance::insert") << "(" << n << ")";
+            for (int i = 0; i < n; ++i) {
+                unsigned long   begin = now_usec();
+                m.insert(NS::make_pair(keys[i], i));
+                unsigned long   elapsed = now_usec() - begin;
+                worst = elapsed > worst ? elapsed : worst;
+            }
+        }
+        DOUT() << "performance::insert(" << n << "): worst " << worst << " usec" << std::endl;
+        long    hits = 0;
+        {
+            SPRINT("performance::lookup") << "(" << n << ")";
+            for (int i = 0; i < n; ++i) {
+                if (m.find(probes[i]) != m.end()) {
+                    ++hits;
+                }
+            }
+        }
+        long    sum = 0;
+        {
+            SPRINT("performance::scan") << "(" << n << ")";
+            for (map_type::const_iterator it = m.begin(); it != m.end(); ++it) {
+                sum += it->second;
+            }
+        }
+        std::random_shuffle(keys.begin(), keys.end());
+        {
+            SPRINT("performance::erase") << "(" << n << ")";
+            for (int i = 0; i < n; ++i) {
+                m.erase(keys[i]);
+            }
+        }
+        DSOUT() << hits << ", " << sum << ", " << m.size() << std::endl;
+    }
+
+    // 10^3 から 10^max_exp 要素まで
+    void    test(int max_exp) {
+        int n = 1000;
+        for (int e = 3; e <= max_exp; ++e, n *= 10) {
+            suite(n);
+        }
+    }
+}
+
+// 引数はスプリントの最大要素数の指数(既定は6 -> 10^6 要素)
+int main(int argc, char** argv)
+{
+    int max_exp = argc > 1 ? std::atoi(argv[1]) : 6;
+    fill::test();
+    logic::test();
+    memory::test();
+    performance::test(max_exp);
+    ft::sprint::list();
+}
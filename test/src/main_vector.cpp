@@ -1,4 +1,14 @@
 #include "test_common.hpp"
+#include "counting_allocator.hpp"
+#include <sstream>
+#include <iterator>
+#include <cstring>
+#include <cstdio>
+#include <csignal>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
 
 template<class T>
 void    print_stats(VectorClass<T> &v, bool with_stats = true) {
@@ -555,6 +565,52 @@ void    mass_compare(VC(T)::size_type n) {
     print_stats(vs, false);
 }
 
+// 成長方針ごとの push_back の速さと, 容量の無駄
+// 無駄の量は方針・実装によって異なるので, 標準エラーとスプリントのコメントに出す。
+// (FT_VECTOR_GROWTH_STATS つきで ft の再確保の統計も出す -> make vector_growth)
+template <class Vector>
+void    growth_policy(const std::string& name, int n) {
+    Vector          v;
+    std::size_t     reallocations = 0;
+#if defined(FT_VECTOR_GROWTH_STATS) && !defined(USE_STL)
+    typedef ft::vector_growth_stats<typename Vector::growth_policy_type>    stats;
+    stats::reset();
+#endif
+    {
+        SPRINT("growth_policy::push_back<" + name + ">") << "(" << n << ")";
+        for (int i = 0; i < n; ++i) {
+            std::size_t cap = v.capacity();
+            v.push_back(i);
+            if (cap != v.capacity()) {
+                reallocations += 1;
+            }
+        }
+    }
+    DSOUT() << v.size() << " " << v.back() << std::endl;
+    std::size_t         waste = (v.capacity() - v.size()) * sizeof(int);
+    std::ostringstream  ss;
+    ss << "growth_policy<" << name << ">(" << n << "): "
+        << reallocations << " reallocations, waste " << waste << " bytes ("
+        << 100.0 * waste / (v.capacity() * sizeof(int)) << "%)";
+#if defined(FT_VECTOR_GROWTH_STATS) && !defined(USE_STL)
+    ss << ", total slack " << stats::slack_bytes() << " / " << stats::reserved_bytes() << " bytes";
+#endif
+    DOUT() << ss.str() << std::endl;
+    ft::sprint::insert_comment(ss.str());
+}
+
+void    growth_policies(int n) {
+#ifdef USE_STL
+    growth_policy< std::vector<int> >("double", n);
+    growth_policy< std::vector<int> >("one_and_half", n);
+    growth_policy< std::vector<int> >("size_class", n);
+#else
+    growth_policy< ft::vector<int, std::allocator<int>, ft::vector_growth_double> >("double", n);
+    growth_policy< ft::vector<int, std::allocator<int>, ft::vector_growth_one_and_half> >("one_and_half", n);
+    growth_policy< ft::vector<int, std::allocator<int>, ft::vector_growth_size_class> >("size_class", n);
+#endif
+}
+
 template <class T>
 void    performance(const std::string& sub_title, std::size_t n) {
     ft::sprint::push_bread("vector<" + sub_title + ">");
@@ -915,6 +971,243 @@ namespace logic {
         print_stats(v);
     }
 
+    // memcpy で移せる大きな要素
+    // ft::vector は realloc / mremap で領域ごと伸ばす(大きくなると mmap 領域になる)。
+    struct page {
+        int     idx;
+        char    buff[4092];
+    };
+
+    // page と同じ大きさだが, コピーコンストラクタを持つので memcpy では移せない要素
+    // ft::vector はアロケータから確保し直して要素を1つずつ移す
+    // (mmap_allocator なら allocate / deallocate を通る)。
+    struct copied_page {
+        int     idx;
+        char    buff[4092];
+
+        copied_page(): idx(0) {
+            std::memset(buff, 0, sizeof(buff));
+        }
+        copied_page(const copied_page& other): idx(other.idx) {
+            std::memcpy(buff, other.buff, sizeof(buff));
+        }
+        copied_page&    operator=(const copied_page& rhs) {
+            idx = rhs.idx;
+            std::memcpy(buff, rhs.buff, sizeof(buff));
+            return *this;
+        }
+    };
+
+    void    relocatable_growth(int n) {
+        VectorClass<page>   v;
+        {
+            SPRINT("logic::relocatable_growth") << "(" << n << ")";
+            for (int i = 0; i < n; ++i) {
+                page    p = page();
+                p.idx = i;
+                p.buff[i % sizeof(p.buff)] = static_cast<char>(i);
+                v.push_back(p);
+            }
+        }
+        // 既存の要素を渡しても, 伸ばした後に正しい値が入る
+        v.push_back(v[0]);
+        v.resize(v.size() + 3, v[1]);
+        v.reserve(v.capacity() + 1);
+        long    sum = 0;
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            sum += v[i].idx + v[i].buff[i % n % sizeof(v[i].buff)];
+        }
+        DSOUT() << v.size() << " " << v.back().idx << " " << sum << std::endl;
+
+        VectorClass< VectorClass<int> > vv;
+        for (int i = 0; i < n; ++i) {
+            vv.push_back(VectorClass<int>(i % 10, i));
+        }
+        vv.push_back(vv[n / 2]);
+        sum = 0;
+        for (std::size_t i = 0; i < vv.size(); ++i) {
+            for (std::size_t j = 0; j < vv[i].size(); ++j) {
+                sum += vv[i][j];
+            }
+        }
+        DSOUT() << vv.size() << " " << sum << std::endl;
+    }
+
+    // 容量が足りていれば, 代入・assign は領域を確保し直さない
+    void    reuse_storage(int n) {
+        typedef VectorClass< std::string, ft::counting_allocator<std::string> > vector_type;
+        vector_type src;
+        for (int i = 0; i < n; ++i) {
+            src.push_back(std::string(20, 'a' + i % 26));
+        }
+        vector_type dst(src);
+        std::size_t base = ft::counting_allocator<int>::allocations();
+        {
+            SPRINT("logic::reuse_storage") << "(" << n << ")";
+            for (int k = 0; k < 10; ++k) {
+                vector_type::iterator half = src.begin() + (n / 2);
+                dst.assign(src.begin(), half);
+                dst = src;
+                dst.assign(n / 3, src[k]);
+                dst.assign(n, dst[0]);
+                dst = src;
+            }
+        }
+        std::istringstream  is("x y z");
+        dst.assign(std::istream_iterator<std::string>(is), std::istream_iterator<std::string>());
+        DSOUT() << (ft::counting_allocator<int>::allocations() - base) << std::endl;
+        DSOUT() << dst.size() << " " << dst.front() << " " << dst.back() << std::endl;
+        dst = src;
+        DSOUT() << (dst == src) << " " << dst.size() << " " << dst[n / 2] << std::endl;
+    }
+
+    // 算術型の比較(memcmp などを使う場合)が, 要素ごとの比較と同じ結果になるか
+    template <class T>
+    void    compare_kernel(const std::string& name, T base, T changed) {
+        const int   n = 1000;
+        const int   positions[] = { 0, 1, 15, 16, 63, 64, 65, 255, 256, 257, 999 };
+        VectorClass<T>  v1(n, base);
+        std::ostringstream  ss;
+        for (std::size_t k = 0; k < sizeof(positions) / sizeof(positions[0]); ++k) {
+            VectorClass<T>  v2(v1);
+            v2[positions[k]] = changed;
+            ss << (v1 == v2) << (v1 < v2) << (v2 < v1) << (v1 <= v2) << " ";
+        }
+        VectorClass<T>  shorter(v1.begin(), v1.end() - 1);
+        ss << (v1 == shorter) << (v1 < shorter) << (shorter < v1) << " ";
+        VectorClass<T>  empty;
+        ss << (empty == shorter) << (empty < shorter) << (shorter < empty) << (empty < empty);
+        DSOUT() << name << ": " << ss.str() << std::endl;
+    }
+
+    void    compare_kernels() {
+        SPRINT("logic::compare_kernels");
+        compare_kernel<int>("int", 5, -5);
+        compare_kernel<int>("int", 0x01000000, 0x00000001);
+        compare_kernel<long>("long", -1, 1);
+        compare_kernel<char>("char", 'a', -100);
+        compare_kernel<unsigned char>("unsigned char", 'a', 200);
+        compare_kernel<bool>("bool", true, false);
+        compare_kernel<double>("double", 0.0, -0.0);
+        compare_kernel<double>("double", 1.5, 0.5);
+        compare_kernel<double>("double", 1.5, std::numeric_limits<double>::quiet_NaN());
+    }
+
+    // 算術型を同じ値で埋める(insert / resize / assign で数を指定する場合)
+    template <class T>
+    void    fill_arithmetic(const std::string& name, int n, T value) {
+        VectorClass<T>  v;
+        {
+            SPRINT("logic::fill_arithmetic<" + name + ">") << "(" << n << ")";
+            for (int k = 0; k < 10; ++k) {
+                v.assign(n, value);
+                v.insert(v.begin() + n / 2, n, T(value + 1));
+                v.resize(n * 3, T(value + 2));
+                v.insert(v.end(), n, value);
+                v.assign(n / 2, T(value + 3));
+            }
+        }
+        v.resize(n * 2, value);
+        long    sum = 0;
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            sum += static_cast<long>(v[i]);
+        }
+        DSOUT() << v.size() << " " << sum << std::endl;
+    }
+
+    // 算術型の vector 同士の比較
+    template <class T>
+    void    compare_arithmetic(const std::string& name, int n) {
+        VectorClass<T>  v1(n, T(3));
+        VectorClass<T>  v2(v1);
+        v2.back() = T(4);
+        int     count = 0;
+        {
+            SPRINT("logic::compare_arithmetic<" + name + ">") << "(" << n << ")";
+            for (int k = 0; k < 100; ++k) {
+                count += (v1 == v2) + (v1 < v2) + (v2 < v1) + (v1 != v1);
+            }
+        }
+        DSOUT() << count << std::endl;
+    }
+
+    // 読み込み用のバッファを大きくしてから, 全体に書き込む(read() の代わりに memset)。
+    // resize だと, 書き込む前に一度 0 で埋めることになる。
+    // STL には resize_uninitialized がないので resize で代用する。
+    void    read_into_buffer(const std::string& name, bool uninitialized, std::size_t n) {
+        VectorClass<char>   v;
+        {
+            SPRINT("logic::read_into_buffer<" + name + ">") << "(" << n << ")";
+            for (std::size_t chunk = n / 4; v.size() < n; ) {
+                std::size_t old_size = v.size();
+#ifdef USE_STL
+                (void)uninitialized;
+                v.resize(old_size + chunk);
+#else
+                if (uninitialized) {
+                    v.resize_uninitialized(old_size + chunk);
+                } else {
+                    v.resize(old_size + chunk);
+                }
+#endif
+                std::memset(&v[old_size], 'a' + old_size / chunk, chunk);
+            }
+        }
+        DSOUT() << v.size() << " " << v.front() << " " << v[n / 2] << " " << v.back() << std::endl;
+        ft::sprint::insert_rss("logic::read_into_buffer<" + name + ">");
+    }
+
+    // 大きなバッファを push_back で伸ばし, swap で捨てる(main.cpp の Buffer と同じ使い方)。
+    // 確保の仕方によって, 伸ばす時間と, 捨てた後に OS に返るメモリが変わる。
+    // RSS は実装によって変わるので, 標準エラーとコメントに出す。
+    template <class Vector>
+    void    large_buffer(const std::string& name, int n) {
+        Vector  v;
+        {
+            SPRINT("logic::large_buffer<" + name + ">") << "(" << n << ")";
+            for (int i = 0; i < n; ++i) {
+                typename Vector::value_type p = typename Vector::value_type();
+                p.idx = i;
+                v.push_back(p);
+            }
+        }
+        long    sum = 0;
+        for (int i = 0; i < n; i += 97) {
+            sum += v[i].idx;
+        }
+        DSOUT() << v.size() << " " << sum << std::endl;
+        DOUT() << name << " rss: " << ft::sprint::resident_string() << std::endl;
+        ft::sprint::insert_rss("logic::large_buffer<" + name + "> grown");
+        {
+            SPRINT("logic::large_buffer<" + name + ">::swap") << "(" << n << ")";
+            Vector().swap(v);
+        }
+        DSOUT() << v.size() << std::endl;
+        DOUT() << name << " rss after swap: " << ft::sprint::resident_string() << std::endl;
+        ft::sprint::insert_rss("logic::large_buffer<" + name + "> released");
+    }
+
+    void    large_buffers(int n) {
+#ifdef USE_STL
+        large_buffer< std::vector<page> >("std::allocator", n);
+        large_buffer< std::vector<page> >("mmap_allocator", n);
+        large_buffer< std::vector<page> >("mmap_allocator<thp>", n);
+        large_buffer< std::vector<copied_page> >("copied_page, std::allocator", n);
+        large_buffer< std::vector<copied_page> >("copied_page, mmap_allocator", n);
+        large_buffer< std::vector<copied_page> >("copied_page, mmap_allocator<thp>", n);
+#else
+        large_buffer< ft::vector<page> >("std::allocator", n);
+        large_buffer< ft::vector<page, ft::mmap_allocator<page> > >("mmap_allocator", n);
+        large_buffer< ft::vector<page, ft::mmap_allocator<page, ft::mmap_transparent_hugepage> > >("mmap_allocator<thp>", n);
+        // 要素が trivially relocatable でなければ, アロケータの allocate / deallocate で伸ばす
+        large_buffer< ft::vector<copied_page> >("copied_page, std::allocator", n);
+        large_buffer< ft::vector<copied_page, ft::mmap_allocator<copied_page> > >("copied_page, mmap_allocator", n);
+        large_buffer< ft::vector<copied_page, ft::mmap_allocator<copied_page, ft::mmap_transparent_hugepage> > >(
+            "copied_page, mmap_allocator<thp>", n
+        );
+#endif
+    }
+
     void    iterator_for_empty_container() {
         VectorClass<int> v1;
         VectorClass<int> v2;
@@ -934,6 +1227,19 @@ namespace logic {
 
     void    test() {
         iterator_op();
+        compare_kernels();
+        fill_arithmetic<int>("int", 1000000, 7);
+        fill_arithmetic<char>("char", 1000000, 'a');
+        fill_arithmetic<double>("double", 1000000, 0.5);
+        compare_arithmetic<int>("int", 1000000);
+        compare_arithmetic<char>("char", 1000000);
+        compare_arithmetic<double>("double", 1000000);
+        read_into_buffer("resize", false, 1 << 26);
+        read_into_buffer("resize_uninitialized", true, 1 << 26);
+        read_into_buffer("resize", false, 1 << 28);
+        read_into_buffer("resize_uninitialized", true, 1 << 28);
+        large_buffers(100);
+        large_buffers(100000);
         equal_same_size(100);
         equal_same_size(1000);
         equal_same_size(10000);
@@ -944,6 +1250,523 @@ namespace logic {
         equal_diff_size(100000);
         iterator_for_empty_container();
         strong_insertion();
+        relocatable_growth(100);
+        relocatable_growth(10000);
+        reuse_storage(100);
+        reuse_storage(10000);
+    }
+}
+
+#ifdef FT_CXX11
+// C++11 モードでのみ: ムーブと emplace
+namespace cxx11 {
+    void    move() {
+        SPRINT("cxx11::move");
+        VectorClass<std::string> v1;
+        for (int i = 0; i < 10; ++i) {
+            v1.push_back(std::string(30, 'a' + i));
+        }
+        VectorClass<std::string> v2(std::move(v1));
+        DSOUT() << v1.empty() << " " << v2.size() << " " << v2.back() << std::endl;
+        VectorClass<std::string> v3(3, "x");
+        v3 = std::move(v2);
+        DSOUT() << v2.empty() << " " << v3.size() << " " << v3.front() << std::endl;
+        std::string s(40, 'z');
+        v3.push_back(std::move(s));
+        DSOUT() << v3.size() << " " << v3.back() << std::endl;
+    }
+
+    void    emplace() {
+        SPRINT("cxx11::emplace");
+        VectorClass<std::string> v;
+        for (int i = 0; i < 20; ++i) {
+            v.emplace_back(i + 1, 'a' + i);
+        }
+        // 既存の要素を指す引数でも正しく動く
+        v.emplace_back(v[0]);
+        v.emplace(v.begin() + 3, 5, '#');
+        v.emplace(v.begin(), v.back());
+        v.emplace(v.end(), "end");
+        DSOUT() << v.size() << std::endl;
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            DSOUT() << v[i] << std::endl;
+        }
+    }
+
+    // 再確保時に要素がムーブされるか(コピーだと遅い)
+    void    mass_emplace_back(int n) {
+        VectorClass<std::string> v;
+        {
+            SPRINT("cxx11::mass_emplace_back") << "(" << n << ")";
+            for (int i = 0; i < n; ++i) {
+                v.emplace_back(100, 'a' + i % 26);
+            }
+        }
+        DSOUT() << v.size() << " " << v[n / 2] << std::endl;
+    }
+
+    void    test() {
+        move();
+        emplace();
+        mass_emplace_back(1000);
+        mass_emplace_back(100000);
+    }
+}
+#endif
+
+// [small_vector]
+// STL には small_vector がないので, std::vector で同じことをする。
+namespace small {
+    template <class T, std::size_t N>
+    struct small_vector_of {
+#ifdef USE_STL
+        typedef std::vector<T>          type;
+#else
+        typedef ft::small_vector<T, N>  type;
+#endif
+    };
+
+    template <class Vector>
+    void    print(const std::string& title, const Vector& v) {
+        DSOUT() << title << ": " << v.size() << " [";
+        for (typename Vector::const_iterator it = v.begin(); it != v.end(); ++it) {
+            std::cout << (it == v.begin() ? "" : ", ") << *it;
+        }
+        std::cout << "]" << std::endl;
+    }
+
+    // 内部の領域とヒープの境目をまたぐ操作
+    void    spill() {
+        SPRINT("small::spill");
+        typedef small_vector_of<std::string, 4>::type   vector_type;
+        vector_type v;
+        for (int i = 0; i < 10; ++i) {
+            v.push_back(std::string(i + 1, 'a' + i));
+            DSOUT() << v.size() << " " << v.back() << " " << v.front() << std::endl;
+        }
+        v.insert(v.begin() + 2, 3, v[1]);
+        v.erase(v.begin(), v.begin() + 8);
+        print("erased", v);
+        vector_type w(v.begin() + 1, v.end());
+        print("range", w);
+        v.resize(2);
+        v.push_back(v[0]);
+        print("resized", v);
+        v.assign(7, "x");
+        print("assigned", v);
+        v.clear();
+        v.push_back("after clear");
+        print("cleared", v);
+    }
+
+    // 内部の領域・ヒープのどちらを使っているかの組み合わせごとの swap, コピー, 比較
+    void    swap_and_copy() {
+        SPRINT("small::swap_and_copy");
+        typedef small_vector_of<std::string, 4>::type   vector_type;
+        vector_type a(2, "a");
+        vector_type b(3, "b");
+        vector_type c(6, "c");
+        vector_type d(8, "d");
+        a.swap(b);  // 内部 <-> 内部
+        print("a", a);
+        print("b", b);
+        a.swap(c);  // 内部 <-> ヒープ
+        print("a", a);
+        print("c", c);
+        c.swap(d);  // ヒープ <-> 内部
+        print("c", c);
+        print("d", d);
+        a.swap(d);  // ヒープ <-> ヒープ
+        print("a", a);
+        print("d", d);
+        std::swap(a, b);
+        print("a", a);
+        print("b", b);
+        vector_type e(b);
+        vector_type f(a);
+        DSOUT() << (e == b) << " " << (f == a) << " " << (e < f) << " " << (f < e) << std::endl;
+        e = a;
+        f = b;
+        print("e", e);
+        print("f", f);
+        DSOUT() << (e == a) << " " << (f == b) << " " << (e != f) << std::endl;
+#ifdef FT_CXX11
+        vector_type g(std::move(e));    // ヒープ -> 引き取る
+        vector_type h(std::move(f));    // 内部 -> 1つずつ移す
+        print("g", g);
+        print("h", h);
+        DSOUT() << e.empty() << " " << f.empty() << std::endl;
+        g = std::move(h);
+        print("g", g);
+#endif
+    }
+
+    // ヒープを使わずに済む, すぐ捨てられる小さな vector
+    template <class Vector>
+    void    short_lived(const std::string& name, int n, int k) {
+        long    sum = 0;
+        {
+            SPRINT("small::short_lived<" + name + ">") << "(" << n << ", " << k << ")";
+            for (int i = 0; i < n; ++i) {
+                Vector  v;
+                for (int j = 0; j < k; ++j) {
+                    v.push_back(i + j);
+                }
+                sum += v.back() - v.front();
+            }
+        }
+        DSOUT() << sum << std::endl;
+    }
+
+    void    test() {
+        spill();
+        swap_and_copy();
+        short_lived< VectorClass<int> >("vector", 1000000, 6);
+        short_lived< small_vector_of<int, 8>::type >("small_vector", 1000000, 6);
+        short_lived< VectorClass<int> >("vector", 1000000, 16);
+        short_lived< small_vector_of<int, 8>::type >("small_vector", 1000000, 16);
+    }
+}
+
+// [mapped_vector]
+// STL には mapped_vector がないので, どちらでも ft::mapped_vector を使う。
+// 比べる相手は, 同じファイルを VectorClass に読み込むこと。
+namespace mapped {
+    struct record {
+        int key;
+        int value;
+    };
+
+    typedef ft::mapped_vector<record>   vector_type;
+
+    std::string temp_path(const std::string& tag) {
+        std::ostringstream  ss;
+        ss << "/tmp/ft_mapped_vector_" << ::getpid() << "_" << tag << ".bin";
+        return ss.str();
+    }
+
+    record  make_record(int i) {
+        record  r;
+        r.key = i;
+        r.value = i * 7 + 1;
+        return r;
+    }
+
+    // 先頭から size() 個が, すべて push_back した順に並んでいるか
+    bool    is_consistent(const vector_type& v) {
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            if (v[i].key != static_cast<int>(i) || v[i].value != static_cast<int>(i) * 7 + 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void    print(const std::string& title, const vector_type& v) {
+        long    sum = 0;
+        for (vector_type::const_iterator it = v.begin(); it != v.end(); ++it) {
+            sum += it->value;
+        }
+        DSOUT() << title << ": " << v.size() << " " << sum << " " << is_consistent(v) << std::endl;
+    }
+
+    void    basic() {
+        SPRINT("mapped::basic");
+        const std::string   path = temp_path("basic");
+        ::unlink(path.c_str());
+        {
+            vector_type v(path);
+            print("created", v);
+            for (int i = 0; i < 10000; ++i) {
+                v.push_back(make_record(i));
+            }
+            print("pushed", v);
+            DSOUT() << (v.capacity() >= v.size()) << " " << v.front().key << " " << v.back().key << " " << v.rbegin()->key << std::endl;
+            v.push_back(v[0]);  // 伸ばすときに自分の要素を渡す
+            DSOUT() << v.back().key << std::endl;
+            v.pop_back();
+            v.resize(5000);
+            print("resized", v);
+            try {
+                v.at(5000);
+            } catch (const std::out_of_range&) {
+                DSOUT() << "out_of_range" << std::endl;
+            }
+            // 容量の中で伸ばすときは, ファイルを伸ばさない
+            std::size_t cap = v.capacity();
+            v.resize(cap);
+            DSOUT() << (v.size() == cap) << " " << (v.capacity() == cap) << std::endl;
+            v.resize(5000);
+            v.sync();
+        }
+        {
+            vector_type v(path);
+            print("reopened", v);
+            v.clear();
+            v.push_back(make_record(0));
+            v.close();
+            DSOUT() << v.is_open() << " " << v.size() << std::endl;
+            v.open(path);
+            print("reopened again", v);
+        }
+        try {
+            // 要素の大きさが違うファイルは開けない
+            ft::mapped_vector<int> w(path);
+        } catch (const std::runtime_error&) {
+            DSOUT() << "rejected" << std::endl;
+        }
+        ::unlink(path.c_str());
+    }
+
+    // 子プロセスで push_back し続け, 途中で SIGKILL で落とす(close も sync もしない)。
+    // どこで落ちても, 開き直すと要素数までの要素はすべて書き終わっている。
+    // 落ちたときの要素数は実行ごとに変わるので, 標準エラーに出す。
+    void    killed_while_appending(int max_n, unsigned int delay_us) {
+        const std::string   path = temp_path("killed");
+        ::unlink(path.c_str());
+        std::cout.flush();
+        std::cerr.flush();
+        pid_t   pid = ::fork();
+        if (pid == 0) {
+            vector_type v(path);
+            for (int i = 0; i < max_n; ++i) {
+                v.push_back(make_record(i));
+            }
+            ::kill(::getpid(), SIGKILL);
+            ::_exit(0);
+        }
+        ::usleep(delay_us);
+        ::kill(pid, SIGKILL);
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        DSOUT() << (WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL) << std::endl;
+        vector_type v(path);
+        DOUT() << "killed at " << v.size() << " / " << v.capacity() << std::endl;
+        DSOUT() << (v.size() <= static_cast<std::size_t>(max_n)) << " " << is_consistent(v) << std::endl;
+        // 続きから書ける
+        std::size_t n = v.size();
+        v.push_back(make_record(static_cast<int>(n)));
+        DSOUT() << (v.size() == n + 1) << " " << is_consistent(v) << std::endl;
+        ::unlink(path.c_str());
+    }
+
+    // ファイルの大きさとヘッダの要素数が食い違っている場合
+    void    inconsistent_file() {
+        SPRINT("mapped::inconsistent_file");
+        const std::string   path = temp_path("file");
+        ::unlink(path.c_str());
+        std::size_t header = 0;
+        {
+            vector_type v(path);
+            for (int i = 0; i < 1000; ++i) {
+                v.push_back(make_record(i));
+            }
+            header = v.header_bytes();
+        }
+        // ファイルを伸ばしたところで落ちた(要素数は書いていない): 容量だけが増える
+        ::truncate(path.c_str(), header + 5000 * sizeof(record));
+        {
+            vector_type v(path);
+            DSOUT() << "capacity: " << v.capacity() << std::endl;
+            print("extended", v);
+        }
+        // ファイルが切り詰められた: 要素数を容量に合わせる
+        ::truncate(path.c_str(), header + 10 * sizeof(record));
+        {
+            vector_type v(path);
+            DSOUT() << "capacity: " << v.capacity() << std::endl;
+            print("truncated", v);
+        }
+        // ヘッダが壊れている
+        ::truncate(path.c_str(), 100);
+        try {
+            vector_type v(path);
+        } catch (const std::runtime_error&) {
+            DSOUT() << "broken header rejected" << std::endl;
+        }
+        ::truncate(path.c_str(), 0);
+        {
+            std::FILE*  f = std::fopen(path.c_str(), "w");
+            std::fputs("not a mapped_vector", f);
+            for (int i = 0; i < 5000; ++i) {
+                std::fputc(' ', f);
+            }
+            std::fclose(f);
+        }
+        try {
+            vector_type v(path);
+        } catch (const std::runtime_error&) {
+            DSOUT() << "foreign file rejected" << std::endl;
+        }
+        // 1ページで先頭8バイトが0のほかのファイルは, 作りかけとみなして上書きしない
+        const long  page = ::sysconf(_SC_PAGESIZE);
+        {
+            std::FILE*  f = std::fopen(path.c_str(), "wb");
+            for (long i = 0; i < page; ++i) {
+                std::fputc(i < 8 ? '\0' : 'x', f);
+            }
+            std::fclose(f);
+        }
+        try {
+            vector_type v(path);
+        } catch (const std::runtime_error&) {
+            DSOUT() << "zero-prefixed file rejected" << std::endl;
+        }
+        {
+            std::FILE*  f = std::fopen(path.c_str(), "rb");
+            std::fseek(f, 8, SEEK_SET);
+            DSOUT() << "kept: " << static_cast<char>(std::fgetc(f)) << std::endl;
+            std::fclose(f);
+        }
+        // 目印を書く前に落ちた(ヘッダの大きさと要素の大きさだけ書いた)ファイルは作り直す
+        {
+            struct {
+                char        magic[8];
+                uint64_t    header_bytes;
+                uint64_t    element_size;
+                uint64_t    size;
+            }   h;
+            std::memset(&h, 0, sizeof(h));
+            h.header_bytes = page;
+            h.element_size = sizeof(record);
+            std::FILE*  f = std::fopen(path.c_str(), "wb");
+            std::fwrite(&h, sizeof(h), 1, f);
+            for (std::size_t i = sizeof(h); i < static_cast<std::size_t>(page); ++i) {
+                std::fputc('\0', f);
+            }
+            std::fclose(f);
+        }
+        {
+            vector_type v(path);
+            v.push_back(make_record(0));
+            print("recreated", v);
+        }
+        ::unlink(path.c_str());
+    }
+
+    // ページの小さい環境で作ったファイル(ヘッダが今のページより小さく, 要素がページ境界から始まらない)。
+    // 開けて, 書き足せて, sync() できること。
+    // ファイルは mapped_vector のヘッダと同じ並びで, 手で作る。
+    void    foreign_page_size() {
+        SPRINT("mapped::foreign_page_size");
+        const std::string   path = temp_path("page");
+        const unsigned long header = 1024;
+        {
+            struct {
+                char        magic[8];
+                uint64_t    header_bytes;
+                uint64_t    element_size;
+                uint64_t    size;
+            }   h;
+            std::memset(&h, 0, sizeof(h));
+            std::memcpy(h.magic, "ftmvec2", sizeof(h.magic));
+            h.header_bytes = header;
+            h.element_size = sizeof(record);
+            h.size = 100;
+            std::FILE*  f = std::fopen(path.c_str(), "wb");
+            std::fwrite(&h, sizeof(h), 1, f);
+            for (std::size_t i = sizeof(h); i < header; ++i) {
+                std::fputc('\0', f);
+            }
+            for (int i = 0; i < 100; ++i) {
+                record  r = make_record(i);
+                std::fwrite(&r, sizeof(r), 1, f);
+            }
+            std::fclose(f);
+        }
+        {
+            vector_type v(path);
+            DSOUT() << v.header_bytes() << " " << v.capacity() << std::endl;
+            print("opened", v);
+            for (int i = 100; i < 3000; ++i) {
+                v.push_back(make_record(i));
+            }
+            try {
+                v.sync();
+                DSOUT() << "synced" << std::endl;
+            } catch (const std::runtime_error&) {
+                DSOUT() << "sync failed" << std::endl;
+            }
+        }
+        {
+            vector_type v(path);
+            print("reopened", v);
+        }
+        ::unlink(path.c_str());
+    }
+
+    // 起動時にファイルから配列を用意する時間。
+    // - read_into_vector: ファイルを VectorClass に読み込む(大きさに比例する)
+    // - mapped_vector:    ファイルを開いて対応づけるだけ(大きさによらない)
+    // mapped_vector はページを触れたときに読むので, 続けて全体をなめる時間も測る。
+    void    startup(int n) {
+        const std::string   path = temp_path("startup");
+        ::unlink(path.c_str());
+        std::size_t header = 0;
+        {
+            vector_type v(path);
+            v.reserve(n);
+            for (int i = 0; i < n; ++i) {
+                v.push_back(make_record(i));
+            }
+            header = v.header_bytes();
+        }
+        {
+            VectorClass<record> v;
+            {
+                SPRINT("mapped::startup<read_into_vector>") << "(" << n << ")";
+                int fd = ::open(path.c_str(), O_RDONLY);
+                ::lseek(fd, header, SEEK_SET);
+                v.resize(n);
+                char*       p = reinterpret_cast<char*>(&v[0]);
+                std::size_t rest = n * sizeof(record);
+                while (rest > 0) {
+                    ssize_t r = ::read(fd, p, rest);
+                    if (r <= 0) { break; }
+                    p += r;
+                    rest -= r;
+                }
+                ::close(fd);
+            }
+            long    sum = 0;
+            {
+                SPRINT("mapped::startup<read_into_vector>::scan") << "(" << n << ")";
+                for (int i = 0; i < n; ++i) {
+                    sum += v[i].value;
+                }
+            }
+            DSOUT() << v.size() << " " << sum << std::endl;
+        }
+        {
+            vector_type* pv;
+            {
+                SPRINT("mapped::startup<mapped_vector>") << "(" << n << ")";
+                pv = new vector_type(path);
+            }
+            long    sum = 0;
+            {
+                SPRINT("mapped::startup<mapped_vector>::scan") << "(" << n << ")";
+                for (int i = 0; i < n; ++i) {
+                    sum += (*pv)[i].value;
+                }
+            }
+            DSOUT() << pv->size() << " " << sum << std::endl;
+            delete pv;
+        }
+        ::unlink(path.c_str());
+    }
+
+    void    test() {
+        basic();
+        {
+            SPRINT("mapped::killed_while_appending");
+            killed_while_appending(1 << 22, 100000);
+            killed_while_appending(1 << 22, 1000);
+        }
+        inconsistent_file();
+        foreign_page_size();
+        startup(1 << 16);
+        startup(1 << 24);
     }
 }
 
@@ -953,6 +1776,11 @@ int main() {
 
     fill::test();
     logic::test();
+#ifdef FT_CXX11
+    cxx11::test();
+#endif
+    small::test();
+    mapped::test();
     ft::sprint::push_bread("performance");
     int n = 60;
     performance<char>("char", n);
@@ -966,6 +1794,10 @@ int main() {
     performance<ft::vector<int> >("ft::vector<int>", n / 5);
     ft::sprint::pop_bread();
 
+    growth_policies(1000);
+    growth_policies(1000000);
+    growth_policies(10000000);
+
     // 別枠で
     mass_insertion_range_inputiter<int>(50);
     mass_insertion_range_inputiter<int>(500);
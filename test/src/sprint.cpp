@@ -1,4 +1,9 @@
 #include "sprint.hpp"
+#include <fstream>
+#include <unistd.h>
+#if defined(__APPLE__)
+# include <mach/mach.h>
+#endif
 
 ft::vector<std::string>                 ft::sprint::chronicle;
 ft::vector<ft::sprint::duration_type>   ft::sprint::durations;
@@ -44,6 +49,44 @@ void    ft::sprint::insert_comment(const std::string& comment) {
     durations.push_back(-1);
 }
 
+void    ft::sprint::insert_rss(const std::string& label) {
+    insert_comment(label + " rss: " + resident_string());
+}
+
+// macOS では task_info から, ほかでは /proc/self/statm の2つ目(ページ数)から求める。
+// 読めなければ 0
+std::size_t ft::sprint::resident_bytes() {
+#if defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(
+        mach_task_self(), MACH_TASK_BASIC_INFO,
+        reinterpret_cast<task_info_t>(&info), &count
+    ) != KERN_SUCCESS) {
+        return 0;
+    }
+    return static_cast<std::size_t>(info.resident_size);
+#else
+    std::ifstream   statm("/proc/self/statm");
+    std::size_t     total_pages = 0;
+    std::size_t     resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) {
+        return 0;
+    }
+    return resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+std::string ft::sprint::resident_string() {
+    std::size_t bytes = resident_bytes();
+    if (bytes == 0) {
+        return "n/a";
+    }
+    std::ostringstream  ss;
+    ss << bytes / (1024 * 1024) << " MiB";
+    return ss.str();
+}
+
 void    ft::sprint::push_bread(const std::string& bread) {
     breads_.push_back(bread);
 }
@@ -57,8 +100,9 @@ void    ft::sprint::pop_bread() {
 void    ft::sprint::list() {
     std::size_t n = chronicle.size();
     std::size_t w = 0;
+    // 幅はコメントを除いて決める(コメントは実装によって長さが変わりうるので)
     for (std::size_t i = 0; i < n; ++i) {
-        if (chronicle[i].length() > w) {
+        if (durations[i] >= 0 && chronicle[i].length() > w) {
             w = chronicle[i].length();
         }
     }